@@ -28,6 +28,53 @@ namespace libbase {
 
 using std::cerr;
 
+// Look-up tables
+
+template <int m, int poly>
+int gf<m, poly>::log_lut[1 << m];
+template <int m, int poly>
+int gf<m, poly>::pow_lut[2 << m];
+template <int m, int poly>
+const bool gf<m, poly>::lutready = gf<m, poly>::buildlut();
+
+/*!
+ * \brief Set up the logarithm and antilogarithm tables
+ *
+ * The tables are based on the first primitive element found, ie. the first
+ * element whose powers cover all the non-zero elements. This is the element
+ * represented by the polynomial 'x' when the modular polynomial is primitive
+ * (which is not the case for the Rijndael field).
+ */
+template <int m, int poly>
+bool gf<m, poly>::buildlut()
+   {
+   const int n = elements() - 1;
+   // find a primitive element, filling in its powers as we go along
+   int32u alpha = (n > 1) ? 2 : 1;
+   while (true)
+      {
+      assertalways(int(alpha) <= n);
+      int32u x = 1;
+      int order = 0;
+      do
+         {
+         pow_lut[order++] = x;
+         x = multiply(x, alpha);
+         } while (x != 1 && order < n);
+      if (x == 1 && order == n)
+         break;
+      alpha++;
+      }
+   // repeat the powers, so that the sum of two logarithms needs no reduction
+   for (int i = n; i < (2 << m); i++)
+      pow_lut[i] = pow_lut[i % n];
+   // fill in the logarithms; zero has none, and is handled separately
+   log_lut[0] = 0;
+   for (int i = 0; i < n; i++)
+      log_lut[pow_lut[i]] = i;
+   return true;
+   }
+
 // Internal functions
 
 /*!
@@ -50,6 +50,17 @@ namespace libbase {
  * \warning Due to the internal representation, this class is limited to
  * \f$ GF(2^31) \f$.
  *
+ * On the host, multiplication, division and inversion use logarithm and
+ * antilogarithm tables, which are set up during static initialization for
+ * each instantiated field. In device code, where the tables are not
+ * available, these operations are computed directly.
+ *
+ * \note Since the order of static initialization across translation units is
+ * unspecified, these operations must not be used from the static initializer
+ * of an object in another translation unit (the tables may still be empty at
+ * that point). Element values are always validated on construction, as an
+ * out-of-range value would otherwise index beyond the tables.
+ *
  * \note This class has CUDA device support.
  */
 
@@ -82,6 +93,16 @@ private:
    int value;
    // @}
 
+   /*! \name Look-up tables */
+   //! Logarithm of each non-zero element, to the base of a primitive element
+   static int log_lut[1 << m];
+   //! Powers of the primitive element, repeated so that the sum of two
+   //! logarithms can be used directly as an index
+   static int pow_lut[2 << m];
+   static const bool lutready;
+   static bool buildlut();
+   // @}
+
    /*! \name Internal functions */
    /*!
     * \brief Initialization
@@ -95,10 +116,47 @@ private:
    void init(int value)
       {
       assert(m < 32);
+#ifdef __CUDA_ARCH__
       assert(value >= 0 && value < (1 << m));
+#else
+      assertalways(value >= 0 && value < (1 << m));
+#endif
       gf::value = value;
       }
    void init(const char *s);
+   /*!
+    * \brief Multiplication of polynomial representations
+    *
+    * Multiplication within extensions of a field is the multiplication of the polynomials
+    * representing the two values. This can be done by the usual long-multiplication
+    * algorithm. Every time the result overflows, we need to subtract the modular polynomial;
+    * for extensions of a binary field, this is achieved by an XOR operation.
+    *
+    * [cf. Gladman, "A Specification for Rijndael, the AES Algorithm", 2003, pp.3-4]
+    */
+#ifdef __CUDACC__
+   __device__ __host__
+#endif
+   static int32u multiply(int32u A, int32u B)
+      {
+      // Initialize result
+      int32u result = 0;
+      // Loop over all bits in multiplicand
+      for (int i = 0; i < m && B != 0; i++)
+         {
+         // If the corresponding bit in the multiplicand is set,
+         // add (XOR) the shifted multiplier
+         if (B & 1)
+            result ^= A;
+         // Shift the multiplicand
+         B >>= 1;
+         // Shift the multiplier, subtracting the polynomial on overflow
+         A <<= 1;
+         if (A & (1 << m))
+            A ^= poly;
+         }
+      return result;
+      }
    // @}
 
 public:
@@ -166,37 +224,23 @@ public:
     * \brief Multiplication
     * \param   x  Field element we want to multiply to this one (ie. multiplicand).
     *
-    * Multiplication within extensions of a field is the multiplication of the polynomials
-    * representing the two values. This can be done by the usual long-multiplication
-    * algorithm. Every time the result overflows, we need to subtract the modular polynomial;
-    * for extensions of a binary field, this is achieved by an XOR operation.
-    *
-    * [cf. Gladman, "A Specification for Rijndael, the AES Algorithm", 2003, pp.3-4]
+    * On the host, the product of two non-zero elements is obtained by adding
+    * their logarithms and taking the antilogarithm. In device code, the
+    * polynomials are multiplied directly.
     */
 #ifdef __CUDACC__
    __device__ __host__
 #endif
    gf& operator*=(const gf& x)
       {
-      // Copy the multiplier (A) and multiplicand (B)
-      int32u A = value;
-      int32u B = x.value;
-      // Initialize result
-      value = 0;
-      // Loop over all bits in multiplicand
-      for (int i = 0; i < m && B != 0; i++)
-         {
-         // If the corresponding bit in the multiplicand is set,
-         // add (XOR) the shifted multiplier
-         if (B & 1)
-            value ^= A;
-         // Shift the multiplicand
-         B >>= 1;
-         // Shift the multiplier, subtracting the polynomial on overflow
-         A <<= 1;
-         if (A & (1 << m))
-            A ^= poly;
-         }
+#ifdef __CUDA_ARCH__
+      value = multiply(value, x.value);
+#else
+      if (value != 0 && x.value != 0)
+         value = pow_lut[log_lut[value] + log_lut[x.value]];
+      else
+         value = 0;
+#endif
       return *this;
       }
    /*!
@@ -208,14 +252,22 @@ public:
     * - obtaining the logarithms of the two values, performing a subtraction, and
     * then computing the inverse logarithm
     *
-    * In this implementation, we use the multiplicatve inverse method.
+    * On the host we use the logarithm method; in device code we use the
+    * multiplicative inverse method.
     */
 #ifdef __CUDACC__
    __device__ __host__
 #endif
    gf& operator/=(const gf& x)
       {
+#ifdef __CUDA_ARCH__
       return *this *= x.inverse();
+#else
+      assert(x.value != 0);
+      if (value != 0)
+         value = pow_lut[log_lut[value] - log_lut[x.value] + elements() - 1];
+      return *this;
+#endif
       }
    /*!
     * \brief Multiplicative inverse
@@ -223,13 +275,15 @@ public:
     * The multiplicative inverse \f$ b^{-1} \f$ of \f$ b \f$ is such that:
     * \f[ b^{-1} a = 1 \f]
     *
-    * In this implementation, we use the brute force search method.
+    * On the host, this is the antilogarithm of the negated logarithm. In
+    * device code, we use the brute force search method.
     */
 #ifdef __CUDACC__
    __device__ __host__
 #endif
    gf inverse() const
       {
+#ifdef __CUDA_ARCH__
       const gf<m, poly> one = 1;
       gf<m, poly> result = 1;
       for (int i = 1; i < elements(); i++)
@@ -240,6 +294,10 @@ public:
          }
       assert(result * *this == one);
       return result;
+#else
+      assert(value != 0);
+      return gf<m, poly>(pow_lut[elements() - 1 - log_lut[value]]);
+#endif
       }
    // @}
 
@@ -0,0 +1,106 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GFUTILS_H_
+#define GFUTILS_H_
+
+#include "vector.h"
+
+/*!
+ * \file
+ * \brief   Bulk Arithmetic for Vectors of Finite Field Elements.
+ *
+ * When many elements are multiplied by the same scalar, the products of the
+ * scalar with every field element are tabulated first, so that each element
+ * then needs a single table look-up. The table is only set up when the
+ * vector is at least as long as the field size; otherwise each product is
+ * computed directly.
+ */
+
+namespace libbase {
+
+/*! \brief Multiply a vector by a scalar, in place: x = a x
+ * \param x vector to scale
+ * \param a scalar multiplier
+ */
+template <class GF_q>
+void gf_scale(vector<GF_q>& x, const GF_q a)
+   {
+   const int n = x.size();
+   const int q = GF_q::elements();
+   if (n < q)
+      {
+      for (int i = 0; i < n; i++)
+         x(i) *= a;
+      return;
+      }
+   vector<GF_q> product(q);
+   for (int k = 0; k < q; k++)
+      product(k) = a * GF_q(k);
+   for (int i = 0; i < n; i++)
+      x(i) = product(int(x(i)));
+   }
+
+/*! \brief Add a scaled vector to another, in place: y = y + a x
+ * \param y vector to update
+ * \param a scalar multiplier
+ * \param x vector to scale and add
+ */
+template <class GF_q>
+void gf_axpy(vector<GF_q>& y, const GF_q a, const vector<GF_q>& x)
+   {
+   const int n = x.size();
+   const int q = GF_q::elements();
+   assert(y.size() == n);
+   // nothing to add for a zero scalar
+   if (a == GF_q(0))
+      return;
+   if (n < q)
+      {
+      for (int i = 0; i < n; i++)
+         y(i) += a * x(i);
+      return;
+      }
+   vector<GF_q> product(q);
+   for (int k = 0; k < q; k++)
+      product(k) = a * GF_q(k);
+   for (int i = 0; i < n; i++)
+      y(i) += product(int(x(i)));
+   }
+
+/*! \brief Inner product of two vectors
+ * \param x first vector
+ * \param y second vector
+ */
+template <class GF_q>
+GF_q gf_dot(const vector<GF_q>& x, const vector<GF_q>& y)
+   {
+   const int n = x.size();
+   assert(y.size() == n);
+   GF_q result = 0;
+   for (int i = 0; i < n; i++)
+      result += x(i) * y(i);
+   return result;
+   }
+
+} // end namespace
+
+#endif /* GFUTILS_H_ */
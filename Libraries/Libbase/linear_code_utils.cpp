@@ -20,6 +20,7 @@
  */
 
 #include "linear_code_utils.h"
+#include "gfutils.h"
 #include <iostream>
 #include <algorithm>
 #include "logrealfast.h"
@@ -266,15 +267,18 @@ void linear_code_utils<GF_q, real>::encode_cw(const matrix<GF_q> & mat_G,
 
    assertalways(dim_k == source.size().length());
 
+   //add up the rows of the generator matrix, each scaled by its source
+   //symbol, so that the matrix is read in storage order
+   array1gfq_t codeword(length_n);
+   codeword = GF_q(0);
+   for (int j = 0; j < dim_k; j++)
+      {
+      gf_axpy(codeword, GF_q(source(j)), mat_G.row(j));
+      }
    encoded.init(length_n);
    for (int i = 0; i < length_n; i++)
       {
-      GF_q val = GF_q(0);
-      for (int j = 0; j < dim_k; j++)
-         {
-         val += GF_q(source(j)) * mat_G(j, i);
-         }
-      encoded(i) = val;
+      encoded(i) = codeword(i);
       }
 #if DEBUG>=2
    libbase::trace << std::endl << "finished encoding";
@@ -298,11 +302,7 @@ bool linear_code_utils<GF_q, real>::compute_syndrome(
 
    for (int rows = 0; rows < dim_m; rows++)
       {
-      tmp_val = GF_q(0);
-      for (int cols = 0; cols < length_n; cols++)
-         {
-         tmp_val += parMat(rows, cols) * received_word_hd(cols);
-         }
+      tmp_val = gf_dot(parMat.row(rows), received_word_hd);
       if (tmp_val != GF_q(0))
          {
          //the syndrome is non-zero
@@ -0,0 +1,150 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "logrealsimd.h"
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace libbase {
+
+const int logrealsimd::lutsize;
+const double logrealsimd::lutrange = 16.0;
+const double logrealsimd::lutinvstep = (lutsize - 1) / lutrange;
+double logrealsimd::lut_value[lutsize];
+double logrealsimd::lut_slope[lutsize];
+const bool logrealsimd::lutready = logrealsimd::buildlut();
+
+// LUT constructor
+
+/*!
+ * \brief Set up the table for the addition correction term
+ *
+ * Each entry holds the correction term at the start of its interval, and
+ * the change over the interval, for linear interpolation. The last entry
+ * (at the end of the range) is set to zero, which is the value used for all
+ * differences beyond the range.
+ */
+bool logrealsimd::buildlut()
+   {
+   for (int i = 0; i < lutsize - 1; i++)
+      lut_value[i] = log1p(exp(-lutrange * i / (lutsize - 1)));
+   lut_value[lutsize - 1] = 0;
+   for (int i = 0; i < lutsize - 1; i++)
+      lut_slope[i] = lut_value[i + 1] - lut_value[i];
+   lut_slope[lutsize - 1] = 0;
+   return true;
+   }
+
+// conversion
+
+double logrealsimd::convertfromdouble(const double m)
+   {
+   // trap infinity
+   const int inf = isinf(m);
+   if (inf < 0)
+      {
+      failwith("Negative infinity cannot be represented");
+      }
+   else if (inf > 0)
+      {
+      return -std::numeric_limits<double>::infinity();
+      }
+   // trap NaN
+   else if (isnan(m))
+      {
+      failwith("NaN cannot be represented");
+      }
+   // trap negative numbers
+   else if (m < 0)
+      {
+      failwith("Negative numbers cannot be represented");
+      }
+   // trap zero
+   else if (m == 0)
+      {
+      return std::numeric_limits<double>::infinity();
+      }
+   // finally convert (value must be ok)
+   return -log(m);
+   }
+
+// Input/Output Operations
+
+std::ostream& operator<<(std::ostream& sout, const logrealsimd& x)
+   {
+   // trap infinity
+   const int inf = isinf(x.logval);
+   if (inf < 0)
+      {
+      sout << "+Inf";
+      }
+   else if (inf > 0)
+      {
+      sout << "0";
+      }
+   // finite values
+   else
+      {
+      const double lv10 = -x.logval / log(10.0);
+      const double exponent = floor(lv10);
+      const double mantissa = lv10 - exponent;
+
+      const std::ios::fmtflags flags = sout.flags();
+      sout.setf(std::ios::fixed, std::ios::floatfield);
+      sout << ::pow(10.0, mantissa);
+      sout.setf(std::ios::showpos);
+      sout << "e" << int(exponent);
+      sout.flags(flags);
+      }
+   return sout;
+   }
+
+std::istream& operator>>(std::istream& sin, logrealsimd& x)
+   {
+   assertalways(sin.good());
+   // get the number representation as a string
+   using std::string;
+   string sval;
+   sin >> sval;
+   // split into mantissa and exponent
+   size_t pos = sval.find('e');
+   double mantissa;
+   int exponent;
+   if (pos != string::npos)
+      {
+      mantissa = atof(sval.substr(0, pos).c_str());
+      exponent = atoi(sval.substr(pos + 1).c_str());
+      }
+   else
+      {
+      mantissa = atof(sval.c_str());
+      exponent = 0;
+      }
+   // convert to logvalue
+   x.logval = logrealsimd::convertfromdouble(mantissa);
+   x.logval -= exponent * log(10.0);
+
+   assertalways(sin.good());
+   return sin;
+   }
+
+} // end namespace
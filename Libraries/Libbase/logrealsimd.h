@@ -0,0 +1,220 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __logrealsimd_h
+#define __logrealsimd_h
+
+#include "config.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace libbase {
+
+/*!
+ * \brief   Branch-Free Logarithm Arithmetic.
+ *
+ * Implements log-scale arithmetic, like logrealfast, but with all the
+ * common operations written so that they compile to straight-line code.
+ * This allows loops over arrays of this type (e.g. the recursions in the
+ * BCJR and forward-backward algorithms) to be vectorized by the compiler.
+ *
+ * Addition uses the Jacobian logarithm (max* operator):
+ *      log(a + b) = max(log(a), log(b)) + log(1 + exp(-|log(a) - log(b)|))
+ * where the correction term is obtained from a small table (1025 entries
+ * over [0,16], so it stays in L1 cache) by linear interpolation. The
+ * absolute error in the log-value is below 10^-5; this is smaller than
+ * that of the nearest-entry lookup used by logrealfast.
+ *
+ * \note Unlike logrealfast, the table is set up during static
+ * initialization, so constructors need not check for it. Since the order of
+ * static initialization across translation units is unspecified, additions
+ * must not be performed from the static initializer of another object (the
+ * table may still be empty at that point).
+ *
+ * \note Infinite values (i.e. zero or infinity) are handled without special
+ * cases in addition: the difference is clamped to the table range, which
+ * also maps the NaN from the difference of equal infinities to a zero
+ * correction. Checks for NaN in multiplication and division are only
+ * performed in debug builds.
+ */
+
+class logrealsimd {
+private:
+   static const int lutsize = 1025;
+   static const double lutrange;
+   static const double lutinvstep;
+   static double lut_value[lutsize];
+   static double lut_slope[lutsize];
+   static const bool lutready;
+
+private:
+   double logval;
+   static bool buildlut();
+   static double convertfromdouble(const double m);
+   // define as private to ensure no-one uses it
+   logrealsimd& operator-();
+
+public:
+   // construction (default value is zero)
+   logrealsimd() :
+         logval(std::numeric_limits<double>::infinity())
+      {
+      }
+   logrealsimd(const double m) :
+         logval(convertfromdouble(m))
+      {
+      }
+   // conversion
+   operator double() const
+      {
+      return exp(-logval);
+      }
+   logrealsimd& operator=(const double m)
+      {
+      logval = convertfromdouble(m);
+      return *this;
+      }
+   // arithmetic - unary
+   logrealsimd& operator+=(const logrealsimd& b);
+   logrealsimd& operator-=(const logrealsimd& b);
+   logrealsimd& operator*=(const logrealsimd& a)
+      {
+      logval += a.logval;
+      assert(!isnan(logval));
+      return *this;
+      }
+   logrealsimd& operator/=(const logrealsimd& a)
+      {
+      logval -= a.logval;
+      assert(!isnan(logval));
+      return *this;
+      }
+   // comparison
+   bool operator==(const logrealsimd& a) const
+      {
+      return logval == a.logval;
+      }
+   bool operator!=(const logrealsimd& a) const
+      {
+      return logval != a.logval;
+      }
+   bool operator>=(const logrealsimd& a) const
+      {
+      return logval <= a.logval;
+      }
+   bool operator<=(const logrealsimd& a) const
+      {
+      return logval >= a.logval;
+      }
+   bool operator>(const logrealsimd& a) const
+      {
+      return logval < a.logval;
+      }
+   bool operator<(const logrealsimd& a) const
+      {
+      return logval > a.logval;
+      }
+   // stream I/O
+   friend std::ostream& operator<<(std::ostream& sout, const logrealsimd& x);
+   friend std::istream& operator>>(std::istream& sin, logrealsimd& x);
+   // specialized power function
+   friend logrealsimd pow(const logrealsimd& a, const double b)
+      {
+      logrealsimd result = a;
+      result.logval *= b;
+      assert(!isnan(result.logval));
+      return result;
+      }
+};
+
+// arithmetic operations - unary
+
+/*! \brief add the value of 'b' to this value (let's call it 'a')
+ * This method makes use of the Jacobian logarithm:
+ *      log(a + b) = max(log(a), log(b)) + log(1 + exp(-|log(a) - log(b)|))
+ * Since we hold the negative log-value, the maximum becomes a minimum and
+ * the correction term is subtracted.
+ */
+inline logrealsimd& logrealsimd::operator+=(const logrealsimd& b)
+   {
+   const double diff = fabs(b.logval - logval);
+   // clamp to table range (a NaN difference also maps to the range limit)
+   const double x = (diff < lutrange ? diff : lutrange) * lutinvstep;
+   const int index = int(x);
+   const double correction = lut_value[index] + (x - index) * lut_slope[index];
+   logval = (b.logval < logval ? b.logval : logval) - correction;
+   return *this;
+   }
+
+/*! \brief subtract the value of 'b' from this value (let's call it 'a')
+ * This method makes use of the equality:
+ *      log(a - b) = log(a) + log(1 - exp(log(b) - log(a)))
+ * which is derived from:
+ *      a - b = a * (1 - (b / a))
+ * Since this class cannot represent a negative number, the above is only
+ * valid when a >= b. Subtraction is not needed in the inner loops of the
+ * decoders, so this is computed directly rather than from a table.
+ */
+inline logrealsimd& logrealsimd::operator-=(const logrealsimd& b)
+   {
+   assertalways(logval <= b.logval);
+   // trap equal values (including zero), which give zero
+   if (logval == b.logval)
+      logval = std::numeric_limits<double>::infinity();
+   else
+      logval -= log1p(-exp(logval - b.logval));
+   return *this;
+   }
+
+// The following functions operate through the above - no need to make them friends
+
+inline logrealsimd operator+(const logrealsimd& a, const logrealsimd& b)
+   {
+   logrealsimd result = a;
+   result += b;
+   return result;
+   }
+
+inline logrealsimd operator-(const logrealsimd& a, const logrealsimd& b)
+   {
+   logrealsimd result = a;
+   result -= b;
+   return result;
+   }
+
+inline logrealsimd operator*(const logrealsimd& a, const logrealsimd& b)
+   {
+   logrealsimd result = a;
+   result *= b;
+   return result;
+   }
+
+inline logrealsimd operator/(const logrealsimd& a, const logrealsimd& b)
+   {
+   logrealsimd result = a;
+   result /= b;
+   return result;
+   }
+
+} // end namespace
+
+#endif
@@ -195,14 +195,12 @@ void masterslave::sendname()
 
 void masterslave::sendcputime()
    {
-   const double cputime = tcpu.elapsed();
-   tcpu.start();
+   const double cputime = claimcputime();
    if (!send(cputime))
       {
       cerr << "Connection failed sending CPU time, dying here..." << std::endl;
       exit(1);
       }
-   cputimeused += cputime;
    trace << "send usage [" << cputime << "]" << std::endl;
    }
 
@@ -289,12 +287,16 @@ bool masterslave::send(const vector<double>& x)
    return success;
    }
 
+/*! \brief Send a string to the master
+ * \note String length is sent first, in the same write as the string
+ * contents; this allows the string to be used as a binary frame.
+ */
 bool masterslave::send(const std::string& x)
    {
-   int len = int(x.length());
-   if (!send(len))
-      return false;
-   return send(x.c_str(), len);
+   const int len = int(x.length());
+   std::string buf(reinterpret_cast<const char *> (&len), sizeof(len));
+   buf += x;
+   return send(buf.data(), buf.length());
    }
 
 bool masterslave::receive(void *buf, const size_t len)
@@ -307,6 +309,21 @@ bool masterslave::receive(void *buf, const size_t len)
    return true;
    }
 
+/*! \brief Get CPU time used since last claimed
+ * \return  CPU time used by this slave since the previous call (or since the
+ * last report to the master)
+ *
+ * This allows the CPU time to be returned to the master as part of a
+ * slave's results, rather than in response to a separate request.
+ */
+double masterslave::claimcputime()
+   {
+   const double cputime = tcpu.elapsed();
+   tcpu.start();
+   cputimeused += cputime;
+   return cputime;
+   }
+
 bool masterslave::receive(std::string& x)
    {
    int len;
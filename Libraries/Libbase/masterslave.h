@@ -163,6 +163,7 @@ public:
       return receive(&x, sizeof(x));
       }
    bool receive(std::string& x);
+   double claimcputime();
 
    // items for use by master
 private:
@@ -190,6 +191,10 @@ public:
       {
       return send(s, &x, sizeof(x));
       }
+   bool send(slave *s, const int64u x)
+      {
+      return send(s, &x, sizeof(x));
+      }
    bool send(slave *s, const double x)
       {
       return send(s, &x, sizeof(x));
@@ -199,12 +204,17 @@ public:
       {
       return send(s, int(WORK)) && send(s, x);
       }
-   //! Reset CPU usage accumulation
-   void resetcputime()
+   //! Reset CPU usage accumulation (optionally to a given starting value)
+   void resetcputime(double cputime = 0)
       {
-      cputimeused = 0;
+      cputimeused = cputime;
       }
    bool updatecputime(slave *s);
+   //! Accumulate CPU time reported by a slave as part of its results
+   void addcputime(double cputime)
+      {
+      cputimeused += cputime;
+      }
    bool receive(slave *s, void *buf, const size_t len);
    bool receive(slave *s, int& x)
       {
@@ -399,6 +399,7 @@ inline void matrix<T>::alloc(const int x, const int y)
       m_data = new Tp[x];
       for (int i = 0; i < x; i++)
          m_data[i] = new T[y];
+      _array_allocations++;
       }
    }
 
@@ -0,0 +1,353 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "philox.h"
+#include <algorithm>
+#include <cmath>
+
+namespace libbase {
+
+// Philox-4x32 constants
+
+namespace {
+
+const int rounds = 10; //!< Number of rounds
+const int32u M0 = 0xD2511F53; //!< Multiplier for first word pair
+const int32u M1 = 0xCD9E8D57; //!< Multiplier for second word pair
+const int32u W0 = 0x9E3779B9; //!< Key schedule increment (golden ratio)
+const int32u W1 = 0xBB67AE85; //!< Key schedule increment (sqrt(3)-1)
+
+//! Start of the tail for the ziggurat
+const double zig_r = 3.442619855899;
+//! Area of each ziggurat layer
+const double zig_v = 9.91256303526217e-3;
+
+} // end namespace
+
+const int philox::zig_layers;
+int32u philox::zig_k[zig_layers];
+double philox::zig_w[zig_layers];
+double philox::zig_f[zig_layers];
+const bool philox::zig_ready = philox::build_tables();
+
+// Internal functions
+
+/*!
+ * \brief Set up the ziggurat tables
+ *
+ * This follows the set-up in Marsaglia & Tsang, "The Ziggurat Method for
+ * Generating Random Variables", J. Statistical Software, 2000, for signed
+ * 32-bit integers.
+ */
+bool philox::build_tables()
+   {
+   const double m = 2147483648.0;
+   double d = zig_r;
+   double t = d;
+   const double q = zig_v / exp(-0.5 * d * d);
+   zig_k[0] = int32u(d / q * m);
+   zig_k[1] = 0;
+   zig_w[0] = q / m;
+   zig_w[zig_layers - 1] = d / m;
+   zig_f[0] = 1.0;
+   zig_f[zig_layers - 1] = exp(-0.5 * d * d);
+   for (int i = zig_layers - 2; i >= 1; i--)
+      {
+      d = sqrt(-2.0 * log(zig_v / d + exp(-0.5 * d * d)));
+      zig_k[i + 1] = int32u(d / t * m);
+      t = d;
+      zig_f[i] = exp(-0.5 * d * d);
+      zig_w[i] = d / m;
+      }
+   return true;
+   }
+
+/*!
+ * \brief Compute a single output block
+ * \param[in]  key   Key (seed and stream)
+ * \param[in]  ctr   Counter (position and substream)
+ * \param[out] out   Four 32-bit output values
+ */
+void philox::generate(const int32u key[2], const int32u ctr[4], int32u out[4])
+   {
+   int32u c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+   int32u k0 = key[0], k1 = key[1];
+   for (int r = 0; r < rounds; r++)
+      {
+      const int64u p0 = int64u(M0) * c0;
+      const int64u p1 = int64u(M1) * c2;
+      c0 = int32u(p1 >> 32) ^ c1 ^ k0;
+      c1 = int32u(p1);
+      c2 = int32u(p0 >> 32) ^ c3 ^ k1;
+      c3 = int32u(p0);
+      k0 += W0;
+      k1 += W1;
+      }
+   out[0] = c0;
+   out[1] = c1;
+   out[2] = c2;
+   out[3] = c3;
+   }
+
+/*!
+ * \brief Compute a sequence of consecutive output blocks
+ * \param[in]  key   Key (seed and stream)
+ * \param[in]  ctr   Counter for first block (position and substream)
+ * \param[in]  n     Number of blocks to compute
+ * \param[out] out   Array of 4n 32-bit output values
+ *
+ * Blocks are computed in groups, keeping each counter word for all blocks
+ * of a group in its own array, so that the rounds can be vectorized by the
+ * compiler across blocks.
+ */
+void philox::generate(const int32u key[2], const int32u ctr[4], const int n,
+      int32u *out)
+   {
+   const int lanes = 8;
+   const int64u start = int64u(ctr[1]) << 32 | ctr[0];
+   int b = 0;
+   for (; b + lanes <= n; b += lanes)
+      {
+      int32u c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+      for (int j = 0; j < lanes; j++)
+         {
+         const int64u c = start + b + j;
+         c0[j] = int32u(c);
+         c1[j] = int32u(c >> 32);
+         c2[j] = ctr[2];
+         c3[j] = ctr[3];
+         }
+      int32u k0 = key[0], k1 = key[1];
+      for (int r = 0; r < rounds; r++)
+         {
+         for (int j = 0; j < lanes; j++)
+            {
+            const int64u p0 = int64u(M0) * c0[j];
+            const int64u p1 = int64u(M1) * c2[j];
+            c0[j] = int32u(p1 >> 32) ^ c1[j] ^ k0;
+            c1[j] = int32u(p1);
+            c2[j] = int32u(p0 >> 32) ^ c3[j] ^ k1;
+            c3[j] = int32u(p0);
+            }
+         k0 += W0;
+         k1 += W1;
+         }
+      for (int j = 0; j < lanes; j++)
+         {
+         out[4 * (b + j) + 0] = c0[j];
+         out[4 * (b + j) + 1] = c1[j];
+         out[4 * (b + j) + 2] = c2[j];
+         out[4 * (b + j) + 3] = c3[j];
+         }
+      }
+   // remaining blocks one at a time
+   for (; b < n; b++)
+      {
+      const int64u c = start + b;
+      const int32u cb[4] = {int32u(c), int32u(c >> 32), ctr[2], ctr[3]};
+      generate(key, cb, out + 4 * b);
+      }
+   }
+
+/*!
+ * \brief Fill an array with the next values in the sequence
+ *
+ * Any values left over in the last generated block are used first; whole
+ * blocks are then generated directly into the array.
+ */
+void philox::fill(int32u *x, const int n)
+   {
+   int i = 0;
+   // use up the last generated block
+   for (; i < n && index < 4; i++)
+      x[i] = buf[index++];
+   // generate whole blocks in place
+   const int blocks = (n - i) / 4;
+   generate(key, ctr, blocks, x + i);
+   increment(blocks);
+   i += 4 * blocks;
+   // get the remaining values through the block buffer
+   for (; i < n; i++)
+      x[i] = next();
+   }
+
+/*!
+ * \brief Slow path for the ziggurat
+ *
+ * Handles the case where the sample falls outside the rectangle within the
+ * chosen layer, including the tail of the distribution.
+ */
+double philox::gval_slow(int32s hz, int iz)
+   {
+   for (;;)
+      {
+      // tail of the distribution (base layer)
+      if (iz == 0)
+         {
+         double x, y;
+         do
+            {
+            x = -log(uni()) / zig_r;
+            y = -log(uni());
+            } while (y + y < x * x);
+         return (hz > 0) ? zig_r + x : -zig_r - x;
+         }
+      // wedge between rectangle and density
+      const double x = hz * zig_w[iz];
+      if (zig_f[iz] + uni() * (zig_f[iz - 1] - zig_f[iz]) < exp(-0.5 * x * x))
+         return x;
+      // otherwise try again
+      hz = int32s(next());
+      iz = next() & (zig_layers - 1);
+      const int32u a = (hz < 0) ? int32u(-(hz + 1)) + 1 : int32u(hz);
+      if (a < zig_k[iz])
+         return hz * zig_w[iz];
+      }
+   }
+
+// Interface with random
+
+void philox::init(int32u s)
+   {
+   key[0] = s;
+   rewind();
+   }
+
+// Stream addressing
+
+/*!
+ * \brief Advance the sequence by a given number of 32-bit values
+ *
+ * This is equivalent to (but much faster than) discarding the next 'n'
+ * values. The block position wraps around at the end of the substream, as
+ * for sequential use.
+ */
+void philox::skip(int64u n)
+   {
+   // block holding the next value, and its offset within the block
+   const int64u blocks = n / 4 + (index + n % 4) / 4;
+   const int offset = int((index + n % 4) % 4);
+   const int64u block = (int64u(ctr[1]) << 32 | ctr[0]) - 1 + blocks;
+   ctr[0] = int32u(block);
+   ctr[1] = int32u(block >> 32);
+   index = 4;
+   // regenerate the block if we need to start partway through it
+   if (offset != 0)
+      {
+      generate(key, ctr, buf);
+      increment();
+      index = offset;
+      }
+   }
+
+// Block generation
+
+void philox::fill_ival(vector<int32u>& x)
+   {
+   if (x.size() > 0)
+      fill(&x(0), x.size());
+   }
+
+/*!
+ * \brief Fill with uniformly-distributed values in closed interval [0,1]
+ * Values are identical to those obtained from repeated fval_closed() calls.
+ */
+void philox::fill_fval_closed(vector<double>& x)
+   {
+   const int chunk = 256;
+   const double m = get_max();
+   int32u w[chunk];
+   for (int i = 0; i < x.size(); i += chunk)
+      {
+      const int n = std::min(chunk, x.size() - i);
+      fill(w, n);
+      for (int j = 0; j < n; j++)
+         x(i + j) = w[j] / m;
+      }
+   }
+
+/*!
+ * \brief Fill with uniformly-distributed values in half-open interval [0,1)
+ * Values are identical to those obtained from repeated fval_halfopen() calls.
+ */
+void philox::fill_fval_halfopen(vector<double>& x)
+   {
+   const int chunk = 256;
+   const double m = double(get_max()) + 1.0;
+   int32u w[chunk];
+   for (int i = 0; i < x.size(); i += chunk)
+      {
+      const int n = std::min(chunk, x.size() - i);
+      fill(w, n);
+      for (int j = 0; j < n; j++)
+         x(i + j) = w[j] / m;
+      }
+   }
+
+/*!
+ * \brief Fill with Gaussian-distributed values (zero mean, variance sigma^2)
+ * Values are identical to those obtained from repeated gval(sigma) calls.
+ *
+ * Raw values are generated in blocks, and taken in pairs through the fast
+ * path of the ziggurat. When a pair needs the slow path, the generator is
+ * returned to the value after that pair, so that the slow path continues
+ * the sequence as for a single call; unused values in the block are
+ * discarded.
+ */
+void philox::fill_gval(vector<double>& x, double sigma)
+   {
+   const int chunk = 64;
+   int32u w[chunk];
+   for (int i = 0; i < x.size();)
+      {
+      // keep the generator state at the start of the block
+      const int32u c0 = ctr[0], c1 = ctr[1];
+      const int k = index;
+      int32u b[4];
+      std::copy(buf, buf + 4, b);
+      // generate a block and use values while the fast path holds
+      const int n = std::min(chunk, 2 * (x.size() - i));
+      fill(w, n);
+      int j;
+      for (j = 0; j < n; j += 2)
+         {
+         const int32s hz = int32s(w[j]);
+         const int iz = w[j + 1] & (zig_layers - 1);
+         const int32u a = (hz < 0) ? int32u(-(hz + 1)) + 1 : int32u(hz);
+         if (a >= zig_k[iz])
+            break;
+         x(i++) = hz * zig_w[iz] * sigma;
+         }
+      if (j < n)
+         {
+         // rewind to the value after this pair and take the slow path
+         ctr[0] = c0;
+         ctr[1] = c1;
+         index = k;
+         std::copy(b, b + 4, buf);
+         skip(j + 2);
+         x(i++) = gval_slow(int32s(w[j]), w[j + 1] & (zig_layers - 1))
+               * sigma;
+         }
+      }
+   }
+
+} // end namespace
@@ -0,0 +1,181 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __philox_h
+#define __philox_h
+
+#include "config.h"
+#include "random.h"
+#include "vector.h"
+
+namespace libbase {
+
+/*!
+ * \brief   Philox Counter-Based Random Generator.
+ *
+ * A pseudo-random generator using the Philox-4x32-10 bijection due to
+ * Salmon et al. ("Parallel Random Numbers: As Easy as 1, 2, 3", SC11).
+ * Each output block of four 32-bit values is a keyed function of a 128-bit
+ * counter, so that any position in the sequence can be computed directly.
+ * The generator is addressed as follows:
+ * - the key is made up of the seed and a stream number
+ * - the upper half of the counter holds a substream number
+ * - the lower half of the counter holds the block position in the substream
+ *
+ * Independent streams or substreams can therefore be assigned to parallel
+ * workers (or to individual samples), and the sequence can be advanced by
+ * any amount in constant time.
+ *
+ * Gaussian deviates are obtained with the ziggurat method of Marsaglia and
+ * Tsang, using 128 layers; the layer index is taken from a separate 32-bit
+ * value, to avoid correlation with the deviate (as noted by Doornik). The
+ * block fill functions give exactly the same values as repeated calls to
+ * the corresponding single-value functions, so that block and per-value
+ * users of the same generator stay in step.
+ *
+ * \note Seeding keeps the current stream and substream numbers, and starts
+ * from the beginning of the substream.
+ */
+
+class philox : public random {
+private:
+   /*! \name Ziggurat tables */
+   static const int zig_layers = 128;
+   static int32u zig_k[zig_layers]; //!< Thresholds for the fast path
+   static double zig_w[zig_layers]; //!< Scale from integer to layer width
+   static double zig_f[zig_layers]; //!< Density at layer boundaries
+   static const bool zig_ready;
+   // @}
+   /*! \name Object representation */
+   int32u key[2]; //!< Seed and stream number
+   int32u ctr[4]; //!< Next block position (low words) and substream (high)
+   int32u buf[4]; //!< Last generated block
+   int index; //!< Position of next value in the last generated block
+   int32u x; //!< Current generator output value
+   // @}
+
+private:
+   /*! \name Internal functions */
+   static bool build_tables();
+   static void generate(const int32u key[2], const int32u ctr[4],
+         int32u out[4]);
+   static void generate(const int32u key[2], const int32u ctr[4], const int n,
+         int32u *out);
+   void increment(const int64u n = 1)
+      {
+      const int64u c = (int64u(ctr[1]) << 32 | ctr[0]) + n;
+      ctr[0] = int32u(c);
+      ctr[1] = int32u(c >> 32);
+      }
+   void rewind()
+      {
+      ctr[0] = ctr[1] = 0;
+      index = 4;
+      }
+   //! Get the next 32-bit value from the sequence
+   int32u next()
+      {
+      if (index == 4)
+         {
+         generate(key, ctr, buf);
+         increment();
+         index = 0;
+         }
+      return buf[index++];
+      }
+   //! Uniform value in open interval (0,1)
+   double uni()
+      {
+      return (next() + 0.5) / 4294967296.0;
+      }
+   void fill(int32u *x, const int n);
+   double gval_slow(int32s hz, int iz);
+   // @}
+
+protected:
+   // Interface with random
+   void init(int32u s);
+   void advance()
+      {
+      x = next();
+      }
+   int32u get_value() const
+      {
+      return x;
+      }
+   int32u get_max() const
+      {
+      return 0xffffffff;
+      }
+
+public:
+   /*! \name Constructors / Destructors */
+   //! Principal constructor
+   philox() :
+         index(4), x(0)
+      {
+      key[0] = key[1] = 0;
+      ctr[0] = ctr[1] = ctr[2] = ctr[3] = 0;
+      }
+   // @}
+
+   /*! \name Stream addressing */
+   //! Select stream, starting from the beginning of the substream
+   void set_stream(int32u stream)
+      {
+      key[1] = stream;
+      rewind();
+      }
+   //! Select substream, starting from its beginning
+   void set_substream(int64u substream)
+      {
+      ctr[2] = int32u(substream);
+      ctr[3] = int32u(substream >> 32);
+      rewind();
+      }
+   void skip(int64u n);
+   // @}
+
+   /*! \name Random generator interface */
+   using random::gval;
+   //! Return Gaussian-distributed double (zero mean, unit variance)
+   double gval()
+      {
+      const int32s hz = int32s(next());
+      const int iz = next() & (zig_layers - 1);
+      const int32u a = (hz < 0) ? int32u(-(hz + 1)) + 1 : int32u(hz);
+      if (a < zig_k[iz])
+         return hz * zig_w[iz];
+      return gval_slow(hz, iz);
+      }
+   // @}
+
+   /*! \name Block generation */
+   void fill_ival(vector<int32u>& x);
+   void fill_fval_closed(vector<double>& x);
+   void fill_fval_halfopen(vector<double>& x);
+   void fill_gval(vector<double>& x, double sigma = 1);
+   // @}
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,338 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __probtable_h
+#define __probtable_h
+
+#include "config.h"
+#include "aligned_allocator.h"
+#include "vector.h"
+#include "matrix.h"
+#include <algorithm>
+
+namespace libbase {
+
+/*!
+ * \brief   Flat Probability Table.
+ *
+ * A table of likelihoods for N symbols over an alphabet of size q, held as a
+ * single contiguous block in row-major order: row 'i' holds the likelihoods
+ * for symbol 'i', so that \c p(i,d) is the probability of value 'd' at index
+ * 'i'. This replaces the vector-of-vectors representation (one heap block
+ * per symbol) on the receive path between modem, mapper and codec.
+ *
+ * Each row starts on an aligned boundary; the row stride is therefore
+ * rounded up and may be larger than the number of columns. Padding elements
+ * are kept at zero. The storage type is a template parameter, so that tables
+ * may be kept in single precision where this is sufficient.
+ *
+ * Storage is kept when the table is re-initialized to the same or a smaller
+ * size, so that a table used as a workspace allocates memory only when the
+ * frame size increases.
+ *
+ * For matrix containers, the table rows correspond to the container elements
+ * in row-major order.
+ *
+ * \tparam T Storage type for likelihoods (usually float or double)
+ */
+
+template <class T>
+class probtable {
+private:
+   /*! \name Memory layout */
+   static const int alignment = 32; //!< Row alignment in bytes
+   typedef aligned_allocator<T, alignment> Allocator;
+   // @}
+   /*! \name Object representation */
+   Allocator allocator;
+   int m_rows; //!< Number of symbols
+   int m_cols; //!< Alphabet size
+   int m_stride; //!< Number of elements between row starts
+   int m_capacity; //!< Number of elements allocated
+   T *m_data;
+   // @}
+
+private:
+   /*! \name Internal functions */
+   //! Number of elements between row starts, for a given alphabet size
+   static int stride_for(const int cols)
+      {
+      const int step = std::max(1, int(alignment / sizeof(T)));
+      return (cols + step - 1) / step * step;
+      }
+   //! Allocates memory for 'n' elements, discarding any existing contents
+   void alloc(const int n)
+      {
+      free();
+      if (n > 0)
+         {
+         m_data = allocator.allocate(n);
+         _array_allocations++;
+         const T element = T();
+         for (int i = 0; i < n; i++)
+            allocator.construct(&m_data[i], element);
+         m_capacity = n;
+         }
+      }
+   //! Releases any allocated memory
+   void free()
+      {
+      if (m_capacity > 0)
+         {
+         for (int i = 0; i < m_capacity; i++)
+            allocator.destroy(&m_data[i]);
+         allocator.deallocate(m_data, m_capacity);
+         m_data = NULL;
+         m_capacity = 0;
+         }
+      }
+   // @}
+
+public:
+   /*! \name Law of the Big Three */
+   //! Destructor
+   ~probtable()
+      {
+      free();
+      }
+   /*! \brief Copy constructor
+    * \note Copy construction is a deep copy.
+    */
+   probtable(const probtable<T>& x) :
+      m_rows(0), m_cols(0), m_stride(0), m_capacity(0), m_data(NULL)
+      {
+      *this = x;
+      }
+   /*! \brief Copy assignment operator
+    * \note Copy assignment is a deep copy.
+    */
+   probtable<T>& operator=(const probtable<T>& x)
+      {
+      if (this != &x)
+         copyfrom(x);
+      return *this;
+      }
+   // @}
+
+   /*! \name Constructors / Destructors */
+   //! Default constructor (creates an empty table)
+   probtable() :
+      m_rows(0), m_cols(0), m_stride(0), m_capacity(0), m_data(NULL)
+      {
+      }
+   //! Principal constructor
+   probtable(const int rows, const int cols) :
+      m_rows(0), m_cols(0), m_stride(0), m_capacity(0), m_data(NULL)
+      {
+      init(rows, cols);
+      }
+   // @}
+
+   /*! \name Resizing operations */
+   /*! \brief Set table size
+    * Existing storage is kept if it is large enough; contents are undefined
+    * after resizing, except for padding elements which are set to zero.
+    */
+   void init(const int rows, const int cols)
+      {
+      assert(rows >= 0 && cols >= 0);
+      if (rows == m_rows && cols == m_cols)
+         return;
+      const int stride = stride_for(cols);
+      if (rows * stride > m_capacity)
+         alloc(rows * stride);
+      m_rows = rows;
+      m_cols = cols;
+      m_stride = stride;
+      if (m_stride > m_cols)
+         for (int i = 0; i < m_rows; i++)
+            std::fill(row(i) + m_cols, row(i) + m_stride, T(0));
+      }
+   // @}
+
+   /*! \name Legacy adapters */
+   /*! \brief Copy from a table of another storage type
+    * \note Rows are copied with a conversion of each element.
+    */
+   template <class A>
+   void copyfrom(const probtable<A>& x)
+      {
+      init(x.size(), x.cols());
+      for (int i = 0; i < m_rows; i++)
+         {
+         const A *src = x.row(i);
+         T *dst = row(i);
+         for (int d = 0; d < m_cols; d++)
+            dst[d] = T(src[d]);
+         }
+      }
+   /*! \brief Copy from a vector of likelihood vectors
+    * \note All inner vectors must be of the same size.
+    */
+   template <class A>
+   void copyfrom(const vector<vector<A> >& x)
+      {
+      init(x.size(), x.size() > 0 ? x(0).size() : 0);
+      for (int i = 0; i < m_rows; i++)
+         {
+         assertalways(x(i).size() == m_cols);
+         T *dst = row(i);
+         for (int d = 0; d < m_cols; d++)
+            dst[d] = T(x(i)(d));
+         }
+      }
+   /*! \brief Copy from a matrix of likelihood vectors
+    * \note Matrix elements are taken in row-major order.
+    */
+   template <class A>
+   void copyfrom(const matrix<vector<A> >& x)
+      {
+      const int rows = x.size().rows();
+      const int cols = x.size().cols();
+      init(x.size(), x.size() > 0 ? x(0, 0).size() : 0);
+      for (int i = 0; i < rows; i++)
+         for (int j = 0; j < cols; j++)
+            {
+            assertalways(x(i, j).size() == m_cols);
+            T *dst = row(i * cols + j);
+            for (int d = 0; d < m_cols; d++)
+               dst[d] = T(x(i, j)(d));
+            }
+      }
+   /*! \brief Copy to a vector of likelihood vectors
+    * \note The inner vectors are only reallocated if their size changes.
+    */
+   template <class A>
+   void copyto(vector<vector<A> >& x) const
+      {
+      x.init(m_rows);
+      for (int i = 0; i < m_rows; i++)
+         {
+         x(i).init(m_cols);
+         const T *src = row(i);
+         for (int d = 0; d < m_cols; d++)
+            x(i)(d) = A(src[d]);
+         }
+      }
+   /*! \brief Copy to a matrix of likelihood vectors
+    * \note Since the table has no notion of shape, the matrix must already
+    * have the required number of elements; these are filled in row-major
+    * order.
+    */
+   template <class A>
+   void copyto(matrix<vector<A> >& x) const
+      {
+      const int rows = x.size().rows();
+      const int cols = x.size().cols();
+      assertalways(rows * cols == m_rows);
+      for (int i = 0; i < rows; i++)
+         for (int j = 0; j < cols; j++)
+            {
+            x(i, j).init(m_cols);
+            const T *src = row(i * cols + j);
+            for (int d = 0; d < m_cols; d++)
+               x(i, j)(d) = A(src[d]);
+            }
+      }
+   // @}
+
+   /*! \name Element access */
+   //! Pointer to the start of row 'i'
+   T *row(const int i)
+      {
+      assert(i >= 0 && i < m_rows);
+      return m_data + i * m_stride;
+      }
+   //! Pointer to the start of row 'i' (read-only)
+   const T *row(const int i) const
+      {
+      assert(i >= 0 && i < m_rows);
+      return m_data + i * m_stride;
+      }
+   //! Likelihood of value 'd' at index 'i'
+   T& operator()(const int i, const int d)
+      {
+      assert(d >= 0 && d < m_cols);
+      return row(i)[d];
+      }
+   //! Likelihood of value 'd' at index 'i' (read-only)
+   const T& operator()(const int i, const int d) const
+      {
+      assert(d >= 0 && d < m_cols);
+      return row(i)[d];
+      }
+   // @}
+
+   /*! \name Arithmetic operations */
+   /*! \brief Multiply element-wise with another table of the same size
+    * \note Padding elements are included, as these are zero in both tables.
+    */
+   probtable<T>& operator*=(const probtable<T>& x)
+      {
+      assert(x.m_rows == m_rows && x.m_cols == m_cols);
+      const int n = m_rows * m_stride;
+      for (int i = 0; i < n; i++)
+         m_data[i] *= x.m_data[i];
+      return *this;
+      }
+   /*! \brief Scale each row so that its elements sum to one
+    * \note Rows that sum to zero are left unchanged.
+    */
+   void normalize()
+      {
+      for (int i = 0; i < m_rows; i++)
+         {
+         T *p = row(i);
+         T sum = 0;
+         for (int d = 0; d < m_stride; d++)
+            sum += p[d];
+         if (sum > T(0))
+            {
+            const T scale = T(1) / sum;
+            for (int d = 0; d < m_stride; d++)
+               p[d] *= scale;
+            }
+         }
+      }
+   // @}
+
+   /*! \name Information functions */
+   //! Number of symbols (rows)
+   int size() const
+      {
+      return m_rows;
+      }
+   //! Alphabet size (columns)
+   int cols() const
+      {
+      return m_cols;
+      }
+   //! Number of elements between row starts
+   int stride() const
+      {
+      return m_stride;
+      }
+   // @}
+};
+
+} // end namespace
+
+#endif
@@ -156,8 +156,11 @@ public:
       {
       return ival() / (double(get_max()) + 1.0);
       }
-   //! Return Gaussian-distributed double (zero mean, unit variance)
-   double gval();
+   /*! \brief Return Gaussian-distributed double (zero mean, unit variance)
+    * The default implementation uses the polar Box-Muller method; derived
+    * classes may override this with a faster method.
+    */
+   virtual double gval();
    //! Return Gaussian-distributed double (zero mean, variance sigma^2)
    double gval(double sigma)
       {
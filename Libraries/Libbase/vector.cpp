@@ -37,4 +37,9 @@ std::map<const void*,int> _vector_heap;
 std::map<std::pair<const void*, int>, int> _vector_refs;
 #endif
 
+int64u _array_allocations = 0;
+#ifdef USE_OMP
+#  pragma omp threadprivate(_array_allocations)
+#endif
+
 } // end namespace
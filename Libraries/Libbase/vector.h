@@ -52,6 +52,24 @@ extern std::map<const void*, int> _vector_heap;
 extern std::map<std::pair<const void*, int>, int> _vector_refs;
 #endif
 
+//! Number of main array allocations (vector and matrix) by the current thread
+extern int64u _array_allocations;
+#ifdef USE_OMP
+#  pragma omp threadprivate(_array_allocations)
+#endif
+
+/*! \brief Get the number of main array allocations made so far by the
+ * current thread
+ *
+ * This counts the allocations made by vector and matrix objects, and allows
+ * users to confirm that a steady-state process (e.g. a simulation cycle with
+ * pre-allocated workspace) does not make any such heap allocations.
+ */
+inline int64u array_allocations()
+   {
+   return _array_allocations;
+   }
+
 template <class T>
 class vector;
 template <class T>
@@ -494,6 +512,7 @@ inline void vector<T>::alloc(const int n)
       // allocate memory for all elements
       m_data = allocator.allocate(n);
       record_allocation();
+      _array_allocations++;
       // call default constructor
       const T element = T();
       for (int i = 0; i < n; i++)
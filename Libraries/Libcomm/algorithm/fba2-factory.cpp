@@ -95,6 +95,7 @@ boost::shared_ptr<fba2_interface<sig, real, real2> > fba2_factory<sig, real,
 #include "gf.h"
 #include "mpgnu.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -103,6 +104,7 @@ namespace libcomm {
 
 using libbase::mpgnu;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define USING_GF(r, x, type) \
       using libbase::type;
@@ -121,6 +123,7 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
 #define REAL_PAIRS_SEQ \
    ((mpgnu)(mpgnu)) \
    ((logrealfast)(logrealfast)) \
+   ((logrealsimd)(double)) \
    ((double)(double)) \
    ((double)(float)) \
    ((float)(float))
@@ -30,6 +30,7 @@
 #include "gf.h"
 #include "mpgnu.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -42,6 +43,7 @@ namespace libcomm {
 
 using libbase::mpgnu;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define USING_GF(r, x, type) \
       using libbase::type;
@@ -54,6 +56,7 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
 #define REAL_PAIRS_SEQ \
    ((mpgnu)(mpgnu)) \
    ((logrealfast)(logrealfast)) \
+   ((logrealsimd)(double)) \
    ((double)(double)) \
    ((double)(float)) \
    ((float)(float))
@@ -82,6 +82,8 @@ private:
    mutable int tau; //!< Frame length (all codewords in sequence)
    array1s_t r; //!< Copy of received sequence, for local computation of gamma
    array1vd_t app; //!< Copy of a-priori statistics, for local computation of gamma
+   mutable array1r_t ptable0_gamma; //!< Working space for receiver results (end without deletion)
+   mutable array1r_t ptable1_gamma; //!< Working space for receiver results (end with deletion)
    bool initialised; //!< Flag to indicate when memory is allocated
    // @}
    /*! \name User-defined parameters */
@@ -126,9 +128,8 @@ private:
    void work_gamma(const array1s_t& r, const array1vd_t& app, const int i) const
       {
       // allocate space for results
-      static array1r_t ptable0, ptable1;
-      ptable0.init(Zmax - Zmin + 1);
-      ptable1.init(Zmax - Zmin + 1);
+      ptable0_gamma.init(Zmax - Zmin + 1);
+      ptable1_gamma.init(Zmax - Zmin + 1);
       // determine if this is the first or last codeword
       const bool first = (i == 0);
       const bool last = (i == N - 1);
@@ -150,13 +151,13 @@ private:
                {
                // call batch receiver method
                receiver.R(d, i, r.extract(start, length), m1, delta1, first,
-                     last, app, ptable0, ptable1);
+                     last, app, ptable0_gamma, ptable1_gamma);
                // store in corresponding place in storage
                for (int m2 = Zmin; m2 <= Zmax; m2++)
                   {
-                  gamma_storage_entry(d, i, m1, delta1, m2, 0) = ptable0(
+                  gamma_storage_entry(d, i, m1, delta1, m2, 0) = ptable0_gamma(
                         m2 - Zmin);
-                  gamma_storage_entry(d, i, m1, delta1, m2, 1) = ptable1(
+                  gamma_storage_entry(d, i, m1, delta1, m2, 1) = ptable1_gamma(
                         m2 - Zmin);
                   }
             }
@@ -25,6 +25,10 @@
 #include "cputimer.h"
 #include <iomanip>
 
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
+
 namespace libcomm {
 
 // Determine debug level:
@@ -80,15 +84,44 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::normal
 
 // decode functions - partial computations
 
+/*! \brief Sum the gamma metric over all symbol values, for given (i,x)
+ * \return Pointer to the sum for deltax = 0, in working space
+ *
+ * Only the sums for deltax in [deltax_min, deltax_max] are computed. The
+ * inner loop is over contiguous entries, to allow vectorization.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+const real* fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::get_gamma_dsum(
+      int i, int x, int deltax_min, int deltax_max) const
+   {
+   // pointer to the working space, at deltax = 0
+   real* dsum = &gamma_dsum(-mn_min);
+   // initialize with values for first symbol
+   const real* gamma_row = get_gamma_row(0, i, x);
+   for (int deltax = deltax_min; deltax <= deltax_max; deltax++)
+      dsum[deltax] = gamma_row[deltax];
+   // accumulate remaining symbols
+   for (int d = 1; d < q; d++)
+      {
+      gamma_row = get_gamma_row(d, i, x);
+      for (int deltax = deltax_min; deltax <= deltax_max; deltax++)
+         dsum[deltax] += gamma_row[deltax];
+      }
+   return dsum;
+   }
+
 template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
 void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_alpha(const int i)
    {
    // determine the strongest path at this point
-   const real threshold = get_threshold(alpha, i - 1, mtau_min, mtau_max, th_inner);
+   const real threshold = get_threshold(alpha, alpha_row(i - 1), mtau_min,
+         mtau_max, th_inner);
+   // row being computed, indexed by x2
+   real* this_alpha = &alpha[alpha_row(i)][0];
    for (int x1 = mtau_min; x1 <= mtau_max; x1++)
       {
       // cache previous alpha value in a register
-      const real prev_alpha = alpha[i - 1][x1];
+      const real prev_alpha = alpha[alpha_row(i - 1)][x1];
       // ignore paths below a certain threshold
       if (thresholding && prev_alpha < threshold)
          continue;
@@ -97,17 +130,15 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_a
       //   x2-x1 >= mn_min
       const int x2min = std::max(mtau_min, mn_min + x1);
       const int x2max = std::min(mtau_max, mn_max + x1);
+      // gamma summed over all symbol values, indexed by deltax
+      update_gamma_cache(i - 1, x1);
+      const real* gamma_sum = get_gamma_dsum(i - 1, x1, x2min - x1, x2max - x1);
+      // NOTE: we're repeating the loop on x2, so we need to increment this
       for (int x2 = x2min; x2 <= x2max; x2++)
          {
-         // NOTE: we're repeating the loop on x2, so we need to increment this
-         real this_alpha = alpha[i][x2];
-         for (int d = 0; d < q; d++)
-            {
-            real temp = prev_alpha;
-            temp *= get_gamma(d, i - 1, x1, x2 - x1);
-            this_alpha += temp;
-            }
-         alpha[i][x2] = this_alpha;
+         real temp = prev_alpha;
+         temp *= gamma_sum[x2 - x1];
+         this_alpha[x2] += temp;
          }
       }
    }
@@ -116,7 +147,10 @@ template <class receiver_t, class sig, class real, class real2, bool thresholdin
 void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_beta(const int i)
    {
    // determine the strongest path at this point
-   const real threshold = get_threshold(beta, i + 1, mtau_min, mtau_max, th_inner);
+   const real threshold = get_threshold(beta, beta_row(i + 1), mtau_min,
+         mtau_max, th_inner);
+   // next row, indexed by x2
+   const real* next_beta = &beta[beta_row(i + 1)][0];
    for (int x1 = mtau_min; x1 <= mtau_max; x1++)
       {
       real this_beta = 0;
@@ -125,21 +159,25 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_b
       //   x2-x1 >= mn_min
       const int x2min = std::max(mtau_min, mn_min + x1);
       const int x2max = std::min(mtau_max, mn_max + x1);
+      // gamma summed over all symbol values, indexed by deltax
+      // (obtained at the first path above threshold, to avoid computing
+      // gamma values that are not used)
+      const real* gamma_sum = NULL;
       for (int x2 = x2min; x2 <= x2max; x2++)
          {
-         // cache next beta value in a register
-         const real next_beta = beta[i + 1][x2];
          // ignore paths below a certain threshold
-         if (thresholding && next_beta < threshold)
+         if (thresholding && next_beta[x2] < threshold)
             continue;
-         for (int d = 0; d < q; d++)
+         if (gamma_sum == NULL)
             {
-            real temp = next_beta;
-            temp *= get_gamma(d, i, x1, x2 - x1);
-            this_beta += temp;
+            update_gamma_cache(i, x1);
+            gamma_sum = get_gamma_dsum(i, x1, x2min - x1, x2max - x1);
             }
+         real temp = next_beta[x2];
+         temp *= gamma_sum[x2 - x1];
+         this_beta += temp;
          }
-      beta[i][x1] = this_beta;
+      beta[beta_row(i)][x1] = this_beta;
       }
    }
 
@@ -148,33 +186,36 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_m
       const int i) const
    {
    // determine the strongest path at this point
-   const real threshold = get_threshold(alpha, i, mtau_min, mtau_max, th_outer);
-   for (int d = 0; d < q; d++)
+   const real threshold = get_threshold(alpha, alpha_row(i), mtau_min,
+         mtau_max, th_outer);
+   // initialize result holder
+   array1r_t& p = ptable(i);
+   p = real(0);
+   // next row of beta, indexed by x2
+   const real* next_beta = &beta[beta_row(i + 1)][0];
+   for (int x1 = mtau_min; x1 <= mtau_max; x1++)
       {
-      // initialize result holder
-      real p = 0;
-      for (int x1 = mtau_min; x1 <= mtau_max; x1++)
+      // cache this alpha value in a register
+      const real this_alpha = alpha[alpha_row(i)][x1];
+      // ignore paths below a certain threshold
+      if (thresholding && this_alpha < threshold)
+         continue;
+      // limits on deltax can be combined as (c.f. allocate() for details):
+      //   x2-x1 <= mn_max
+      //   x2-x1 >= mn_min
+      const int x2min = std::max(mtau_min, mn_min + x1);
+      const int x2max = std::min(mtau_max, mn_max + x1);
+      update_gamma_cache(i, x1);
+      for (int d = 0; d < q; d++)
          {
-         // cache this alpha value in a register
-         const real this_alpha = alpha[i][x1];
-         // ignore paths below a certain threshold
-         if (thresholding && this_alpha < threshold)
-            continue;
-         // limits on deltax can be combined as (c.f. allocate() for details):
-         //   x2-x1 <= mn_max
-         //   x2-x1 >= mn_min
-         const int x2min = std::max(mtau_min, mn_min + x1);
-         const int x2max = std::min(mtau_max, mn_max + x1);
+         // gamma values for this symbol, indexed by deltax
+         const real* gamma_row = get_gamma_row(d, i, x1);
+         real temp = 0;
          for (int x2 = x2min; x2 <= x2max; x2++)
-            {
-            real temp = this_alpha;
-            temp *= beta[i + 1][x2];
-            temp *= get_gamma(d, i, x1, x2 - x1);
-            p += temp;
-            }
+            temp += next_beta[x2] * gamma_row[x2 - x1];
+         temp *= this_alpha;
+         p(d) += temp;
          }
-      // store result
-      ptable(i)(d) = p;
       }
    }
 
@@ -186,7 +227,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_s
    // compute posterior probabilities for given index
    ptable.init(mtau_max - mtau_min + 1);
    for (int x = mtau_min; x <= mtau_max; x++)
-      ptable(x - mtau_min) = alpha[i][x] * beta[i][x];
+      ptable(x - mtau_min) = alpha[alpha_row(i)][x] * beta[beta_row(i)][x];
    }
 
 // *** Internal functions - main
@@ -201,11 +242,29 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
    // flag the state of the arrays
    initialised = true;
 
-   // alpha needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
-   // beta needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
    typedef boost::multi_array_types::extent_range range;
-   alpha.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
-   beta.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
+   if (window > 0)
+      {
+      // alpha needs indices (i,x) where i in [i0, i0+W] for the current
+      // window and x in [mtau_min, mtau_max]
+      // alpha_checkpoint needs indices (k,x) where k in [0, ceil(N/W)-1]
+      // beta needs indices (i,x) where i in {i, i+1} and x in [mtau_min, mtau_max]
+      alpha.resize(boost::extents[window + 1][range(mtau_min, mtau_max + 1)]);
+      alpha_checkpoint.resize(
+            boost::extents[(N + window - 1) / window][range(mtau_min, mtau_max + 1)]);
+      beta.resize(boost::extents[2][range(mtau_min, mtau_max + 1)]);
+      }
+   else
+      {
+      // alpha needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
+      // beta needs indices (i,x) where i in [0, N] and x in [mtau_min, mtau_max]
+      alpha.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
+      alpha_checkpoint.resize(boost::extents[0][0]);
+      beta.resize(boost::extents[N + 1][range(mtau_min, mtau_max + 1)]);
+      }
+   alpha_offset = 0;
+   // working space for gamma summed over symbols needs indices (deltax)
+   gamma_dsum.init(mn_max - mn_min + 1);
 
    if (globalstore)
       {
@@ -273,6 +332,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::alloca
    bytes_used += sizeof(bool) * cached.global.num_elements();
    bytes_used += sizeof(bool) * cached.local.num_elements();
    bytes_used += sizeof(real) * alpha.num_elements();
+   bytes_used += sizeof(real) * alpha_checkpoint.num_elements();
    bytes_used += sizeof(real) * beta.num_elements();
    bytes_used += sizeof(real) * gamma.global.num_elements();
    bytes_used += sizeof(real) * gamma.local.num_elements();
@@ -321,6 +381,7 @@ template <class receiver_t, class sig, class real, class real2, bool thresholdin
 void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::free()
    {
    alpha.resize(boost::extents[0][0]);
+   alpha_checkpoint.resize(boost::extents[0][0]);
    beta.resize(boost::extents[0][0]);
    gamma.global.resize(boost::extents[0][0][0][0]);
    gamma.local.resize(boost::extents[0][0][0]);
@@ -386,6 +447,24 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_g
 #endif
    // global pre-computation of gamma values
    libbase::pacifier progress("FBA Gamma");
+#ifdef USE_OMP
+   // compute metric at each symbol index, splitting indices across threads;
+   // each thread has its own working space, and only the master thread
+   // updates the pacifier
+#pragma omp parallel
+      {
+      array1r_t ptable;
+      array1r2_t ptable_r;
+#pragma omp for schedule(dynamic)
+      for (int i = 0; i < N; i++)
+         {
+         if (omp_get_thread_num() == 0)
+            std::cerr << progress.update(i, N);
+         // compute partial result
+         work_gamma(r, app, i, ptable, ptable_r);
+         }
+      }
+#else
    // compute metric at each symbol index
    for (int i = 0; i < N; i++)
       {
@@ -393,6 +472,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_g
       // compute partial result
       work_gamma(r, app, i);
       }
+#endif
    std::cerr << progress.update(N, N);
 #if DEBUG>=3
    print_gamma(std::cerr);
@@ -484,19 +564,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_a
    for (int i = 1; i <= N; i++)
       {
       std::cerr << progress.update(i - 1, N);
-      // local storage
-      if (!globalstore)
-         {
-         // pre-compute local gamma values, if necessary
-         if (!lazy)
-            work_gamma(r, app, i - 1);
-         // reset local cache, if necessary
-         else
-            {
-            gamma.local = real(0);
-            cached.local = false;
-            }
-         }
+      // prepare local gamma values
+      work_gamma_local(i - 1);
       // compute partial result
       work_alpha(i);
       // normalize
@@ -530,19 +599,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_b
    for (int i = N - 1; i >= 0; i--)
       {
       std::cerr << progress.update(N - 1 - i, N);
-      // local storage
-      if (!globalstore)
-         {
-         // pre-compute local gamma values, if necessary
-         if (!lazy)
-            work_gamma(r, app, i);
-         // reset local cache, if necessary
-         else
-            {
-            gamma.local = real(0);
-            cached.local = false;
-            }
-         }
+      // prepare local gamma values
+      work_gamma_local(i);
       // compute partial result
       work_beta(i);
       // normalize
@@ -562,6 +620,137 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_b
 #endif
    }
 
+// decode functions - windowed path
+
+/*! \brief Restore forward metric at start of window 'k' from checkpoint
+ * The checkpointed row becomes the first row of alpha storage.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::load_alpha_checkpoint(
+      const int k)
+   {
+   alpha_offset = k * window;
+   for (int x = mtau_min; x <= mtau_max; x++)
+      alpha[0][x] = alpha_checkpoint[k][x];
+   }
+
+/*! \brief Compute forward metric for codeword boundaries in (i0, i1]
+ * The row for boundary i0 must already be in the first row of alpha storage.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_alpha_window(
+      const int i0, const int i1)
+   {
+   assert(alpha_offset == i0);
+   assert(i1 - i0 <= window);
+   for (int i = i0 + 1; i <= i1; i++)
+      {
+      // prepare local gamma values
+      work_gamma_local(i - 1);
+      // initialise row, as this is accumulated
+      for (int x = mtau_min; x <= mtau_max; x++)
+         alpha[alpha_row(i)][x] = real(0);
+      // compute partial result
+      work_alpha(i);
+      // normalize
+      normalize_alpha(i);
+      }
+   }
+
+/*! \brief Forward pass for windowed decoding
+ * Only the forward metric at the start of each window is kept.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_alpha_checkpoints(
+      const array1d_t& sof_prior)
+   {
+   assert(initialised);
+   libbase::pacifier progress("FBA Alpha");
+   // set initial drift distribution
+   alpha_offset = 0;
+   for (int x = mtau_min; x <= mtau_max; x++)
+      alpha[0][x] = real(sof_prior(x - mtau_min));
+   // normalize
+   normalize_alpha(0);
+   // keep first checkpoint
+   for (int x = mtau_min; x <= mtau_max; x++)
+      alpha_checkpoint[0][x] = alpha[0][x];
+   // compute each window in turn, keeping the last row as the next checkpoint
+   const int K = (N + window - 1) / window;
+   for (int k = 0; k < K; k++)
+      {
+      const int i0 = k * window;
+      const int i1 = std::min(i0 + window, N);
+      std::cerr << progress.update(i0, N);
+      load_alpha_checkpoint(k);
+      work_alpha_window(i0, i1);
+      if (k + 1 < K)
+         for (int x = mtau_min; x <= mtau_max; x++)
+            alpha_checkpoint[k + 1][x] = alpha[alpha_row(i1)][x];
+      }
+   std::cerr << progress.update(N, N);
+#if DEBUG>=3
+   std::cerr << "alpha_checkpoint = " << alpha_checkpoint << std::endl;
+#endif
+   }
+
+/*! \brief Backward pass and results for windowed decoding
+ * Windows are processed from last to first; the forward metric within each
+ * window is recomputed from its checkpoint before the backward metric and
+ * message posteriors are computed. Only the last two rows of beta are kept.
+ * Results are identical to whole-frame decoding, at the cost of a second
+ * forward pass.
+ */
+template <class receiver_t, class sig, class real, class real2, bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::work_beta_and_results_windowed(
+      const array1d_t& eof_prior, array1vr_t& ptable, array1r_t& sof_post,
+      array1r_t& eof_post)
+   {
+   assert(initialised);
+   libbase::pacifier progress("FBA Beta + Results");
+   // Initialise result vector:
+   // ptable(i,d) = posterior prob. of having transmitted symbol 'd' at time 'i'
+   libbase::allocate(ptable, N, q);
+   // set final drift distribution
+   for (int x = mtau_min; x <= mtau_max; x++)
+      beta[beta_row(N)][x] = real(eof_prior(x - mtau_min));
+   // normalize
+   normalize_beta(N);
+   // compute each window in turn, starting from the last
+   const int K = (N + window - 1) / window;
+   for (int k = K - 1; k >= 0; k--)
+      {
+      const int i0 = k * window;
+      const int i1 = std::min(i0 + window, N);
+      // recompute forward metric within this window
+      load_alpha_checkpoint(k);
+      work_alpha_window(i0, i1);
+      // compute APP of eof state values before beta row is overwritten
+      if (k == K - 1)
+         work_state_app(eof_post, N);
+      for (int i = i1 - 1; i >= i0; i--)
+         {
+         std::cerr << progress.update(N - 1 - i, N);
+         // prepare local gamma values
+         work_gamma_local(i);
+         // compute partial result
+         work_beta(i);
+         // normalize
+         normalize_beta(i);
+         // compute partial result
+         work_message_app(ptable, i);
+         }
+      }
+   std::cerr << progress.update(N, N);
+   // compute APP of sof state values
+   work_state_app(sof_post, 0);
+#if DEBUG>=3
+   std::cerr << "ptable = " << ptable << std::endl;
+   std::cerr << "sof_post = " << sof_post << std::endl;
+   std::cerr << "eof_post = " << eof_post << std::endl;
+#endif
+   }
+
 // User procedures
 
 // Initialization
@@ -608,6 +797,23 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::init(
    this->th_outer = real(th_outer);
    }
 
+/*! \brief Set window size for memory-bounded decoding
+ * A window size of zero keeps the forward and backward metrics for the whole
+ * frame. Windowed decoding is only available with local storage of gamma.
+ */
+template <class receiver_t, class sig, class real, class real2,
+      bool thresholding, bool lazy, bool globalstore>
+void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::set_window(
+      int window)
+   {
+   assertalways(window >= 0);
+   assertalways(window == 0 || !globalstore);
+   // window size affects memory, so release if changed
+   if (initialised && window != this->window)
+      free();
+   this->window = window;
+   }
+
 /*!
  * \brief Frame decode cycle
  * \param[in] collector Reference to (instrumented) results collector object
@@ -700,6 +906,17 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
       work_results(ptable, sof_post, eof_post);
       collector.add_timer(tr);
       }
+   else if (window > 0)
+      {
+      // Alpha (checkpoints only)
+      libbase::cputimer ta("t_alpha");
+      work_alpha_checkpoints(sof_prior);
+      collector.add_timer(ta);
+      // Beta, with alpha recomputed per window
+      libbase::cputimer tbr("t_beta+results");
+      work_beta_and_results_windowed(eof_prior, ptable, sof_post, eof_post);
+      collector.add_timer(tbr);
+      }
    else
       {
       // Alpha
@@ -720,7 +937,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
    collector.add_timer(m1_min, "c_m1_min");
    collector.add_timer(m1_max, "c_m1_max");
    // Add memory usage
-   collector.add_timer(sizeof(real) * alpha.num_elements(), "m_alpha");
+   collector.add_timer(sizeof(real) * (alpha.num_elements() + alpha_checkpoint.num_elements()), "m_alpha");
    collector.add_timer(sizeof(real) * beta.num_elements(), "m_beta");
    collector.add_timer(sizeof(real) * (gamma.global.num_elements() + gamma.local.num_elements()), "m_gamma");
 
@@ -729,8 +946,7 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy, globalstore>::decode
    if (lazy)
       {
       const double usage = gamma_misses / double(N * (mtau_max - mtau_min + 1));
-      const double reuse = gamma_calls
-            / double(gamma_misses * q * (mn_max - mn_min + 1));
+      const double reuse = gamma_calls / double(gamma_misses);
       std::cerr << "FBA Cache Usage: " << 100 * usage << "%" << std::endl;
       std::cerr << "FBA Cache Reuse: " << reuse << "×" << std::endl;
       }
@@ -752,6 +968,8 @@ void fba2<receiver_t, sig, real, real2, thresholding, lazy,
       globalstore>::get_drift_pdf(array1vr_t& pdftable) const
    {
    assert(initialised);
+   if (window > 0)
+      failwith("Drift pdf at codeword boundaries not kept in windowed decoding");
    // allocate space for results
    pdftable.init(N + 1);
    // consider each time index in the order given
@@ -81,6 +81,17 @@ public:
    virtual void init(int N, int q, int mtau_min, int mtau_max, int mn_min,
          int mn_max, int m1_min, int m1_max, double th_inner, double th_outer,
          const typename libcomm::channel_insdel<sig, real2>::metric_computer& computer) = 0;
+   /*! \brief Set window size for memory-bounded decoding
+    * A window size of zero (the default) keeps the forward and backward
+    * metrics for the whole frame; otherwise, the forward metric is kept only
+    * at window boundaries and recomputed within each window as needed.
+    * Implementations that do not support this fail for non-zero sizes.
+    */
+   virtual void set_window(int window)
+      {
+      if (window != 0)
+         failwith("Windowed decoding not supported by this algorithm");
+      }
    /*! \brief Set up encoding table
     * Needs to be done before every frame.
     */
@@ -62,6 +62,7 @@ public:
    typedef libbase::matrix<array1s_t> array2vs_t;
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<real> array1r_t;
+   typedef libbase::vector<real2> array1r2_t;
    typedef libbase::vector<array1d_t> array1vd_t;
    typedef libbase::vector<array1r_t> array1vr_t;
    typedef boost::assignable_multi_array<real, 2> array2r_t;
@@ -75,6 +76,8 @@ private:
    mutable receiver_t receiver; //!< Inner code receiver metric computation
    array2r_t alpha; //!< Forward recursion metric
    array2r_t beta; //!< Backward recursion metric
+   array2r_t alpha_checkpoint; //!< Forward metric at window boundaries, for windowed decoding
+   int alpha_offset; //!< Codeword boundary held in first row of alpha, for windowed decoding
    mutable struct {
       array4r_t global; // indices (i,x,d,deltax)
       array3r_t local; // indices (x,d,deltax)
@@ -88,6 +91,9 @@ private:
    mutable int tau; //!< Frame length (all codewords in sequence)
    array1s_t r; //!< Copy of received sequence, for lazy or local computation of gamma
    array1vd_t app; //!< Copy of a-priori statistics, for lazy or local computation of gamma
+   mutable array1r_t ptable_gamma; //!< Working space for receiver results, for computation of gamma
+   mutable array1r2_t ptable_receiver; //!< Working space for receiver results in internal format
+   mutable array1r_t gamma_dsum; //!< Working space for gamma summed over symbol values
    bool initialised; //!< Flag to indicate when memory is allocated
 #ifndef NDEBUG
    mutable int gamma_calls; //!< Number of calls requesting gamma values
@@ -105,6 +111,7 @@ private:
    int mn_max; //!< The largest positive drift within a q-ary symbol is \f$ m_n^{+} \f$
    int m1_min; //!< The largest negative drift over a single channel symbol is \f$ m_1^{-} \f$
    int m1_max; //!< The largest positive drift over a single channel symbol is \f$ m_1^{+} \f$
+   int window; //!< Window size in codewords for memory-bounded decoding (0 for whole frame)
    // @}
 private:
    /*! \name Internal functions - computer */
@@ -116,11 +123,14 @@ private:
       else
          return gamma.local[x][d][deltax];
       }
-   //! Fill indicated storage entries for gamma metric - batch interface
-   void fill_gamma_storage_batch(const array1s_t& r, const array1vd_t& app, int i, int x) const
+   /*! \brief Fill indicated storage entries for gamma metric - batch interface
+    * Uses the given working space for receiver results, allowing concurrent
+    * use by separate threads on different indices.
+    */
+   void fill_gamma_storage_batch(const array1s_t& r, const array1vd_t& app,
+         int i, int x, array1r_t& ptable, array1r2_t& ptable_r) const
       {
       // allocate space for results
-      static array1r_t ptable;
       ptable.init(mn_max - mn_min + 1);
       // determine received segment to extract
       // n * i = offset to start of current codeword
@@ -131,15 +141,21 @@ private:
       for (int d = 0; d < q; d++)
          {
          // call batch receiver method
-         receiver.R(d, i, r.extract(start, length), app, ptable);
+         receiver.R(d, i, r.extract(start, length), app, ptable, ptable_r);
          // store in corresponding place in storage
          for (int deltax = mn_min; deltax <= mn_max; deltax++)
             gamma_storage_entry(d, i, x, deltax) = ptable(deltax - mn_min);
          }
       }
+   //! Fill indicated storage entries for gamma metric - batch interface
+   void fill_gamma_storage_batch(const array1s_t& r, const array1vd_t& app, int i, int x) const
+      {
+      fill_gamma_storage_batch(r, app, i, x, ptable_gamma, ptable_receiver);
+      }
    /*! \brief Fill indicated cache entries for gamma metric as needed
     *
-    * This method is called on every get_gamma call when doing lazy computation.
+    * This method is called before every use of the gamma values at (i,x)
+    * when doing lazy computation.
     * It will update the cache as needed, for both local/global storage.
     */
    void fill_gamma_cache_conditional(int i, int x) const
@@ -174,24 +190,37 @@ private:
          fill_gamma_storage_batch(r, app, i, x);
          }
       }
-   /*! \brief Wrapper for retrieving gamma metric value
-    * This method is called from nested loops as follows:
-    * - from work_alpha:
-    *        i,x,d=outer loops
-    *        deltax=inner loop
-    * - from work_beta:
-    *        i,x,d=outer loops
-    *        deltax=inner loop
-    * - from work_message_app:
-    *        i,d,x=outer loops
-    *        deltax=inner loop
+   /*! \brief Get a pointer to the gamma metric values for given (d,i,x)
+    * The returned pointer corresponds to deltax = 0, with values for the
+    * range [mn_min, mn_max] held contiguously. This method is called from
+    * work_alpha, work_beta and work_message_app, where the inner loop is
+    * over deltax.
+    *
+    * \note When doing lazy computation, the cache must be updated for (i,x)
+    *       before calling this method.
+    */
+   const real* get_gamma_row(int d, int i, int x) const
+      {
+      return &gamma_storage_entry(d, i, x, 0);
+      }
+   /*! \brief Update cache values for gamma metric at (i,x) if necessary
     */
-   real get_gamma(int d, int i, int x, int deltax) const
+   void update_gamma_cache(int i, int x) const
       {
-      // update cache values if necessary
       if (lazy)
          fill_gamma_cache_conditional(i, x);
-      return gamma_storage_entry(d, i, x, deltax);
+      }
+   const real* get_gamma_dsum(int i, int x, int deltax_min,
+         int deltax_max) const;
+   //! Row in alpha storage for codeword boundary 'i'
+   int alpha_row(int i) const
+      {
+      return i - alpha_offset;
+      }
+   //! Row in beta storage for codeword boundary 'i'
+   int beta_row(int i) const
+      {
+      return window > 0 ? (i & 1) : i;
       }
    // common small tasks
    static real get_threshold(const array2r_t& metric, int row, int col_min,
@@ -201,11 +230,11 @@ private:
    static void normalize(array2r_t& metric, int row, int col_min, int col_max);
    void normalize_alpha(int i)
       {
-      normalize(alpha, i, mtau_min, mtau_max);
+      normalize(alpha, alpha_row(i), mtau_min, mtau_max);
       }
    void normalize_beta(int i)
       {
-      normalize(beta, i, mtau_min, mtau_max);
+      normalize(beta, beta_row(i), mtau_min, mtau_max);
       }
    // decode functions - partial computations
    void work_gamma(const array1s_t& r, const array1vd_t& app,
@@ -214,6 +243,28 @@ private:
       for (int x = mtau_min; x <= mtau_max; x++)
          fill_gamma_storage_batch(r, app, i, x);
       }
+   void work_gamma(const array1s_t& r, const array1vd_t& app, const int i,
+         array1r_t& ptable, array1r2_t& ptable_r) const
+      {
+      for (int x = mtau_min; x <= mtau_max; x++)
+         fill_gamma_storage_batch(r, app, i, x, ptable, ptable_r);
+      }
+   /*! \brief Prepare local storage of gamma metric for index 'i'
+    * Pre-computes the local gamma values, or resets the local cache when
+    * doing lazy computation; does nothing when using global storage.
+    */
+   void work_gamma_local(const int i)
+      {
+      if (globalstore)
+         return;
+      if (!lazy)
+         work_gamma(r, app, i);
+      else
+         {
+         gamma.local = real(0);
+         cached.local = false;
+         }
+      }
    void work_alpha(const int i);
    void work_beta(const int i);
    void work_message_app(array1vr_t& ptable, const int i) const;
@@ -237,12 +288,18 @@ private:
    void work_alpha(const array1d_t& sof_prior);
    void work_beta_and_results(const array1d_t& eof_prior, array1vr_t& ptable,
          array1r_t& sof_post, array1r_t& eof_post);
+   // decode functions - windowed path
+   void load_alpha_checkpoint(const int k);
+   void work_alpha_window(const int i0, const int i1);
+   void work_alpha_checkpoints(const array1d_t& sof_prior);
+   void work_beta_and_results_windowed(const array1d_t& eof_prior,
+         array1vr_t& ptable, array1r_t& sof_post, array1r_t& eof_post);
    // @}
 public:
    /*! \name Constructors / Destructors */
    //! Default constructor
    fba2() :
-         initialised(false)
+         alpha_offset(0), initialised(false), window(0)
       {
       }
    // @}
@@ -254,6 +311,7 @@ public:
    void init(int N, int q, int mtau_min, int mtau_max, int mn_min, int mn_max,
          int m1_min, int m1_max, double th_inner, double th_outer,
          const typename libcomm::channel_insdel<sig, real2>::metric_computer& computer);
+   void set_window(int window);
    /*! \brief Set up encoding table
     * Needs to be done before every frame.
     */
@@ -282,6 +340,8 @@ public:
          array1r_t& eof_post, const int offset);
    void get_drift_pdf(array1r_t& pdf, const int i) const
       {
+      if (window > 0)
+         failwith("Drift pdf at codeword boundaries not kept in windowed decoding");
       work_state_app(pdf, i);
       }
    void get_drift_pdf(array1vr_t& pdftable) const;
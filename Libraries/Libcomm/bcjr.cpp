@@ -21,9 +21,22 @@
 
 #include "bcjr.h"
 #include <iomanip>
+#include <limits>
+#include <algorithm>
 
 namespace libcomm {
 
+// Log-MAP correction table
+
+const float bcjr_logmap::lutinvstep = 2.0f;
+
+/*!
+ * \brief Correction term log(1 + exp(-x)) at the midpoint of each interval
+ * of width 0.5 over [0,4)
+ */
+const float bcjr_logmap::lut[bcjr_logmap::lutsize] = {0.5759f, 0.3869f,
+      0.2519f, 0.1602f, 0.1002f, 0.0620f, 0.0380f, 0.0232f};
+
 // Initialization
 
 /*!
@@ -50,19 +63,36 @@ void bcjr<real, dbl, norm>::init(fsm& encoder, const int tau)
    M = encoder.num_states();
 
    // initialise LUT's for state table
-   lut_X.init(M, K);
-   lut_m.init(M, K);
+   lut_X.init(M * K);
+   lut_m.init(M * K);
    for (int mdash = 0; mdash < M; mdash++)
       for (int i = 0; i < K; i++)
          {
+         const int b = mdash * K + i;
          array1i_t mdash_v = encoder.convert_state(mdash);
          encoder.reset(mdash_v);
          array1i_t input = encoder.convert_input(i);
-         lut_X(mdash, i) = encoder.convert_output(encoder.step(input));
-         assert(lut_X(mdash, i) >= 0 && lut_X(mdash, i) < N);
-         lut_m(mdash, i) = encoder.convert_state(encoder.state());
-         assert(lut_m(mdash, i) >= 0 && lut_m(mdash, i) < M);
+         lut_X(b) = encoder.convert_output(encoder.step(input));
+         assert(lut_X(b) >= 0 && lut_X(b) < N);
+         lut_m(b) = encoder.convert_state(encoder.state());
+         assert(lut_m(b) >= 0 && lut_m(b) < M);
          }
+   // list the branches entering each state, in order of (m',i)
+   lut_in_start.init(M + 1);
+   lut_in_start = 0;
+   for (int b = 0; b < M * K; b++)
+      lut_in_start(lut_m(b) + 1)++;
+   for (int m = 0; m < M; m++)
+      lut_in_start(m + 1) += lut_in_start(m);
+   lut_in_b.init(M * K);
+   lut_in_m.init(M * K);
+   array1i_t next = lut_in_start.extract(0, M);
+   for (int b = 0; b < M * K; b++)
+      {
+      const int j = next(lut_m(b))++;
+      lut_in_b(j) = b;
+      lut_in_m(j) = b / K;
+      }
 
    // set flag as necessary
    initialised = false;
@@ -74,8 +104,11 @@ template <class real, class dbl, bool norm>
 typename bcjr<real, dbl, norm>::array1d_t bcjr<real, dbl, norm>::getstart() const
    {
    array1d_t r(M);
-   for (int m = 0; m < M; m++)
-      r(m) = dbl(beta(0, m));
+   if (algorithm != algorithm_map)
+      work_exp(beta_log.extract(0, M), r);
+   else
+      for (int m = 0; m < M; m++)
+         r(m) = dbl(beta(m));
    return r;
    }
 
@@ -83,8 +116,11 @@ template <class real, class dbl, bool norm>
 typename bcjr<real, dbl, norm>::array1d_t bcjr<real, dbl, norm>::getend() const
    {
    array1d_t r(M);
-   for (int m = 0; m < M; m++)
-      r(m) = dbl(alpha(tau, m));
+   if (algorithm != algorithm_map)
+      work_exp(alpha_log.extract(tau * M, M), r);
+   else
+      for (int m = 0; m < M; m++)
+         r(m) = dbl(alpha(tau * M + m));
    return r;
    }
 
@@ -95,8 +131,12 @@ void bcjr<real, dbl, norm>::setstart()
    {
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      alpha(0, m) = real(1.0 / M);
+   if (algorithm != algorithm_map)
+      for (int m = 0; m < M; m++)
+         alpha_log(m) = float(-log(double(M)));
+   else
+      for (int m = 0; m < M; m++)
+         alpha(m) = real(1.0 / M);
    }
 
 template <class real, class dbl, bool norm>
@@ -104,8 +144,12 @@ void bcjr<real, dbl, norm>::setend()
    {
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      beta(tau, m) = real(1.0 / M);
+   if (algorithm != algorithm_map)
+      for (int m = 0; m < M; m++)
+         beta_log(tau * M + m) = float(-log(double(M)));
+   else
+      for (int m = 0; m < M; m++)
+         beta(tau * M + m) = real(1.0 / M);
    }
 
 // Set start- and end-state probabilities - known state
@@ -115,9 +159,18 @@ void bcjr<real, dbl, norm>::setstart(int state)
    {
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      alpha(0, m) = real(0);
-   alpha(0, state) = real(1);
+   if (algorithm != algorithm_map)
+      {
+      for (int m = 0; m < M; m++)
+         alpha_log(m) = -std::numeric_limits<float>::infinity();
+      alpha_log(state) = 0;
+      }
+   else
+      {
+      for (int m = 0; m < M; m++)
+         alpha(m) = real(0);
+      alpha(state) = real(1);
+      }
    }
 
 template <class real, class dbl, bool norm>
@@ -125,9 +178,18 @@ void bcjr<real, dbl, norm>::setend(int state)
    {
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      beta(tau, m) = real(0);
-   beta(tau, state) = real(1);
+   if (algorithm != algorithm_map)
+      {
+      for (int m = 0; m < M; m++)
+         beta_log(tau * M + m) = -std::numeric_limits<float>::infinity();
+      beta_log(tau * M + state) = 0;
+      }
+   else
+      {
+      for (int m = 0; m < M; m++)
+         beta(tau * M + m) = real(0);
+      beta(tau * M + state) = real(1);
+      }
    }
 
 // Set start- and end-state probabilities - direct
@@ -138,8 +200,12 @@ void bcjr<real, dbl, norm>::setstart(const array1d_t& p)
    assert(p.size() == M);
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      alpha(0, m) = real(p(m));
+   if (algorithm != algorithm_map)
+      for (int m = 0; m < M; m++)
+         alpha_log(m) = float(log(double(p(m))));
+   else
+      for (int m = 0; m < M; m++)
+         alpha(m) = real(p(m));
    }
 
 template <class real, class dbl, bool norm>
@@ -148,8 +214,12 @@ void bcjr<real, dbl, norm>::setend(const array1d_t& p)
    assert(p.size() == M);
    if (!initialised)
       allocate();
-   for (int m = 0; m < M; m++)
-      beta(tau, m) = real(p(m));
+   if (algorithm != algorithm_map)
+      for (int m = 0; m < M; m++)
+         beta_log(tau * M + m) = float(log(double(p(m))));
+   else
+      for (int m = 0; m < M; m++)
+         beta(tau * M + m) = real(p(m));
    }
 
 // Internal methods
@@ -161,9 +231,25 @@ void bcjr<real, dbl, norm>::allocate()
    {
    // to save space, gamma is defined from 0 to tau-1, rather than 1 to tau.
    // for this reason, gamma_t (and only gamma_t) is actually written gamma[t-1, ...
-   alpha.init(tau + 1, M);
-   beta.init(tau + 1, M);
-   gamma.init(tau, M, K);
+   // only the matrices needed by the chosen algorithm are allocated
+   if (algorithm != algorithm_map)
+      {
+      alpha.init(0);
+      beta.init(0);
+      gamma.init(0);
+      alpha_log.init((tau + 1) * M);
+      beta_log.init((tau + 1) * M);
+      gamma_log.init(tau * M * K);
+      }
+   else
+      {
+      alpha.init((tau + 1) * M);
+      beta.init((tau + 1) * M);
+      gamma.init(tau * M * K);
+      alpha_log.init(0);
+      beta_log.init(0);
+      gamma_log.init(0);
+      }
    // flag the state of the arrays
    initialised = true;
 
@@ -173,7 +259,8 @@ void bcjr<real, dbl, norm>::allocate()
    const std::streamsize prec = std::cerr.precision(1);
    // determine memory occupied and tell user
    const size_t bytes_used = sizeof(real) * (alpha.size() + beta.size()
-         + gamma.size());
+         + gamma.size()) + sizeof(float) * (alpha_log.size() + beta_log.size()
+         + gamma_log.size());
    std::cerr << "BCJR Memory Usage: " << bytes_used / double(1 << 20)
          << "MiB" << std::endl;
    // revert cerr to original format
@@ -187,7 +274,7 @@ void bcjr<real, dbl, norm>::allocate()
 template <class real, class dbl, bool norm>
 inline real bcjr<real, dbl, norm>::lambda(const int t, const int m)
    {
-   return alpha(t, m) * beta(t, m);
+   return alpha(t * M + m) * beta(t * M + m);
    }
 
 /*! \brief Transition probability metric
@@ -196,8 +283,9 @@ inline real bcjr<real, dbl, norm>::lambda(const int t, const int m)
 template <class real, class dbl, bool norm>
 inline real bcjr<real, dbl, norm>::sigma(const int t, const int m, const int i)
    {
-   int mdash = lut_m(m, i);
-   return alpha(t - 1, m) * gamma(t - 1, m, i) * beta(t, mdash);
+   const int b = m * K + i;
+   return alpha((t - 1) * M + m) * gamma((t - 1) * M * K + b) * beta(t * M
+         + lut_m(b));
    }
 
 /*!
@@ -211,13 +299,14 @@ inline real bcjr<real, dbl, norm>::sigma(const int t, const int m, const int i)
 template <class real, class dbl, bool norm>
 void bcjr<real, dbl, norm>::work_gamma(const array2d_t& R)
    {
+   const int* X = &lut_X(0);
    for (int t = 1; t <= tau; t++)
-      for (int mdash = 0; mdash < M; mdash++)
-         for (int i = 0; i < K; i++)
-            {
-            int X = lut_X(mdash, i);
-            gamma(t - 1, mdash, i) = real(R(t - 1, X));
-            }
+      {
+      const dbl* Rt = &R(t - 1, 0);
+      real* g = &gamma((t - 1) * M * K);
+      for (int b = 0; b < M * K; b++)
+         g[b] = real(Rt[X[b]]);
+      }
    }
 
 /*!
@@ -234,13 +323,16 @@ void bcjr<real, dbl, norm>::work_gamma(const array2d_t& R)
 template <class real, class dbl, bool norm>
 void bcjr<real, dbl, norm>::work_gamma(const array2d_t& R, const array2d_t& app)
    {
+   const int* X = &lut_X(0);
    for (int t = 1; t <= tau; t++)
-      for (int mdash = 0; mdash < M; mdash++)
-         for (int i = 0; i < K; i++)
-            {
-            int X = lut_X(mdash, i);
-            gamma(t - 1, mdash, i) = real(R(t - 1, X) * app(t - 1, i));
-            }
+      {
+      const dbl* Rt = &R(t - 1, 0);
+      const dbl* appt = &app(t - 1, 0);
+      real* g = &gamma((t - 1) * M * K);
+      for (int mdash = 0, b = 0; mdash < M; mdash++)
+         for (int i = 0; i < K; i++, b++)
+            g[b] = real(Rt[X[b]] * appt[i]);
+      }
    }
 
 /*!
@@ -260,30 +352,34 @@ void bcjr<real, dbl, norm>::work_gamma(const array2d_t& R, const array2d_t& app)
 template <class real, class dbl, bool norm>
 void bcjr<real, dbl, norm>::work_alpha()
    {
+   const int* in_start = &lut_in_start(0);
+   const int* in_b = &lut_in_b(0);
+   const int* in_m = &lut_in_m(0);
    // using the computed gamma values, work out all alpha values at time t
    for (int t = 1; t <= tau; t++)
       {
-      // first initialise the next set of alpha entries
-      for (int m = 0; m < M; m++)
-         alpha(t, m) = 0;
-      // now start computing the summations
+      const real* a0 = &alpha((t - 1) * M);
+      const real* g = &gamma((t - 1) * M * K);
+      real* a1 = &alpha(t * M);
+      // sum over the branches entering each state
       // tail conditions are automatically handled by zeros in the gamma matrix
-      for (int mdash = 0; mdash < M; mdash++)
-         for (int i = 0; i < K; i++)
-            {
-            int m = lut_m(mdash, i);
-            alpha(t, m) += alpha(t - 1, mdash) * gamma(t - 1, mdash, i);
-            }
+      for (int m = 0; m < M; m++)
+         {
+         real a = 0;
+         for (int j = in_start[m]; j < in_start[m + 1]; j++)
+            a += a0[in_m[j]] * g[in_b[j]];
+         a1[m] = a;
+         }
       // normalize
       if (norm)
          {
-         real scale = alpha(t, 0);
+         real scale = a1[0];
          for (int m = 1; m < M; m++)
-            scale += alpha(t, m);
+            scale += a1[m];
          assertalways(scale > real(0));
          scale = real(1) / scale;
          for (int m = 0; m < M; m++)
-            alpha(t, m) *= scale;
+            a1[m] *= scale;
          }
       }
    }
@@ -300,28 +396,30 @@ void bcjr<real, dbl, norm>::work_alpha()
 template <class real, class dbl, bool norm>
 void bcjr<real, dbl, norm>::work_beta()
    {
+   const int* next = &lut_m(0);
    // evaluate all beta values
    for (int t = tau - 1; t >= 0; t--)
       {
-      for (int m = 0; m < M; m++)
+      const real* b1 = &beta((t + 1) * M);
+      const real* g = &gamma(t * M * K);
+      real* b0 = &beta(t * M);
+      for (int m = 0, b = 0; m < M; m++)
          {
-         beta(t, m) = 0;
-         for (int i = 0; i < K; i++)
-            {
-            int mdash = lut_m(m, i);
-            beta(t, m) += beta(t + 1, mdash) * gamma(t, m, i);
-            }
+         real sum = 0;
+         for (int i = 0; i < K; i++, b++)
+            sum += b1[next[b]] * g[b];
+         b0[m] = sum;
          }
       // normalize
       if (norm)
          {
-         real scale = beta(t, 0);
+         real scale = b0[0];
          for (int m = 1; m < M; m++)
-            scale += beta(t, m);
+            scale += b0[m];
          assertalways(scale > real(0));
          scale = real(1) / scale;
          for (int m = 0; m < M; m++)
-            beta(t, m) *= scale;
+            b0[m] *= scale;
          }
       }
    }
@@ -368,7 +466,7 @@ void bcjr<real, dbl, norm>::work_results(array2d_t& ri, array2d_t& ro)
       for (int mdash = 0; mdash < M; mdash++) // for each possible state at time t-1
          for (int i = 0; i < K; i++) // for each possible input, given present state
             {
-            int X = lut_X(mdash, i);
+            int X = lut_X(mdash * K + i);
             dbl delta = dbl(sigma(t, mdash, i) / Py);
             ri(t - 1, i) += delta;
             ro(t - 1, X) += delta;
@@ -407,6 +505,228 @@ void bcjr<real, dbl, norm>::work_results(array2d_t& ri)
          }
    }
 
+// Internal methods - log-domain algorithms
+
+/*!
+ * \brief   Computes the log-domain gamma matrix.
+ * \param   R     R(t-1, X) is the probability of receiving "whatever we
+ * received" at time t, having transmitted X
+ *
+ * This is equivalent to work_gamma(R), with results held as log-values. The
+ * logarithms are taken once per output symbol at each timestep, rather than
+ * once per trellis branch.
+ */
+template <class real, class dbl, bool norm>
+void bcjr<real, dbl, norm>::work_gamma_log(const array2d_t& R)
+   {
+   logR.init(N);
+   for (int t = 1; t <= tau; t++)
+      {
+      for (int X = 0; X < N; X++)
+         logR(X) = float(log(double(R(t - 1, X))));
+      float* g = &gamma_log((t - 1) * M * K);
+      for (int b = 0; b < M * K; b++)
+         g[b] = logR(lut_X(b));
+      }
+   }
+
+/*!
+ * \brief   Computes the log-domain gamma matrix.
+ * \param   R     R(t-1, X) is the probability of receiving "whatever we
+ * received" at time t, having transmitted X
+ * \param   app   app(t-1, i) is the 'a priori' probability of having
+ * transmitted (input value) i at time t
+ *
+ * This is equivalent to work_gamma(R, app), with results held as log-values.
+ */
+template <class real, class dbl, bool norm>
+void bcjr<real, dbl, norm>::work_gamma_log(const array2d_t& R,
+      const array2d_t& app)
+   {
+   logR.init(N);
+   logapp.init(K);
+   for (int t = 1; t <= tau; t++)
+      {
+      for (int X = 0; X < N; X++)
+         logR(X) = float(log(double(R(t - 1, X))));
+      for (int i = 0; i < K; i++)
+         logapp(i) = float(log(double(app(t - 1, i))));
+      float* g = &gamma_log((t - 1) * M * K);
+      for (int mdash = 0, b = 0; mdash < M; mdash++)
+         for (int i = 0; i < K; i++, b++)
+            g[b] = logR(lut_X(b)) + logapp(i);
+      }
+   }
+
+/*!
+ * \brief   Computes the log-domain alpha matrix.
+ *
+ * This follows work_alpha(), with products replaced by sums and sums
+ * replaced by the combining operator of the given policy. Metrics are
+ * always normalized, by subtracting the largest value at each timestep, so
+ * that they stay within the accurate range of 'float'.
+ */
+template <class real, class dbl, bool norm>
+template <class policy>
+void bcjr<real, dbl, norm>::work_alpha_log()
+   {
+   const int* in_start = &lut_in_start(0);
+   const int* in_b = &lut_in_b(0);
+   const int* in_m = &lut_in_m(0);
+   for (int t = 1; t <= tau; t++)
+      {
+      const float* a0 = &alpha_log((t - 1) * M);
+      const float* g = &gamma_log((t - 1) * M * K);
+      float* a1 = &alpha_log(t * M);
+      // combine over the branches entering each state
+      // tail conditions are automatically handled by -inf in the gamma matrix
+      for (int m = 0; m < M; m++)
+         {
+         float a = -std::numeric_limits<float>::infinity();
+         for (int j = in_start[m]; j < in_start[m + 1]; j++)
+            a = policy::combine(a, a0[in_m[j]] + g[in_b[j]]);
+         a1[m] = a;
+         }
+      // normalize
+      float scale = a1[0];
+      for (int m = 1; m < M; m++)
+         scale = std::max(scale, a1[m]);
+      assertalways(scale > -std::numeric_limits<float>::infinity());
+      for (int m = 0; m < M; m++)
+         a1[m] -= scale;
+      }
+   }
+
+/*!
+ * \brief   Computes the log-domain beta matrix.
+ *
+ * \sa See notes for work_alpha_log()
+ */
+template <class real, class dbl, bool norm>
+template <class policy>
+void bcjr<real, dbl, norm>::work_beta_log()
+   {
+   const int* next = &lut_m(0);
+   for (int t = tau - 1; t >= 0; t--)
+      {
+      const float* b1 = &beta_log((t + 1) * M);
+      const float* g = &gamma_log(t * M * K);
+      float* b0 = &beta_log(t * M);
+      for (int m = 0, b = 0; m < M; m++)
+         {
+         float sum = -std::numeric_limits<float>::infinity();
+         for (int i = 0; i < K; i++, b++)
+            sum = policy::combine(sum, b1[next[b]] + g[b]);
+         b0[m] = sum;
+         }
+      // normalize
+      float scale = b0[0];
+      for (int m = 1; m < M; m++)
+         scale = std::max(scale, b0[m]);
+      assertalways(scale > -std::numeric_limits<float>::infinity());
+      for (int m = 0; m < M; m++)
+         b0[m] -= scale;
+      }
+   }
+
+/*!
+ * \brief   Computes the final results for the log-domain algorithms.
+ * \param   ri    ri(t-1, i) is the probability that we transmitted
+ * (input value) i at time t
+ * \param   ro    ro(t-1, X) is the probability that we transmitted
+ * (output value) X at time t
+ *
+ * The log-domain transition metrics are combined over all transitions with
+ * the same input (or output) symbol, then converted back to probabilities,
+ * normalized at each timestep.
+ */
+template <class real, class dbl, bool norm>
+template <class policy>
+void bcjr<real, dbl, norm>::work_results_log(array2d_t& ri, array2d_t& ro)
+   {
+   // Initialize results vectors
+   ri.init(tau, K);
+   ro.init(tau, N);
+   // Space for log-domain results at one timestep
+   li.init(K);
+   lo.init(N);
+   pi.init(K);
+   po.init(N);
+   // Work out final results
+   for (int t = 1; t <= tau; t++)
+      {
+      const float* a0 = &alpha_log((t - 1) * M);
+      const float* g = &gamma_log((t - 1) * M * K);
+      const float* b1 = &beta_log(t * M);
+      li = -std::numeric_limits<float>::infinity();
+      lo = -std::numeric_limits<float>::infinity();
+      for (int mdash = 0, b = 0; mdash < M; mdash++) // for each possible state at time t-1
+         for (int i = 0; i < K; i++, b++) // for each possible input, given present state
+            {
+            const int X = lut_X(b);
+            const float delta = a0[mdash] + g[b] + b1[lut_m(b)];
+            li(i) = policy::combine(li(i), delta);
+            lo(X) = policy::combine(lo(X), delta);
+            }
+      work_exp(li, pi);
+      work_exp(lo, po);
+      ri.insertrow(pi, t - 1);
+      ro.insertrow(po, t - 1);
+      }
+   }
+
+/*!
+ * \brief   Computes the final results for the log-domain algorithms (input
+ * only).
+ * \param   ri    ri(t-1, i) is the probability that we transmitted
+ * (input value) i at time t
+ *
+ * \sa See notes for work_results_log(ri, ro)
+ */
+template <class real, class dbl, bool norm>
+template <class policy>
+void bcjr<real, dbl, norm>::work_results_log(array2d_t& ri)
+   {
+   // Initialize results vector
+   ri.init(tau, K);
+   // Space for log-domain results at one timestep
+   li.init(K);
+   pi.init(K);
+   // Work out final results
+   for (int t = 1; t <= tau; t++)
+      {
+      const float* a0 = &alpha_log((t - 1) * M);
+      const float* g = &gamma_log((t - 1) * M * K);
+      const float* b1 = &beta_log(t * M);
+      li = -std::numeric_limits<float>::infinity();
+      for (int mdash = 0, b = 0; mdash < M; mdash++) // for each possible state at time t-1
+         for (int i = 0; i < K; i++, b++) // for each possible input, given present state
+            {
+            const float delta = a0[mdash] + g[b] + b1[lut_m(b)];
+            li(i) = policy::combine(li(i), delta);
+            }
+      work_exp(li, pi);
+      ri.insertrow(pi, t - 1);
+      }
+   }
+
+/*!
+ * \brief   Converts a vector of log-domain metrics to probabilities.
+ * \param   x     Log-domain metrics, up to an additive constant
+ * \param   r     Corresponding probabilities, normalized to sum to one
+ */
+template <class real, class dbl, bool norm>
+void bcjr<real, dbl, norm>::work_exp(const array1f_t& x, array1d_t& r)
+   {
+   const float scale = x.max();
+   assertalways(scale > -std::numeric_limits<float>::infinity());
+   double sum = 0;
+   for (int i = 0; i < x.size(); i++)
+      sum += exp(double(x(i) - scale));
+   for (int i = 0; i < x.size(); i++)
+      r(i) = dbl(exp(double(x(i) - scale)) / sum);
+   }
+
 // Internal helper functions
 
 /*!
@@ -438,6 +758,29 @@ void bcjr<real, dbl, norm>::normalize(array2d_t& r)
       }
    }
 
+// Description
+
+/*!
+ * \brief   Short description of the decoding algorithm in use
+ */
+template <class real, class dbl, bool norm>
+std::string bcjr<real, dbl, norm>::algorithm_description() const
+   {
+   switch (algorithm)
+      {
+      case algorithm_map:
+         return "MAP";
+      case algorithm_maxlogmap:
+         return "Max-Log-MAP";
+      case algorithm_logmap:
+         return "Log-MAP";
+      default:
+         failwith("Unknown decoding algorithm");
+         break;
+      }
+   return "";
+   }
+
 // User procedures
 
 /*!
@@ -454,10 +797,30 @@ void bcjr<real, dbl, norm>::decode(const array2d_t& R, array2d_t& ri,
       array2d_t& ro)
    {
    assert(initialised);
-   work_gamma(R);
-   work_alpha();
-   work_beta();
-   work_results(ri, ro);
+   switch (algorithm)
+      {
+      case algorithm_map:
+         work_gamma(R);
+         work_alpha();
+         work_beta();
+         work_results(ri, ro);
+         break;
+      case algorithm_maxlogmap:
+         work_gamma_log(R);
+         work_alpha_log<bcjr_maxlogmap> ();
+         work_beta_log<bcjr_maxlogmap> ();
+         work_results_log<bcjr_maxlogmap> (ri, ro);
+         break;
+      case algorithm_logmap:
+         work_gamma_log(R);
+         work_alpha_log<bcjr_logmap> ();
+         work_beta_log<bcjr_logmap> ();
+         work_results_log<bcjr_logmap> (ri, ro);
+         break;
+      default:
+         failwith("Unknown decoding algorithm");
+         break;
+      }
    }
 
 /*!
@@ -479,10 +842,30 @@ void bcjr<real, dbl, norm>::decode(const array2d_t& R, const array2d_t& app,
       array2d_t& ri, array2d_t& ro)
    {
    assert(initialised);
-   work_gamma(R, app);
-   work_alpha();
-   work_beta();
-   work_results(ri, ro);
+   switch (algorithm)
+      {
+      case algorithm_map:
+         work_gamma(R, app);
+         work_alpha();
+         work_beta();
+         work_results(ri, ro);
+         break;
+      case algorithm_maxlogmap:
+         work_gamma_log(R, app);
+         work_alpha_log<bcjr_maxlogmap> ();
+         work_beta_log<bcjr_maxlogmap> ();
+         work_results_log<bcjr_maxlogmap> (ri, ro);
+         break;
+      case algorithm_logmap:
+         work_gamma_log(R, app);
+         work_alpha_log<bcjr_logmap> ();
+         work_beta_log<bcjr_logmap> ();
+         work_results_log<bcjr_logmap> (ri, ro);
+         break;
+      default:
+         failwith("Unknown decoding algorithm");
+         break;
+      }
    }
 
 /*!
@@ -499,10 +882,30 @@ template <class real, class dbl, bool norm>
 void bcjr<real, dbl, norm>::fdecode(const array2d_t& R, array2d_t& ri)
    {
    assert(initialised);
-   work_gamma(R);
-   work_alpha();
-   work_beta();
-   work_results(ri);
+   switch (algorithm)
+      {
+      case algorithm_map:
+         work_gamma(R);
+         work_alpha();
+         work_beta();
+         work_results(ri);
+         break;
+      case algorithm_maxlogmap:
+         work_gamma_log(R);
+         work_alpha_log<bcjr_maxlogmap> ();
+         work_beta_log<bcjr_maxlogmap> ();
+         work_results_log<bcjr_maxlogmap> (ri);
+         break;
+      case algorithm_logmap:
+         work_gamma_log(R);
+         work_alpha_log<bcjr_logmap> ();
+         work_beta_log<bcjr_logmap> ();
+         work_results_log<bcjr_logmap> (ri);
+         break;
+      default:
+         failwith("Unknown decoding algorithm");
+         break;
+      }
    }
 
 /*!
@@ -519,10 +922,30 @@ void bcjr<real, dbl, norm>::fdecode(const array2d_t& R, const array2d_t& app,
       array2d_t& ri)
    {
    assert(initialised);
-   work_gamma(R, app);
-   work_alpha();
-   work_beta();
-   work_results(ri);
+   switch (algorithm)
+      {
+      case algorithm_map:
+         work_gamma(R, app);
+         work_alpha();
+         work_beta();
+         work_results(ri);
+         break;
+      case algorithm_maxlogmap:
+         work_gamma_log(R, app);
+         work_alpha_log<bcjr_maxlogmap> ();
+         work_beta_log<bcjr_maxlogmap> ();
+         work_results_log<bcjr_maxlogmap> (ri);
+         break;
+      case algorithm_logmap:
+         work_gamma_log(R, app);
+         work_alpha_log<bcjr_logmap> ();
+         work_beta_log<bcjr_logmap> ();
+         work_results_log<bcjr_logmap> (ri);
+         break;
+      default:
+         failwith("Unknown decoding algorithm");
+         break;
+      }
    }
 
 } // end namespace
@@ -531,6 +954,7 @@ void bcjr<real, dbl, norm>::fdecode(const array2d_t& R, const array2d_t& app,
 #include "mpgnu.h"
 #include "logreal.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -543,13 +967,15 @@ using libbase::mpreal;
 using libbase::mpgnu;
 using libbase::logreal;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define TF_SEQ \
    (false)(true)
 #define REAL1_TYPE_SEQ \
    (float)(double) \
    (mpreal)(mpgnu) \
-   (logreal)(logrealfast)
+   (logreal)(logrealfast) \
+   (logrealsimd)
 #define REAL2_TYPE_SEQ \
    (float)(double) \
    (logrealfast)
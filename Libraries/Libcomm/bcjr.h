@@ -33,6 +33,7 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <string>
 
 namespace libcomm {
 
@@ -59,15 +60,77 @@ namespace libcomm {
  *
  * \warning
  * - Static memory requirements:
- * sizeof(real)*(2*(tau+1)*M + tau*M*K + K + N) + sizeof(int)*(2*K+1)*M
+ * sizeof(real)*(2*(tau+1)*M + tau*M*K + K + N) + sizeof(int)*(4*K*M+M+1)
  * - Dynamic memory requirements:
  * none
  *
  * \note Memory is only allocated in the first call to "decode". This is more
  * efficient for the parallel simulator strategy with a master which only
  * collects results.
+ *
+ * \note Besides the exact MAP algorithm, the decoder can use the Max-Log-MAP
+ * and Log-MAP approximations, selected at run-time by set_algorithm(). These
+ * work on log-domain metrics held as 'float', with recursions using only
+ * addition and the max (or max*) operator; the recursion kernels are
+ * parameterized by the policy classes bcjr_maxlogmap and bcjr_logmap. In
+ * these modes the matrices over 'real' are not allocated, and the memory
+ * requirement becomes sizeof(float)*(2*(tau+1)*M + tau*M*K).
+ *
+ * \note The trellis is flattened at initialization into next-state and
+ * output tables indexed by branch (m*K+i), together with the list of
+ * branches entering each state. Working metrics are held in contiguous
+ * arrays, one row of M (or M*K) entries per timestep, so that the recursions
+ * run over plain pointers; the forward recursion gathers over the branches
+ * entering each state rather than scattering over the branches leaving it.
+ * Contributions are accumulated in the same order as a scatter over
+ * (m',i), so results are unchanged.
+ */
+
+/*!
+ * \brief   BCJR recursion policy - Max-Log-MAP.
+ * \author  Johann Briffa
+ *
+ * Metrics are log-probabilities; the sum of two probabilities is
+ * approximated by the larger of the two.
+ */
+
+class bcjr_maxlogmap {
+public:
+   //! Log-domain equivalent of addition
+   static float combine(const float a, const float b)
+      {
+      return a > b ? a : b;
+      }
+};
+
+/*!
+ * \brief   BCJR recursion policy - Log-MAP with correction table.
+ * \author  Johann Briffa
+ *
+ * Metrics are log-probabilities; the sum of two probabilities is computed
+ * with the Jacobian logarithm (max* operator):
+ *      log(a + b) = max(log(a), log(b)) + log(1 + exp(-|log(a) - log(b)|))
+ * where the correction term is read from a small table, as is usually done
+ * in hardware implementations. The table has 8 entries with a step of 0.5;
+ * beyond that range the correction is taken to be zero.
  */
 
+class bcjr_logmap {
+private:
+   static const int lutsize = 8;
+   static const float lutinvstep;
+   static const float lut[lutsize];
+public:
+   //! Log-domain equivalent of addition
+   static float combine(const float a, const float b)
+      {
+      const float x = fabs(a - b) * lutinvstep;
+      // a NaN difference (i.e. both values are -inf) fails the range test
+      const float correction = x < lutsize ? lut[int(x)] : 0;
+      return (a > b ? a : b) + correction;
+      }
+};
+
 template <class real, class dbl = double, bool norm = false>
 class bcjr {
 public:
@@ -76,8 +139,14 @@ public:
    typedef libbase::matrix<int> array2i_t;
    typedef libbase::vector<dbl> array1d_t;
    typedef libbase::matrix<dbl> array2d_t;
-   typedef libbase::matrix<real> array2r_t;
-   typedef libbase::matrix3<real> array3r_t;
+   typedef libbase::vector<real> array1r_t;
+   typedef libbase::vector<float> array1f_t;
+   enum algorithm_t {
+      algorithm_map = 0, //!< Exact MAP, over type 'real'
+      algorithm_maxlogmap, //!< Max-Log-MAP, over log-domain floats
+      algorithm_logmap, //!< Log-MAP with correction table, over log-domain floats
+      algorithm_undefined
+   };
    // @}
 private:
    /*! \name Internal variables */
@@ -85,21 +154,44 @@ private:
    int K; //!< Input alphabet size
    int N; //!< Output alphabet size
    int M; //!< Number of encoder states
+   algorithm_t algorithm; //!< Decoding algorithm in use
    bool initialised; //!< Flag to indicate when memory is allocated
    // @}
-   /*! \name Working matrices */
-   //! Forward recursion metric: alpha(t,m) = Pr{S(t)=m, Y(1..t)}
-   array2r_t alpha;
-   //! Backward recursion metric: beta(t,m) = Pr{Y(t+1..tau) | S(t)=m}
-   array2r_t beta;
-   //! Receiver metric: gamma(t-1,m',i) = Pr{S(t)=m(m',i), Y(t) | S(t-1)=m'}
-   array3r_t gamma;
+   /*! \name Working matrices (contiguous, one row per timestep) */
+   //! Forward recursion metric: alpha(t,m) = Pr{S(t)=m, Y(1..t)}, at [t*M+m]
+   array1r_t alpha;
+   //! Backward recursion metric: beta(t,m) = Pr{Y(t+1..tau) | S(t)=m}, at [t*M+m]
+   array1r_t beta;
+   //! Receiver metric: gamma(t-1,m',i) = Pr{S(t)=m(m',i), Y(t) | S(t-1)=m'}, at [((t-1)*M+m')*K+i]
+   array1r_t gamma;
    // @}
-   /*! \name Temporary (cache) matrices */
-   //! lut_X(m,i) = encoder output, given state 'm' and input 'i'
-   array2i_t lut_X;
-   //! lut_m(m,i) = next state, given state 'm' and input 'i'
-   array2i_t lut_m;
+   /*! \name Working matrices - log-domain algorithms */
+   //! Forward recursion metric: alpha_log(t,m) = log alpha(t,m) + constant
+   array1f_t alpha_log;
+   //! Backward recursion metric: beta_log(t,m) = log beta(t,m) + constant
+   array1f_t beta_log;
+   //! Receiver metric: gamma_log(t-1,m',i) = log gamma(t-1,m',i)
+   array1f_t gamma_log;
+   // @}
+   /*! \name Flattened trellis tables (indexed by branch b = m*K+i) */
+   //! lut_X(b) = encoder output, given state 'm' and input 'i'
+   array1i_t lut_X;
+   //! lut_m(b) = next state, given state 'm' and input 'i'
+   array1i_t lut_m;
+   //! Branches entering state m are lut_in_b(j) for lut_in_start(m) <= j < lut_in_start(m+1)
+   array1i_t lut_in_start;
+   //! lut_in_b(j) = branch index of j-th incoming branch, ordered by (m',i)
+   array1i_t lut_in_b;
+   //! lut_in_m(j) = originating state of j-th incoming branch
+   array1i_t lut_in_m;
+   // @}
+   /*! \name Per-timestep workspace - log-domain algorithms */
+   array1f_t logR; //!< Log-domain receiver statistics
+   array1f_t logapp; //!< Log-domain prior statistics
+   array1f_t li; //!< Log-domain input posteriors
+   array1f_t lo; //!< Log-domain output posteriors
+   array1d_t pi; //!< Input posteriors
+   array1d_t po; //!< Output posteriors
    // @}
 private:
    /*! \name Internal methods */
@@ -112,6 +204,17 @@ private:
    void work_beta();
    void work_results(array2d_t& ri, array2d_t& ro);
    void work_results(array2d_t& ri);
+   void work_gamma_log(const array2d_t& R);
+   void work_gamma_log(const array2d_t& R, const array2d_t& app);
+   template <class policy>
+   void work_alpha_log();
+   template <class policy>
+   void work_beta_log();
+   template <class policy>
+   void work_results_log(array2d_t& ri, array2d_t& ro);
+   template <class policy>
+   void work_results_log(array2d_t& ri);
+   static void work_exp(const array1f_t& x, array1d_t& r);
    // @}
 protected:
    // normalization function for derived classes
@@ -130,14 +233,23 @@ protected:
    // set start- and end-state probabilities - direct
    void setstart(const array1d_t& p);
    void setend(const array1d_t& p);
+   // select the decoding algorithm
+   void set_algorithm(const algorithm_t algorithm)
+      {
+      assertalways(algorithm >= algorithm_map && algorithm < algorithm_undefined);
+      bcjr::algorithm = algorithm;
+      initialised = false;
+      }
    // default constructor
-   bcjr()
+   bcjr() :
+         algorithm(algorithm_map)
       {
       initialised = false;
       }
 public:
    /*! \name Constructor & destructor */
-   bcjr(fsm& encoder, const int tau)
+   bcjr(fsm& encoder, const int tau) :
+         algorithm(algorithm_map)
       {
       init(encoder, tau);
       }
@@ -172,6 +284,13 @@ public:
       {
       return libbase::size_type<libbase::vector>(tau);
       }
+   //! Decoding algorithm in use
+   algorithm_t get_algorithm() const
+      {
+      return algorithm;
+      }
+   //! Short description of the decoding algorithm in use
+   std::string algorithm_description() const;
    // @}
 };
 
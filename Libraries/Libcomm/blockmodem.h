@@ -25,6 +25,7 @@
 #include "modem.h"
 #include "vector.h"
 #include "matrix.h"
+#include "probtable.h"
 #include "channel.h"
 #include "blockprocess.h"
 #include "instrumented.h"
@@ -47,12 +48,16 @@ class basic_blockmodem : public instrumented,
 public:
    /*! \name Type definitions */
    typedef libbase::vector<dbl> array1d_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 
 private:
    /*! \name User-defined parameters */
    libbase::size_type<C> size; //!< Input block size in symbols
    // @}
+   /*! \name Internal workspace */
+   C<array1d_t> ptable_legacy; //!< Table for demodulators without flat output
+   // @}
 
 protected:
    /*! \name Interface with derived classes */
@@ -70,6 +75,39 @@ protected:
    //! \copydoc demodulate()
    virtual void dodemodulate(const channel<S, C>& chan, const C<S>& rx, C<
          array1d_t>& ptable) = 0;
+   /*!
+    * \copydoc demodulate()
+    *
+    * Default implementation demodulates into a table of vectors and converts
+    * the result; derived classes should override this where the flat table
+    * can be filled directly.
+    */
+   virtual void dodemodulate(const channel<S, C>& chan, const C<S>& rx,
+         probtable_t& ptable)
+      {
+      dodemodulate(chan, rx, ptable_legacy);
+      ptable.copyfrom(ptable_legacy);
+      }
+   /*!
+    * \copydoc demodulate_batch()
+    *
+    * Default implementation demodulates each frame in turn, advancing
+    * between frames as for separate calls to demodulate(); derived classes
+    * should override this where set-up can be shared across frames.
+    */
+   virtual void dodemodulate_batch(const channel<S, C>& chan,
+         const libbase::vector<C<S> >& rx,
+         libbase::vector<C<array1d_t> >& ptable)
+      {
+      const int K = rx.size();
+      ptable.init(K);
+      for (int k = 0; k < K; k++)
+         {
+         advance_if_dirty();
+         dodemodulate(chan, rx(k), ptable(k));
+         mark_as_dirty();
+         }
+      }
    // @}
 
 public:
@@ -128,6 +166,43 @@ public:
       mark_as_dirty();
       add_timer(t);
       }
+   /*!
+    * \brief Demodulate a sequence of time-steps into a flat table
+    * \param[in]  chan     The channel model (used to obtain likelihoods)
+    * \param[in]  rx       Sequence of received symbols
+    * \param[out] ptable   Table of likelihoods of possible transmitted symbols
+    *
+    * \note \c ptable(i,d) \c is the a posteriori probability of having
+    * transmitted symbol 'd' at time 'i'
+    */
+   void demodulate(const channel<S, C>& chan, const C<S>& rx,
+         probtable_t& ptable)
+      {
+      test_invariant();
+      libbase::cputimer t("t_demodulate");
+      advance_if_dirty();
+      dodemodulate(chan, rx, ptable);
+      mark_as_dirty();
+      add_timer(t);
+      }
+   /*!
+    * \brief Demodulate a batch of frames
+    * \param[in]  chan     The channel model (used to obtain likelihoods)
+    * \param[in]  rx       Set of received frames
+    * \param[out] ptable   Set of likelihood tables, one per frame
+    *
+    * Results are identical to separate calls to demodulate() for each frame
+    * in sequence; the system is advanced between frames in the same way.
+    */
+   void demodulate_batch(const channel<S, C>& chan,
+         const libbase::vector<C<S> >& rx,
+         libbase::vector<C<array1d_t> >& ptable)
+      {
+      test_invariant();
+      libbase::cputimer t("t_demodulate");
+      dodemodulate_batch(chan, rx, ptable);
+      add_timer(t);
+      }
    // @}
 
    /*! \name Setup functions */
@@ -28,9 +28,10 @@
 #include "vector.h"
 #include "matrix.h"
 #include "vectorutils.h"
+#include "probtable.h"
 #include "instrumented.h"
 
-#include "randgen.h"
+#include "philox.h"
 #include "sigspace.h"
 
 #include <iostream>
@@ -64,7 +65,7 @@ public:
    // @}
 protected:
    /*! \name Derived channel representation */
-   libbase::randgen r;
+   libbase::philox r; //!< Counter-based generator for channel events
    // @}
 protected:
    /*! \name Channel function overrides */
@@ -199,6 +200,12 @@ class basic_channel : public basic_channel_interface<S, C> {
  * \author  Johann Briffa
  *
  * Templated common channel base. Partial specialization for vector container.
+ *
+ * The block transmit() and receive() functions here are implemented in terms
+ * of corrupt() and pdf(), at the cost of a virtual call per symbol (or per
+ * symbol pair). Memoryless channels may override them to work on the whole
+ * sequence directly; such overrides must draw random values in the same
+ * order as corrupt(), so that received sequences are unchanged.
  */
 
 template <class S>
@@ -210,11 +217,25 @@ public:
    typedef libbase::vector<array1s_t> array1vs_t;
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<double> probtable_t;
    // @}
 public:
    void transmit(const array1s_t& tx, array1s_t& rx);
    void
    receive(const array1s_t& tx, const array1s_t& rx, array1vd_t& ptable) const;
+   /*!
+    * \brief Determine the per-symbol likelihoods of a sequence of received
+    * modulation symbols, into a flat table
+    * \param[in]  tx       Set of possible transmitted symbols
+    * \param[in]  rx       Received sequence of modulation symbols
+    * \param[out] ptable   Likelihoods corresponding to each possible
+    * transmitted symbol
+    *
+    * Default implementation is suitable for substitution channels, and
+    * performs channel-specific operation through the pdf() override.
+    */
+   virtual void
+   receive(const array1s_t& tx, const array1s_t& rx, probtable_t& ptable) const;
    void
    receive(const array1vs_t& tx, const array1s_t& rx, array1vd_t& ptable) const;
    double receive(const array1s_t& tx, const array1s_t& rx) const;
@@ -249,6 +270,24 @@ void basic_channel<S, libbase::vector>::receive(const array1s_t& tx,
          ptable(t)(x) = this->pdf(tx(x), rx(t));
    }
 
+template <class S>
+void basic_channel<S, libbase::vector>::receive(const array1s_t& tx,
+      const array1s_t& rx, probtable_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results table
+   ptable.init(tau, M);
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      double *p = ptable.row(t);
+      for (int x = 0; x < M; x++)
+         p[x] = this->pdf(tx(x), rx(t));
+      }
+   }
+
 template <class S>
 void basic_channel<S, libbase::vector>::receive(const array1vs_t& tx,
       const array1s_t& rx, array1vd_t& ptable) const
@@ -48,6 +48,120 @@ double awgn::pdf(const sigspace& tx, const sigspace& rx) const
    return gauss(n.i() / sigma) * gauss(n.q() / sigma);
    }
 
+// channel functions
+
+void awgn::transmit(const array1s_t& tx, array1s_t& rx)
+   {
+   const int tau = tx.size();
+   // Initialize results vector (this is safe if tx and rx are the same)
+   rx.init(tau);
+   // Generate noise in a single block, in the same sequence as corrupt()
+   noise.init(2 * tau);
+   r.fill_gval(noise, sigma);
+   for (int i = 0; i < tau; i++)
+      rx(i) = tx(i) + sigspace(noise(2 * i), noise(2 * i + 1));
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Gaussian densities is computed
+ * with a single exponential per table entry.
+ */
+void awgn::receive(const array1s_t& tx, const array1s_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Constants for the two-dimensional Gaussian density
+   const double k = 1 / (2 * libbase::PI);
+   const double c = -0.5 / (sigma * sigma);
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - tx(x).i();
+         const double dq = rq - tx(x).q();
+         p(x) = k * exp(c * (di * di + dq * dq));
+         }
+      }
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Gaussian densities is computed
+ * with a single exponential per table entry.
+ */
+void awgn::receive(const array1s_t& tx, const array1s_t& rx,
+      probtable_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results table
+   ptable.init(tau, M);
+   // Constants for the two-dimensional Gaussian density
+   const double k = 1 / (2 * libbase::PI);
+   const double c = -0.5 / (sigma * sigma);
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      double *p = ptable.row(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - tx(x).i();
+         const double dq = rq - tx(x).q();
+         p[x] = k * exp(c * (di * di + dq * dq));
+         }
+      }
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Gaussian densities is computed
+ * with a single exponential per table entry.
+ */
+void awgn::receive(const array1vs_t& tx, const array1s_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   assert(tx.size() == tau);
+   assert(tau > 0);
+   const int M = tx(0).size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Constants for the two-dimensional Gaussian density
+   const double k = 1 / (2 * libbase::PI);
+   const double c = -0.5 / (sigma * sigma);
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      assert(tx(t).size() == M);
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      const array1s_t& s = tx(t);
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - s(x).i();
+         const double dq = rq - s(x).q();
+         p(x) = k * exp(c * (di * di + dq * dq));
+         }
+      }
+   }
+
 // Description
 
 std::string awgn::description() const
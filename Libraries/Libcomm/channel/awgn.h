@@ -70,11 +70,16 @@ namespace libcomm {
  *
  * \version 1.54 (24 Jan 2008)
  * - Changed derivation from channel to channel<sigspace>
+ *
+ * The block receive functions compute the two-dimensional Gaussian density
+ * with a single exponential per table entry.
  */
 
 class awgn : public channel<sigspace> {
    // channel paremeters
    double sigma;
+   // internal workspace
+   libbase::vector<double> noise;
 protected:
    // handle functions
    void compute_parameters(const double Eb, const double No);
@@ -82,6 +87,16 @@ protected:
    sigspace corrupt(const sigspace& s);
    double pdf(const sigspace& tx, const sigspace& rx) const;
 public:
+   // Channel functions
+   void transmit(const array1s_t& tx, array1s_t& rx);
+   using channel<sigspace>::receive;
+   void receive(const array1s_t& tx, const array1s_t& rx,
+         array1vd_t& ptable) const;
+   void receive(const array1s_t& tx, const array1s_t& rx,
+         probtable_t& ptable) const;
+   void receive(const array1vs_t& tx, const array1s_t& rx,
+         array1vd_t& ptable) const;
+
    // Description
    std::string description() const;
 
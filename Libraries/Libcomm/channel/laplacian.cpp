@@ -41,6 +41,126 @@ std::istream& laplacian<S, C>::serialize(std::istream& sin)
 
 // *** sigspace partial specialization ***
 
+// channel functions
+
+template <template <class > class C>
+void laplacian<sigspace, C>::transmit(const array1s_t& tx, array1s_t& rx)
+   {
+   const int tau = tx.size();
+   // Initialize results vector (this is safe if tx and rx are the same)
+   rx.init(tau);
+   // Add noise, in the same sequence as corrupt()
+   for (int i = 0; i < tau; i++)
+      {
+      const double x = Base::Finv(Base::r.fval_closed());
+      const double y = Base::Finv(Base::r.fval_closed());
+      rx(i) = tx(i) + sigspace(x, y);
+      }
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Laplacian densities is computed
+ * with a single exponential per table entry.
+ */
+template <template <class > class C>
+void laplacian<sigspace, C>::receive(const array1s_t& tx, const array1s_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Constants for the two-dimensional Laplacian density
+   const double k = 1 / (4 * Base::lambda * Base::lambda);
+   const double c = -1 / Base::lambda;
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - tx(x).i();
+         const double dq = rq - tx(x).q();
+         p(x) = k * exp(c * (fabs(di) + fabs(dq)));
+         }
+      }
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Laplacian densities is computed
+ * with a single exponential per table entry.
+ */
+template <template <class > class C>
+void laplacian<sigspace, C>::receive(const array1s_t& tx, const array1s_t& rx,
+      probtable_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results table
+   ptable.init(tau, M);
+   // Constants for the two-dimensional Laplacian density
+   const double k = 1 / (4 * Base::lambda * Base::lambda);
+   const double c = -1 / Base::lambda;
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      double *p = ptable.row(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - tx(x).i();
+         const double dq = rq - tx(x).q();
+         p[x] = k * exp(c * (fabs(di) + fabs(dq)));
+         }
+      }
+   }
+
+/*!
+ * \copydoc basic_channel::receive()
+ *
+ * The product of the in-phase and quadrature Laplacian densities is computed
+ * with a single exponential per table entry.
+ */
+template <template <class > class C>
+void laplacian<sigspace, C>::receive(const array1vs_t& tx,
+      const array1s_t& rx, array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   assert(tx.size() == tau);
+   assert(tau > 0);
+   const int M = tx(0).size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Constants for the two-dimensional Laplacian density
+   const double k = 1 / (4 * Base::lambda * Base::lambda);
+   const double c = -1 / Base::lambda;
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      assert(tx(t).size() == M);
+      const double ri = rx(t).i();
+      const double rq = rx(t).q();
+      const array1s_t& s = tx(t);
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         {
+         const double di = ri - s(x).i();
+         const double dq = rq - s(x).q();
+         p(x) = k * exp(c * (fabs(di) + fabs(dq)));
+         }
+      }
+   }
+
 // object serialization
 
 template <template <class > class C>
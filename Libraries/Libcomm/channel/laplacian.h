@@ -102,10 +102,22 @@ DECLARE_SERIALIZER(laplacian)
 /*!
  * \brief   Signal-Space Additive Laplacian Noise Channel.
  * \author  Johann Briffa
+ *
+ * For the vector container, the block receive functions compute the
+ * two-dimensional Laplacian density with a single exponential per table
+ * entry.
  */
 
 template <template <class > class C>
 class laplacian<sigspace, C> : public basic_laplacian<sigspace, C> {
+public:
+   /*! \name Type definitions */
+   typedef libbase::vector<sigspace> array1s_t;
+   typedef libbase::vector<array1s_t> array1vs_t;
+   typedef libbase::vector<double> array1d_t;
+   typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<double> probtable_t;
+   // @}
 private:
    // Shorthand for class hierarchy
    typedef basic_laplacian<sigspace, C> Base;
@@ -129,6 +141,17 @@ protected:
       return Base::f(n.i()) * Base::f(n.q());
       }
 public:
+   // Channel functions
+   using Base::transmit;
+   void transmit(const array1s_t& tx, array1s_t& rx);
+   using Base::receive;
+   void receive(const array1s_t& tx, const array1s_t& rx,
+         array1vd_t& ptable) const;
+   void receive(const array1s_t& tx, const array1s_t& rx,
+         probtable_t& ptable) const;
+   void receive(const array1vs_t& tx, const array1s_t& rx,
+         array1vd_t& ptable) const;
+
    // Serialization Support
 DECLARE_SERIALIZER(laplacian)
 };
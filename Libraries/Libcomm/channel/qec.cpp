@@ -54,6 +54,100 @@ G qec<G>::corrupt(const G& s)
    return rx;
    }
 
+// Channel functions
+
+template <class G>
+void qec<G>::transmit(const array1g_t& tx, array1g_t& rx)
+   {
+   const int tau = tx.size();
+   // Initialize results vector (this is safe if tx and rx are the same)
+   rx.init(tau);
+   // Erase the modulation symbols, in the same sequence as corrupt()
+   for (int i = 0; i < tau; i++)
+      {
+      const double p = this->r.fval_closed();
+      rx(i) = tx(i);
+      if (p < Pe)
+         rx(i).erase();
+      }
+   }
+
+template <class G>
+void qec<G>::receive(const array1g_t& tx, const array1g_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Erased symbols are equally likely to be any of the alphabet
+   const double p_erased = 1.0 / G::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const G& s = rx(t);
+      array1d_t& p = ptable(t);
+      if (s.is_erased())
+         p = p_erased;
+      else
+         for (int x = 0; x < M; x++)
+            p(x) = (tx(x) == s) ? 1 : 0;
+      }
+   }
+
+template <class G>
+void qec<G>::receive(const array1g_t& tx, const array1g_t& rx,
+      probtable_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results table
+   ptable.init(tau, M);
+   // Erased symbols are equally likely to be any of the alphabet
+   const double p_erased = 1.0 / G::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const G& s = rx(t);
+      double *p = ptable.row(t);
+      if (s.is_erased())
+         std::fill(p, p + M, p_erased);
+      else
+         for (int x = 0; x < M; x++)
+            p[x] = (tx(x) == s) ? 1 : 0;
+      }
+   }
+
+template <class G>
+void qec<G>::receive(const array1vg_t& tx, const array1g_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   assert(tx.size() == tau);
+   assert(tau > 0);
+   const int M = tx(0).size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Erased symbols are equally likely to be any of the alphabet
+   const double p_erased = 1.0 / G::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      assert(tx(t).size() == M);
+      const G& s = rx(t);
+      const array1g_t& c = tx(t);
+      array1d_t& p = ptable(t);
+      if (s.is_erased())
+         p = p_erased;
+      else
+         for (int x = 0; x < M; x++)
+            p(x) = (c(x) == s) ? 1 : 0;
+      }
+   }
+
 // description output
 
 template <class G>
@@ -40,10 +40,21 @@ namespace libcomm {
  * - An is_erased() method that queries the erasure status of the symbol
  * - An operator==() comparison between two symbols of that type
  * Typically this will be provided by the erasable<> templated class.
+ *
+ * The block receive functions set a uniform row for erased symbols, and an
+ * indicator of the received value otherwise.
  */
 
 template <class G>
 class qec : public channel<G> {
+public:
+   /*! \name Type definitions */
+   typedef libbase::vector<G> array1g_t;
+   typedef libbase::vector<array1g_t> array1vg_t;
+   typedef libbase::vector<double> array1d_t;
+   typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<double> probtable_t;
+   // @}
 private:
    /*! \name User-defined parameters */
    double Pe; //!< Symbol-erasure probability \f$ P_e \f$
@@ -84,6 +95,16 @@ public:
       }
    // @}
 
+   // Channel functions
+   void transmit(const array1g_t& tx, array1g_t& rx);
+   using channel<G>::receive;
+   void receive(const array1g_t& tx, const array1g_t& rx,
+         array1vd_t& ptable) const;
+   void receive(const array1g_t& tx, const array1g_t& rx,
+         probtable_t& ptable) const;
+   void receive(const array1vg_t& tx, const array1g_t& rx,
+         array1vd_t& ptable) const;
+
    // Description
    std::string description() const;
 
@@ -246,21 +246,34 @@ double qids_utils::compute_drift_prob_exact(int m, int T, double Pi, double Pd)
    std::cerr << "DEBUG (qids-utils): compute_drift_prob_exact(" << m << "," << T << "," << Pi << "," << Pd << ")" << std::endl;
 #endif
    // caching of results
+   // note: cache is shared by all threads, so access is serialized
    static std::map<pair, double, compare_pairs> cache;
    static double last_Pi = -1; // initialize to an invalid value
    static double last_Pd = -1; // initialize to an invalid value
-   if (last_Pi != Pi || last_Pd != Pd)
+   const pair key(m,T);
+   bool cached = false;
+   double cached_p = 0;
+#ifdef USE_OMP
+#pragma omp critical(qids_utils_drift_cache)
+#endif
       {
-      last_Pi = Pi;
-      last_Pd = Pd;
-      cache.clear();
+      if (last_Pi != Pi || last_Pd != Pd)
+         {
+         last_Pi = Pi;
+         last_Pd = Pd;
+         cache.clear();
+         }
+      // see if we have this value already in cache
+      std::map<pair, double, compare_pairs>::const_iterator it = cache.find(key);
+      if (it != cache.end())
+         {
+         cached = true;
+         cached_p = it->second;
+         }
       }
-   // see if we have this value already in cache
-   const pair key(m,T);
-   std::map<pair, double, compare_pairs>::const_iterator it = cache.find(key);
    // return it if we do
-   if (it != cache.end())
-      return it->second;
+   if (cached)
+      return cached_p;
    // space for result
    myreal this_p;
    // handle non-degenerate case: Pi > 0, Pd > 0
@@ -284,6 +297,9 @@ double qids_utils::compute_drift_prob_exact(int m, int T, double Pi, double Pd)
    else if (this_p < 0)
       throw std::overflow_error("negative value");
    // store this value in cache
+#ifdef USE_OMP
+#pragma omp critical(qids_utils_drift_cache)
+#endif
    cache[key] = this_p;
    return this_p;
    }
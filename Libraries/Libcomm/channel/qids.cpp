@@ -22,6 +22,8 @@
 #include "qids.h"
 #include <sstream>
 #include <exception>
+#include <limits>
+#include <list>
 
 namespace libcomm {
 
@@ -121,8 +123,135 @@ void qids<G, real>::metric_computer::precompute(double Ps, double Pd, double Pi,
    Pval_i = real(0.5 * Pi);
    Pval_tc = real((1 - Pi - Pd) * (1 - Ps));
    Pval_te = real((1 - Pi - Pd) * Ps);
+#ifndef USE_CUDA
+   // receiver lookup table
+   if (receiver_type == receiver_trellis_lookup)
+      precompute_lookup(Ps, Pd, Pi);
+   else
+      lookup.reset();
+#endif
+   }
+
+#ifndef USE_CUDA
+
+/*!
+ * \brief Sets up the receiver lookup table
+ *
+ * Computes the trellis receiver results for every transmitted sequence of
+ * length \c T and every received sequence of length \c T+mT_max. Tables are
+ * kept in a process-wide cache keyed by the parameters they depend on, so
+ * that all instances of the channel with the same settings (e.g. the copies
+ * made for each worker thread and look-ahead point in a simulation) share a
+ * single read-only table; the memory limit therefore applies per parameter
+ * set rather than per instance. A table is released when the last instance
+ * using it lets go. If the table would exceed the memory limit, it is left
+ * empty and the receiver falls back to trellis computation.
+ */
+template <class G, class real>
+void qids<G, real>::metric_computer::precompute_lookup(double Ps, double Pd,
+      double Pi)
+   {
+   // keep existing table if it was computed with the same parameters
+   if (lookup && lookup->matches(Ps, Pd, Pi, T, mT_min, mT_max, m1_min, m1_max))
+      return;
+   lookup.reset();
+   // determine table size, stopping early if over limit
+   // NOTE: do all computations at 64-bit, or we get intermediate overflow!
+   const int q = field_utils<G>::elements();
+   const int L = T + mT_max;
+   const int D = mT_max - mT_min + 1;
+   const libbase::int64u bytes_limit = libbase::int64u(lookup_limit) << 20;
+   libbase::int64u entries = D;
+   for (int i = 0; i < T + L; i++)
+      {
+      entries *= q;
+      if (entries * sizeof(real) > bytes_limit
+            || entries > libbase::int64u(std::numeric_limits<int>::max()))
+         return;
+      }
+   // caching of tables
+   // note: cache is shared by all threads, so access is serialized; the table
+   // is also computed within the critical section, so that threads asking for
+   // the same table wait for it rather than computing their own
+   typedef std::list<boost::weak_ptr<const lookup_table> > cache_t;
+   static cache_t cache;
+#ifdef USE_OMP
+#pragma omp critical(qids_lookup_cache)
+#endif
+      {
+      // look for a table with the same parameters, dropping released ones
+      for (typename cache_t::iterator it = cache.begin(); it != cache.end();)
+         {
+         boost::shared_ptr<const lookup_table> table = it->lock();
+         if (!table)
+            it = cache.erase(it);
+         else
+            {
+            if (!lookup && table->matches(Ps, Pd, Pi, T, mT_min, mT_max,
+                  m1_min, m1_max))
+               lookup = table;
+            ++it;
+            }
+         }
+      // compute and cache a new table if necessary
+      if (!lookup)
+         {
+         lookup = compute_lookup(Ps, Pd, Pi, int(entries));
+         cache.push_back(lookup);
+         }
+      }
+   }
+
+/*!
+ * \brief Computes the receiver lookup table
+ *
+ * Fills a new table with \c entries values, using the trellis receiver for
+ * every (tx,rx) pair; the channel state must already be set up.
+ */
+template <class G, class real>
+boost::shared_ptr<const typename qids<G, real>::metric_computer::lookup_table> qids<
+      G, real>::metric_computer::compute_lookup(double Ps, double Pd, double Pi,
+      int entries) const
+   {
+   const int q = field_utils<G>::elements();
+   const int L = T + mT_max;
+   const int D = mT_max - mT_min + 1;
+   const int tx_count = int(pow(double(q), T));
+   const int rx_count = int(pow(double(q), L));
+   // allocate table and record parameters used
+   boost::shared_ptr<lookup_table> table(new lookup_table);
+   table->Ps = Ps;
+   table->Pd = Pd;
+   table->Pi = Pi;
+   table->T = T;
+   table->mT_min = mT_min;
+   table->mT_max = mT_max;
+   table->m1_min = m1_min;
+   table->m1_max = m1_max;
+   table->values.init(entries);
+   // compute results for every (tx,rx) pair
+   array1g_t tx(T);
+   array1g_t rx(L);
+   array1r_t ptable(D);
+   for (int i = 0; i < tx_count; i++)
+      {
+      // set up transmitted sequence, most significant symbol first
+      for (int k = T - 1, v = i; k >= 0; k--, v /= q)
+         tx(k) = G(v % q);
+      for (int j = 0; j < rx_count; j++)
+         {
+         // set up received sequence, most significant symbol first
+         for (int k = L - 1, v = j; k >= 0; k--, v /= q)
+            rx(k) = G(v % q);
+         receive_trellis(tx, rx, ptable);
+         table->values.segment((i * rx_count + j) * D, D) = ptable;
+         }
+      }
+   return table;
    }
 
+#endif
+
 // Channel receiver for host
 
 #ifndef USE_CUDA
@@ -202,6 +331,39 @@ void qids<G, real>::metric_computer::receive_trellis(const array1g_t& tx,
       ptable(x - mT_min) = Fthis[x];
    }
 
+/*!
+ * \brief Batch receiver interface - lookup from pre-computed trellis results
+ *
+ * Received sequences shorter than \c T+mT_max (at the end of a frame) are
+ * padded with zeros for the lookup: results for drifts within the actual
+ * length do not depend on the padding, while those beyond it are zero.
+ */
+template <class G, class real>
+void qids<G, real>::metric_computer::receive_lookup(const array1g_t& tx,
+      const array1g_t& rx, array1r_t& ptable) const
+   {
+   // Compute sizes
+   const int q = field_utils<G>::elements();
+   const int n = tx.size();
+   const int rho = rx.size();
+   const int L = T + mT_max;
+   const int D = mT_max - mT_min + 1;
+   assert(n == T);
+   assert(rho - n <= mT_max);
+   assert(rho - n >= mT_min);
+   // determine table index for transmitted and received sequences
+   int index = 0;
+   for (int k = 0; k < n; k++)
+      index = index * q + int(tx(k));
+   for (int k = 0; k < L; k++)
+      index = index * q + (k < rho ? int(rx(k)) : 0);
+   // copy results for drifts within received length, and zero the rest
+   assertalways(ptable.size() == D);
+   const real* values = &lookup->values(index * D);
+   for (int x = mT_min; x <= mT_max; x++)
+      ptable(x - mT_min) = (x <= rho - n) ? values[x - mT_min] : real(0);
+   }
+
 // Batch receiver interface - lattice computation
 template <class G, class real>
 void qids<G, real>::metric_computer::receive_lattice(const array1g_t& tx,
@@ -391,7 +553,8 @@ template <class G, class real>
 void qids<G, real>::init()
    {
    // cap on insertions only makes sense with trellis receiver
-   assertalways(Icap == 0 || computer.receiver_type == receiver_trellis);
+   assertalways(Icap == 0 || computer.receiver_type == receiver_trellis
+         || computer.receiver_type == receiver_trellis_lookup);
    // transmit caps make sense only if there is a cap
    assertalways(!tx_Icap || Icap > 0);
    assertalways(!tx_Scap || Scap > 0);
@@ -687,6 +850,10 @@ std::string qids<G, real>::description() const
       case receiver_lattice_corridor:
          sout << ", lattice-corridor computation";
          break;
+      case receiver_trellis_lookup:
+         sout << ", trellis computation with lookup [≤"
+               << computer.lookup_limit << " MiB]";
+         break;
       default:
          failwith("Unknown receiver mode");
          break;
@@ -720,7 +887,7 @@ template <class G, class real>
 std::ostream& qids<G, real>::serialize(std::ostream& sout) const
    {
    sout << "# Version" << std::endl;
-   sout << 5 << std::endl;
+   sout << 6 << std::endl;
    sout << "# Vary Ps?" << std::endl;
    sout << varyPs << std::endl;
    sout << "# Vary Pd?" << std::endl;
@@ -741,8 +908,13 @@ std::ostream& qids<G, real>::serialize(std::ostream& sout) const
    sout << fixedPd << std::endl;
    sout << "# Fixed Pi value" << std::endl;
    sout << fixedPi << std::endl;
-   sout << "# Mode for receiver (0=trellis, 1=lattice, 2=lattice corridor)" << std::endl;
+   sout << "# Mode for receiver (0=trellis, 1=lattice, 2=lattice corridor, 3=trellis with lookup)" << std::endl;
    sout << computer.receiver_type << std::endl;
+   if (computer.receiver_type == receiver_trellis_lookup)
+      {
+      sout << "#: Memory limit for receiver lookup table (in MiB)" << std::endl;
+      sout << computer.lookup_limit << std::endl;
+      }
    return sout;
    }
 
@@ -758,6 +930,8 @@ std::ostream& qids<G, real>::serialize(std::ostream& sout) const
  * \version 4 Added support for cap on state space limits
  *
  * \version 5 Added support for caps at transmit side
+ *
+ * \version 6 Added trellis receiver with lookup table, and its memory limit
  */
 template <class G, class real>
 std::istream& qids<G, real>::serialize(std::istream& sin)
@@ -795,6 +969,12 @@ std::istream& qids<G, real>::serialize(std::istream& sin)
       int temp;
       sin >> libbase::eatcomments >> temp >> libbase::verify;
       computer.receiver_type = (receiver_t) temp;
+      if (computer.receiver_type == receiver_trellis_lookup)
+         {
+         assertalways(version >= 6);
+         sin >> libbase::eatcomments >> computer.lookup_limit
+               >> libbase::verify;
+         }
       }
    else
       computer.receiver_type = receiver_trellis;
@@ -30,6 +30,9 @@
 #include "serializer.h"
 #include "cuda-all.h"
 
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
 namespace libcomm {
 
 // Determine debug level:
@@ -72,6 +75,7 @@ public:
       receiver_trellis = 0, //!< trellis-based receiver
       receiver_lattice, //!< lattice-based receiver without constraints
       receiver_lattice_corridor, //!< lattice-based receiver with drift constraint
+      receiver_trellis_lookup, //!< trellis-based receiver with pre-computed lookup table
       receiver_undefined
    };
    // @}
@@ -94,6 +98,7 @@ public:
    public:
       /*! \name User-defined parameters */
       receiver_t receiver_type; //!< enum indicating receiver implementation to use
+      int lookup_limit; //!< memory limit in MiB for receiver lookup table, if applicable
       // @}
       /*! \name Channel-state and pre-computed parameters */
 #ifdef USE_CUDA
@@ -111,6 +116,30 @@ public:
       int mT_max; //!< Assumed largest positive drift over a whole \c T channel-symbol block is \f$ m_T^{+} \f$
       int m1_min; //!< Assumed largest negative drift over a single channel symbol is \f$ m_1^{-} \f$
       int m1_max; //!< Assumed largest positive drift over a single channel symbol is \f$ m_1^{+} \f$
+#ifndef USE_CUDA
+      /*! \brief Pre-computed receiver results for trellis-lookup receiver
+       * Holds the batch receiver results for every transmitted sequence of
+       * length \c T and every received sequence of length \c T+mT_max,
+       * together with the parameters used to compute them. The table is
+       * read-only once computed, so it is shared between all instances with
+       * the same parameters.
+       */
+      struct lookup_table {
+         double Ps, Pd, Pi; //!< Channel parameters used for table
+         int T, mT_min, mT_max, m1_min, m1_max; //!< Limits used for table
+         array1r_t values; //!< Receiver results, indexed by (tx,rx,drift)
+         //! Check if table was computed with the given parameters
+         bool matches(double Ps, double Pd, double Pi, int T, int mT_min,
+               int mT_max, int m1_min, int m1_max) const
+            {
+            return this->Ps == Ps && this->Pd == Pd && this->Pi == Pi
+                  && this->T == T && this->mT_min == mT_min
+                  && this->mT_max == mT_max && this->m1_min == m1_min
+                  && this->m1_max == m1_max;
+            }
+      };
+      boost::shared_ptr<const lookup_table> lookup; //!< Lookup table (empty if not applicable or over limit)
+#endif
       // @}
       /*! \name Hardwired parameters */
       static const int arraysize = 2 * 63 + 1; //!< Size of stack-allocated arrays
@@ -126,13 +155,18 @@ public:
    public:
       /*! \name Constructors / Destructors */
       metric_computer() :
-      receiver_type(receiver_trellis)
+      receiver_type(receiver_trellis), lookup_limit(0)
          {
          }
       // @}
       /*! \name Internal functions */
       void precompute(double Ps, double Pd, double Pi, int T, int mT_min,
             int mT_max, int m1_min, int m1_max);
+#ifndef USE_CUDA
+      void precompute_lookup(double Ps, double Pd, double Pi);
+      boost::shared_ptr<const lookup_table> compute_lookup(double Ps,
+            double Pd, double Pi, int entries) const;
+#endif
       void init()
          {
 #ifdef USE_CUDA
@@ -167,6 +201,7 @@ public:
          switch(receiver_type)
             {
             case receiver_trellis:
+            case receiver_trellis_lookup:
                receive_trellis(tx, rx, ptable);
                break;
             case receiver_lattice:
@@ -440,6 +475,7 @@ public:
          switch(receiver_type)
             {
             case receiver_trellis:
+            case receiver_trellis_lookup:
                return 0;
             case receiver_lattice:
                return 0;
@@ -477,8 +513,7 @@ public:
          const int n = tx.size();
          const int mu = rx.size() - n;
          // Allocate space for results and call main receiver
-         static array1r_t ptable;
-         ptable.init(mT_max - mT_min + 1);
+         array1r_t ptable(mT_max - mT_min + 1);
          receive(tx, rx, ptable);
          // return result
          return ptable(mu - mT_min);
@@ -491,6 +526,16 @@ public:
             case receiver_trellis:
                receive_trellis(tx, rx, ptable);
                break;
+            case receiver_trellis_lookup:
+               // use table if available for this codeword length,
+               // otherwise fall back to trellis computation
+#ifndef USE_CUDA
+               if (lookup && tx.size() == T)
+                  receive_lookup(tx, rx, ptable);
+               else
+#endif
+                  receive_trellis(tx, rx, ptable);
+               break;
             case receiver_lattice:
                receive_lattice(tx, rx, ptable);
                break;
@@ -504,6 +549,9 @@ public:
          }
       //! Batch receiver interface - trellis computation
       void receive_trellis(const array1g_t& tx, const array1g_t& rx, array1r_t& ptable) const;
+      //! Batch receiver interface - lookup from pre-computed trellis results
+      void receive_lookup(const array1g_t& tx, const array1g_t& rx,
+            array1r_t& ptable) const;
       //! Batch receiver interface - lattice computation
       void receive_lattice(const array1g_t& tx, const array1g_t& rx,
             array1r_t& ptable) const;
@@ -56,6 +56,95 @@ G qsc<G>::corrupt(const G& s)
    return s;
    }
 
+// Channel functions
+
+template <class G>
+void qsc<G>::transmit(const array1g_t& tx, array1g_t& rx)
+   {
+   const int tau = tx.size();
+   // Initialize results vector (this is safe if tx and rx are the same)
+   rx.init(tau);
+   // Corrupt the modulation symbols, in the same sequence as corrupt()
+   for (int i = 0; i < tau; i++)
+      {
+      const double p = this->r.fval_closed();
+      if (p < Ps)
+         rx(i) = field_utils<G>::corrupt(tx(i), this->r);
+      else
+         rx(i) = tx(i);
+      }
+   }
+
+template <class G>
+void qsc<G>::receive(const array1g_t& tx, const array1g_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Only two probability values are possible
+   const double p_same = 1 - Ps;
+   const double p_diff = Ps / field_utils<G>::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const G& s = rx(t);
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         p(x) = (tx(x) == s) ? p_same : p_diff;
+      }
+   }
+
+template <class G>
+void qsc<G>::receive(const array1g_t& tx, const array1g_t& rx,
+      probtable_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   const int M = tx.size();
+   // Initialize results table
+   ptable.init(tau, M);
+   // Only two probability values are possible
+   const double p_same = 1 - Ps;
+   const double p_diff = Ps / field_utils<G>::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      const G& s = rx(t);
+      double *p = ptable.row(t);
+      for (int x = 0; x < M; x++)
+         p[x] = (tx(x) == s) ? p_same : p_diff;
+      }
+   }
+
+template <class G>
+void qsc<G>::receive(const array1vg_t& tx, const array1g_t& rx,
+      array1vd_t& ptable) const
+   {
+   // Compute sizes
+   const int tau = rx.size();
+   assert(tx.size() == tau);
+   assert(tau > 0);
+   const int M = tx(0).size();
+   // Initialize results vector
+   libbase::allocate(ptable, tau, M);
+   // Only two probability values are possible
+   const double p_same = 1 - Ps;
+   const double p_diff = Ps / field_utils<G>::elements();
+   // Work out the probabilities of each possible signal
+   for (int t = 0; t < tau; t++)
+      {
+      assert(tx(t).size() == M);
+      const G& s = rx(t);
+      const array1g_t& c = tx(t);
+      array1d_t& p = ptable(t);
+      for (int x = 0; x < M; x++)
+         p(x) = (c(x) == s) ? p_same : p_diff;
+      }
+   }
+
 // description output
 
 template <class G>
@@ -35,10 +35,21 @@ namespace libcomm {
  * \author  Johann Briffa
  *
  * Implements a q-ary symmetric channel as a templated class.
+ *
+ * Since only two likelihood values are possible, the block receive functions
+ * fill each table row by comparison with the received symbol.
  */
 
 template <class G>
 class qsc : public channel<G> {
+public:
+   /*! \name Type definitions */
+   typedef libbase::vector<G> array1g_t;
+   typedef libbase::vector<array1g_t> array1vg_t;
+   typedef libbase::vector<double> array1d_t;
+   typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<double> probtable_t;
+   // @}
 private:
    /*! \name User-defined parameters */
    double Ps; //!< Symbol-substitution probability \f$ P_s \f$
@@ -73,6 +84,16 @@ public:
       }
    // @}
 
+   // Channel functions
+   void transmit(const array1g_t& tx, array1g_t& rx);
+   using channel<G>::receive;
+   void receive(const array1g_t& tx, const array1g_t& rx,
+         array1vd_t& ptable) const;
+   void receive(const array1g_t& tx, const array1g_t& rx,
+         probtable_t& ptable) const;
+   void receive(const array1vg_t& tx, const array1g_t& rx,
+         array1vd_t& ptable) const;
+
    // Description
    std::string description() const;
 
@@ -25,6 +25,7 @@
 #include "config.h"
 #include "matrix.h"
 #include "vector.h"
+#include "probtable.h"
 #include "serializer.h"
 #include "random.h"
 #include "instrumented.h"
@@ -51,6 +52,12 @@ class codec : public instrumented,
 public:
    /*! \name Type definitions */
    typedef libbase::vector<dbl> array1d_t;
+   typedef libbase::probtable<dbl> probtable_t;
+   // @}
+
+private:
+   /*! \name Internal workspace */
+   C<array1d_t> ptable_legacy; //!< Input table for legacy decoders
    // @}
 
 protected:
@@ -59,6 +66,19 @@ protected:
    virtual void do_encode(const C<int>& source, C<int>& encoded) = 0;
    //! \copydoc init_decoder()
    virtual void do_init_decoder(const C<array1d_t>& ptable) = 0;
+   /*!
+    * \copydoc init_decoder()
+    *
+    * Default implementation converts to a table of vectors and uses the
+    * vector interface; derived classes should override this where the flat
+    * table can be used directly.
+    */
+   virtual void do_init_decoder(const probtable_t& ptable)
+      {
+      ptable_legacy.init(output_block_size());
+      ptable.copyto(ptable_legacy);
+      do_init_decoder(ptable_legacy);
+      }
    // @}
 
 public:
@@ -103,6 +123,21 @@ public:
       mark_as_dirty();
       add_timer(t);
       }
+   /*!
+    * \brief Receiver translation process, from a flat table
+    * \param[in] ptable Likelihoods of each possible encoded symbol at every index
+    *
+    * \note \c ptable(i,d) \c is the likelihood of encoded symbol 'd' at
+    * index 'i'
+    */
+   void init_decoder(const probtable_t& ptable)
+      {
+      libbase::cputimer t("t_init_decoder");
+      advance_if_dirty();
+      do_init_decoder(ptable);
+      mark_as_dirty();
+      add_timer(t);
+      }
    /*!
     * \brief Decoding process
     * \param[out] decoded Most likely sequence of information symbols
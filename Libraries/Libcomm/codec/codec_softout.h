@@ -47,6 +47,7 @@ public:
 private:
    /*! \name Internally-used objects */
    hard_decision<C, dbl, int> hd_functor; //!< Hard-decision box
+   C<array1d_t> ri; //!< Workspace for decode(), kept to avoid reallocation
    // @}
 
 protected:
@@ -67,7 +68,6 @@ public:
    void decode(C<int>& decoded)
       {
       libbase::cputimer t("t_decode");
-      C<array1d_t> ri;
       this->softdecode(ri);
       hd_functor(ri, decoded);
       this->add_timer(t);
@@ -467,7 +467,7 @@ template <class GF_q, class real> std::ostream& ldpc<GF_q, real>::serialize(
    assertalways(sout.good());
    sout << "# Version" << std::endl;
    sout << 5 << std::endl;
-   sout << "# SPA type (trad|gdl)" << std::endl;
+   sout << "# SPA type (trad|gdl|minsum, with optional suffix -layered)" << std::endl;
    sout << this->spa_alg->spa_type() << std::endl;
    sout << "# Number of iterations" << std::endl;
    sout << this->max_iter << std::endl;
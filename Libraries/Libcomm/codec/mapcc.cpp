@@ -259,7 +259,8 @@ std::string mapcc<real, dbl>::description() const
    std::ostringstream sout;
    sout << (endatzero ? "Terminated, " : "Unterminated, ");
    sout << (circular ? "Circular, " : "Non-circular, ");
-   sout << "MAP-decoded Convolutional Code (" << This::output_bits() << ","
+   sout << BCJR::algorithm_description()
+         << "-decoded Convolutional Code (" << This::output_bits() << ","
          << This::input_bits() << ") - ";
    sout << encoder->description();
    return sout.str();
@@ -270,6 +271,9 @@ std::string mapcc<real, dbl>::description() const
 template <class real, class dbl>
 std::ostream& mapcc<real, dbl>::serialize(std::ostream& sout) const
    {
+   // format version
+   sout << "# Version" << std::endl;
+   sout << 1 << std::endl;
    sout << "# Encoder" << std::endl;
    sout << encoder;
    sout << "# Message length (including tail, if any)" << std::endl;
@@ -278,19 +282,45 @@ std::ostream& mapcc<real, dbl>::serialize(std::ostream& sout) const
    sout << int(endatzero) << std::endl;
    sout << "# Circular?" << std::endl;
    sout << int(circular) << std::endl;
+   sout << "# Decoding algorithm (0=MAP, 1=Max-Log-MAP, 2=Log-MAP)" << std::endl;
+   sout << BCJR::get_algorithm() << std::endl;
    return sout;
    }
 
 // object serialization - loading
 
+/*!
+ * \version 0 Initial version (un-numbered)
+ *
+ * \version 1 Added version numbering; added choice of decoding algorithm
+ * (MAP, Max-Log-MAP, Log-MAP)
+ */
 template <class real, class dbl>
 std::istream& mapcc<real, dbl>::serialize(std::istream& sin)
    {
    free();
+   // get format version
+   int version;
+   sin >> libbase::eatcomments >> version;
+   // handle old-format files
+   if (sin.fail())
+      {
+      version = 0;
+      sin.clear();
+      }
    sin >> libbase::eatcomments >> encoder >> libbase::verify;
    sin >> libbase::eatcomments >> tau >> libbase::verify;
    sin >> libbase::eatcomments >> endatzero >> libbase::verify;
    sin >> libbase::eatcomments >> circular >> libbase::verify;
+   // read decoding algorithm, if present
+   if (version >= 1)
+      {
+      int temp;
+      sin >> libbase::eatcomments >> temp >> libbase::verify;
+      BCJR::set_algorithm((typename BCJR::algorithm_t) temp);
+      }
+   else
+      BCJR::set_algorithm(BCJR::algorithm_map);
    init();
    return sin;
    }
@@ -301,6 +331,7 @@ std::istream& mapcc<real, dbl>::serialize(std::istream& sin)
 #include "mpgnu.h"
 #include "logreal.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -314,18 +345,21 @@ using libbase::mpreal;
 using libbase::mpgnu;
 using libbase::logreal;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define REAL1_TYPE_SEQ \
    (float)(double) \
    (mpreal)(mpgnu) \
-   (logreal)(logrealfast)
+   (logreal)(logrealfast) \
+   (logrealsimd)
 #define REAL2_TYPE_SEQ \
    (float)(double) \
    (logrealfast)
 
 /* Serialization string: mapcc<real1,real2>
  * where:
- *      real1 = float | double | mpreal | mpgnu | logreal | logrealfast
+ *      real1 = float | double | mpreal | mpgnu | logreal | logrealfast |
+ *              logrealsimd
  *              [real1 is the internal arithmetic type]
  *      real2 = float | double | logrealfast
  *              [real2 is the interface arithmetic type]
@@ -102,6 +102,7 @@ public:
    mapcc(const mapcc<real, dbl>& x) :
          tau(x.tau), endatzero(x.endatzero), circular(x.circular)
       {
+      BCJR::set_algorithm(x.get_algorithm());
       if (x.encoder)
          {
          encoder = dynamic_cast<fsm*>(x.encoder->clone());
@@ -116,6 +117,7 @@ public:
       tau = x.tau;
       endatzero = x.endatzero;
       circular = x.circular;
+      BCJR::set_algorithm(x.get_algorithm());
       if (x.encoder)
          {
          encoder = dynamic_cast<fsm*>(x.encoder->clone());
@@ -31,6 +31,8 @@
 #include <cmath>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 namespace libcomm {
 using libbase::matrix;
@@ -130,6 +132,20 @@ void reedsolomon<GF_q>::softdecode(array1vd_t& ri, array1vd_t& ro)
       for (int i = 0; i < this->length_n; i++)
          ro(i)(this->received_word_hd(i)) = double(1);
       }
+   else if (this->decoder_type == decoder_bm)
+      {
+      //solve the key equation, treating low-confidence symbols as erasures
+      array1i_t erasures;
+      find_erasures(erasures);
+      libbase::vector<GF_q> tmp_received_hd;
+      if (bm_decode(syndrome_vec, erasures, tmp_received_hd))
+         {
+         // decoded HD word is consistent, so set posteriors from this
+         ro = double(0);
+         for (int i = 0; i < this->length_n; i++)
+            ro(i)(tmp_received_hd(i)) = double(1);
+         }
+      }
    else //do some error correction as the syndrome is non-zero
       {
       //we can correct t errors and dmin=n-k+1.
@@ -331,12 +347,200 @@ void reedsolomon<GF_q>::softdecode(array1vd_t& ri, array1vd_t& ro)
 #endif
    }
 
+/*!
+ * \brief Determine the positions to be treated as erasures
+ * \param[out] erasures Positions of erased symbols, least reliable first
+ *
+ * A symbol is erased if the normalized probability of its hard decision is
+ * below the erasure threshold. Since each erasure uses up one parity symbol,
+ * at most n-k erasures are returned; if there are more candidates, the least
+ * reliable ones are kept.
+ */
+template <class GF_q>
+void reedsolomon<GF_q>::find_erasures(array1i_t& erasures) const
+   {
+   std::vector<std::pair<double, int> > candidates;
+   if (this->erasure_threshold > 0)
+      for (int i = 0; i < this->length_n; i++)
+         {
+         const array1d_t& p = this->received_likelihoods(i);
+         const double total = p.sum();
+         const double confidence = (total > 0) ? p.max() / total : 0;
+         if (confidence < this->erasure_threshold)
+            candidates.push_back(std::make_pair(confidence, i));
+         }
+   const int f = std::min(int(candidates.size()), this->dim_pchk);
+   std::partial_sort(candidates.begin(), candidates.begin() + f,
+         candidates.end());
+   erasures.init(f);
+   for (int e = 0; e < f; e++)
+      erasures(e) = candidates[e].second;
+   }
+
+/*!
+ * \brief Errors-and-erasures decoding of the hard-decided received word
+ * \param[in] syndrome_vec Syndrome of the received word
+ * \param[in] erasures Positions of erased symbols
+ * \param[out] decoded Corrected word (only valid on success)
+ * \return True if decoding succeeded
+ *
+ * The syndrome components are S_j = r(alpha^j) for j=1..n-k, as given by the
+ * rows of the parity check matrix. The Berlekamp-Massey algorithm is
+ * initialized with the erasure locator polynomial, so that it finds the
+ * combined errata locator \Lambda(x) directly. Its roots are found by a Chien
+ * search and the errata values by Forney's formula (for first consecutive
+ * root alpha^1):
+ *      e_i = -\Omega(X_i^{-1}) / \Lambda'(X_i^{-1})
+ * where \Omega(x) = S(x) \Lambda(x) mod x^{n-k} is the errata evaluator.
+ *
+ * Decoding fails if the locator degree exceeds the code's capability or if
+ * it does not have the corresponding number of distinct roots.
+ */
+template <class GF_q>
+bool reedsolomon<GF_q>::bm_decode(const libbase::vector<GF_q>& syndrome_vec,
+      const array1i_t& erasures, libbase::vector<GF_q>& decoded) const
+   {
+   const int nk = this->dim_pchk;
+   const int f = erasures.size();
+   //the first row of the parity check matrix holds the locators alpha^i
+   //of each position i
+
+   //erasure locator polynomial \Gamma(x)=\prod_i (1 - X_i x)
+   libbase::vector<GF_q> lambda(nk + 1);
+   lambda = GF_q(0);
+   lambda(0) = GF_q(1);
+   for (int e = 0; e < f; e++)
+      {
+      const GF_q X = this->pchk_matrix(0, erasures(e));
+      for (int j = e + 1; j > 0; j--)
+         lambda(j) -= X * lambda(j - 1);
+      }
+
+   //Berlekamp-Massey iterations over the remaining syndrome components
+   libbase::vector<GF_q> B = lambda;
+   libbase::vector<GF_q> T;
+   int L = f;
+   for (int r = f + 1; r <= nk; r++)
+      {
+      //discrepancy, using S_j at index j-1
+      GF_q delta = GF_q(0);
+      for (int j = 0; j < r; j++)
+         delta += lambda(j) * syndrome_vec(r - 1 - j);
+      //B(x) <- x B(x)
+      for (int j = nk; j > 0; j--)
+         B(j) = B(j - 1);
+      B(0) = GF_q(0);
+      if (delta != GF_q(0))
+         {
+         T = lambda;
+         for (int j = 1; j <= nk; j++)
+            T(j) -= delta * B(j);
+         if (2 * L <= r - 1 + f)
+            {
+            const GF_q inv = delta.inverse();
+            for (int j = 0; j <= nk; j++)
+               B(j) = lambda(j) * inv;
+            L = r - L + f;
+            }
+         lambda = T;
+         }
+      }
+   //check that the number of errors is within the code's capability
+   if (2 * (L - f) > nk - f)
+      return false;
+   int degree = nk;
+   while (degree > 0 && lambda(degree) == GF_q(0))
+      degree--;
+   if (degree != L)
+      return false;
+
+#if DEBUG>=2
+   std::cout << std::endl << "The errata locator polynomial is given by:" << std::endl;
+   lambda.serialize(std::cout, ',');
+#endif
+
+   //Chien search: position i is in error if \Lambda(alpha^{-i})=0;
+   //term j holds \lambda_j alpha^{-ij} and is updated incrementally
+   const GF_q alpha_inv = GF_q(2).inverse();
+   libbase::vector<GF_q> step(L + 1);
+   libbase::vector<GF_q> term(L + 1);
+   step(0) = GF_q(1);
+   for (int j = 1; j <= L; j++)
+      step(j) = step(j - 1) * alpha_inv;
+   for (int j = 0; j <= L; j++)
+      term(j) = lambda(j);
+   array1i_t errata_pos(L);
+   libbase::vector<GF_q> errata_inv(L);
+   int rootsfound = 0;
+   GF_q x = GF_q(1); // represents alpha^{-i}
+   for (int i = 0; i < this->length_n && rootsfound < L; i++)
+      {
+      GF_q value = term(0);
+      for (int j = 1; j <= L; j++)
+         {
+         value += term(j);
+         term(j) *= step(j);
+         }
+      if (value == GF_q(0))
+         {
+         errata_pos(rootsfound) = i;
+         errata_inv(rootsfound) = x;
+         rootsfound++;
+         }
+      x *= alpha_inv;
+      }
+   if (rootsfound != L)
+      return false;
+
+   //errata evaluator \Omega(x)=S(x)\Lambda(x) mod x^{n-k}
+   libbase::vector<GF_q> omega(nk);
+   for (int k = 0; k < nk; k++)
+      {
+      GF_q tmp_val = GF_q(0);
+      for (int j = 0; j <= std::min(k, L); j++)
+         tmp_val += lambda(j) * syndrome_vec(k - j);
+      omega(k) = tmp_val;
+      }
+
+   //Forney's formula for the errata values
+   decoded = this->received_word_hd;
+   for (int e = 0; e < L; e++)
+      {
+      const GF_q xinv = errata_inv(e);
+      GF_q num = GF_q(0);
+      for (int k = nk - 1; k >= 0; k--)
+         num = num * xinv + omega(k);
+      //formal derivative: in characteristic 2 only odd powers survive
+      GF_q den = GF_q(0);
+      const GF_q xinv2 = xinv * xinv;
+      for (int j = L - ((L % 2) == 0 ? 1 : 0); j >= 1; j -= 2)
+         den = den * xinv2 + lambda(j);
+      if (den == GF_q(0))
+         return false;
+      const int col = errata_pos(e);
+      decoded(col) = GF_q(decoded(col)) + num / den;
+      }
+#if DEBUG>=2
+   std::cout << "This is the word we should have received:" << std::endl;
+   decoded.serialize(std::cout, ',');
+   std::cout << std::endl;
+#endif
+   return true;
+   }
+
 template <class GF_q>
 std::string reedsolomon<GF_q>::description() const
    {
 
    std::ostringstream sout;
    sout << "RS code [" << this->length_n << ", " << this->dim_k << "] ";
+   if (this->decoder_type == decoder_bm)
+      {
+      sout << "BM decoder";
+      if (this->erasure_threshold > 0)
+         sout << " (erasure threshold " << this->erasure_threshold << ")";
+      sout << " ";
+      }
 
    libbase::trace << "Its parity check matrix is:" << std::endl;
 
@@ -527,41 +731,50 @@ void reedsolomon<GF_q>::init()
  * This method outputs the following format
  *
  * reedsolomon<gfq>
+ * version
  * n
  * k
+ * decoder
+ * [threshold]
  *
  * where
  * q is the size of the finite field, ie GF(q)
  * n is the length of the code
  * k is its dimension
+ * decoder is the decoding algorithm (0=PGZ, 1=BM)
+ * threshold is the erasure threshold, only present for the BM decoder
  *
  */
 template <class GF_q>
 std::ostream& reedsolomon<GF_q>::serialize(std::ostream& sout) const
    {
    // format version
+   sout << "# Version" << std::endl;
+   sout << 1 << std::endl;
    sout << "# Length of the code (n)" << std::endl;
    sout << this->length_n << std::endl;
    sout << "# Dimension of the code (k)" << std::endl;
    sout << this->dim_k << std::endl;
+   sout << "# Decoder (0=PGZ, 1=Berlekamp-Massey)" << std::endl;
+   sout << this->decoder_type << std::endl;
+   if (this->decoder_type == decoder_bm)
+      {
+      sout << "#: Erasure threshold (erase symbols with lower probability; 0=none)" << std::endl;
+      sout << this->erasure_threshold << std::endl;
+      }
    return sout;
    }
 
 // object serialization - loading
 /*! loading of the serialized codec information
- * This method oxpects the following format
+ * This method expects the format written by the output serializer
  *
- * reedsolomon
- * n
- * k
- * m
+ * \version 0 Initial version (un-numbered); length and dimension only
  *
- * where
- * n is the length of the code
- * k is its dimension
- * m determines the size of the finite field, eg GF(2^m)
- * note that we must have 1<k<n<2^m+1 and m<=10
+ * \version 1 Added version numbering, decoder type and erasure threshold
  *
+ * \note Old-format files start with the code length, which is always greater
+ * than any version number (since n=q-1 and 1<=k<n).
  */
 
 template <class GF_q>
@@ -569,11 +782,38 @@ std::istream& reedsolomon<GF_q>::serialize(std::istream& sin)
    {
    assertalways(sin.good());
 
+   std::streampos start = sin.tellg();
+   // get format version
+   int version;
+   sin >> libbase::eatcomments >> version >> libbase::verify;
+   // handle old-format files (starting with the code length)
+   if (version > 1)
+      {
+      sin.seekg(start);
+      version = 0;
+      }
    int length, dim;
    //get the length
    sin >> libbase::eatcomments >> length >> libbase::verify;
    //get the dimension;
    sin >> libbase::eatcomments >> dim >> libbase::verify;
+   //get the decoder settings
+   if (version >= 1)
+      {
+      int temp;
+      sin >> libbase::eatcomments >> temp >> libbase::verify;
+      assertalways(temp >= decoder_pgz && temp < decoder_undefined);
+      this->decoder_type = (decoder_t) temp;
+      }
+   else
+      this->decoder_type = decoder_pgz;
+   if (this->decoder_type == decoder_bm)
+      {
+      sin >> libbase::eatcomments >> this->erasure_threshold >> libbase::verify;
+      assertalways(this->erasure_threshold >= 0 && this->erasure_threshold <= 1);
+      }
+   else
+      this->erasure_threshold = 0;
    //initialise the codec with this information
    this->checkParams(length, dim);
    init();
@@ -599,7 +839,10 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
 
 /* Serialization string: reedsolomon<type>
  * where:
- *      type = gf2 | gf4 ...
+ *      type = gf4 | gf8 ...
+ *
+ * There is no realization over GF(2), as the code length is q-1 and the
+ * dimension must lie strictly between zero and the length.
  */
 #define INSTANTIATE(r, x, type) \
       template class reedsolomon<type>; \
@@ -609,6 +852,18 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
             "reedsolomon<" BOOST_PP_STRINGIZE(type) ">", \
             reedsolomon<type>::create);
 
-BOOST_PP_SEQ_FOR_EACH(INSTANTIATE, x, GF_TYPE_SEQ)
+#define RS_TYPE_SEQ \
+      (gf4) \
+      (gf8) \
+      (gf16) \
+      (gf32) \
+      (gf64) \
+      (gf128) \
+      (gf256) \
+      (gf512) \
+      (gf1024) \
+      (gf256aes)
+
+BOOST_PP_SEQ_FOR_EACH(INSTANTIATE, x, RS_TYPE_SEQ)
 
 } // end namespace
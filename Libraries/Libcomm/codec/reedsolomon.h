@@ -43,7 +43,12 @@ namespace libcomm {
  * \author S Wesemeyer
  * This class will construct a Reed-Solomon code over F_{q} of length n and dimension k
  * Note that n is either q or q-1 and 1<k<n-1
- * The Berlekamp algorithm is used to decode any received word.
+ * Received words are decoded either with the Peterson-Gorenstein-Zierler
+ * algorithm, or with the Berlekamp-Massey algorithm (followed by a Chien
+ * search for the error locations and Forney's formula for the error values).
+ * The latter can also treat low-confidence symbols as erasures, in which
+ * case any combination of e errors and f erasures with 2e+f <= n-k is
+ * corrected.
  *
  */
 template <class GF_q>
@@ -53,6 +58,11 @@ public:
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<int> array1i_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   enum decoder_t {
+      decoder_pgz = 0, //!< Peterson-Gorenstein-Zierler (errors only)
+      decoder_bm, //!< Berlekamp-Massey, Chien search and Forney (errors and erasures)
+      decoder_undefined
+   };
 
 protected:
    // Interface with derived classes
@@ -191,6 +201,13 @@ public:
    // Serialization Support
 DECLARE_SERIALIZER(reedsolomon)
 
+private:
+   /*! \name Internal functions */
+   void find_erasures(array1i_t& erasures) const;
+   bool bm_decode(const libbase::vector<GF_q>& syndrome_vec,
+         const array1i_t& erasures, libbase::vector<GF_q>& decoded) const;
+   // @}
+
 private:
    //! the length of the code
    int length_n;
@@ -198,6 +215,10 @@ private:
    int dim_k;
    //the dimension of the parity_check matrix
    int dim_pchk;
+   //! the decoding algorithm
+   decoder_t decoder_type;
+   //! symbols whose hard decision has a lower probability are erased (BM only)
+   double erasure_threshold;
 
    //The parity check matrix of the code
    libbase::matrix<GF_q> pchk_matrix;
@@ -50,8 +50,10 @@ void turbo<real, dbl>::init()
 
    assertalways(!endatzero || !circular);
    assertalways(iter > 0);
+   assertalways(early_stop >= 0);
 
    initialised = false;
+   stopped = false;
    }
 
 template <class real, class dbl>
@@ -75,13 +77,19 @@ void turbo<real, dbl>::reset()
       }
    else if (endatzero)
       {
-      BCJR::setstart(0);
-      BCJR::setend(0);
+      for (size_t i = 0; i < decoders.size(); i++)
+         {
+         decoders[i].setstart(0);
+         decoders[i].setend(0);
+         }
       }
    else
       {
-      BCJR::setstart(0);
-      BCJR::setend();
+      for (size_t i = 0; i < decoders.size(); i++)
+         {
+         decoders[i].setstart(0);
+         decoders[i].setend();
+         }
       }
    }
 
@@ -91,12 +99,13 @@ template <class real, class dbl>
 turbo<real, dbl>::turbo()
    {
    encoder = NULL;
+   early_stop = 0;
    }
 
 template <class real, class dbl>
 turbo<real, dbl>::turbo(const fsm& encoder, const libbase::vector<interleaver<
       dbl> *>& inter, const int iter, const bool endatzero,
-      const bool parallel, const bool circular)
+      const bool parallel, const bool circular, const int early_stop)
    {
    this->encoder = dynamic_cast<fsm*> (encoder.clone());
    this->inter = inter;
@@ -104,6 +113,7 @@ turbo<real, dbl>::turbo(const fsm& encoder, const libbase::vector<interleaver<
    this->parallel = parallel;
    this->circular = circular;
    this->iter = iter;
+   this->early_stop = early_stop;
    init();
    }
 
@@ -124,6 +134,12 @@ void turbo<real, dbl>::allocate()
    else
       libbase::allocate(ra, 1, tau, K);
    libbase::allocate(R, sets, tau, N);
+   // set up decoding workspace (inner sizes are set on first use)
+   rai.init(sets);
+   rii.init(sets);
+   rip.init(sets);
+   // set up component decoders as copies of the (initialized) BCJR
+   decoders.assign(parallel ? sets : 1, component(*this));
    // flag the state of the arrays
    initialised = true;
 
@@ -161,11 +177,17 @@ template <class real, class dbl>
 void turbo<real, dbl>::work_extrinsic(const array2d_t& ra, const array2d_t& ri,
       const array2d_t& r, array2d_t& re)
    {
-   // Compute denominator
-   array2d_t rar = ra.multiply(r);
-   // Copy numerator and divide only for non-zero denominator
-   re = ri;
-   re.mask(rar > 0).divideby(rar);
+   const int rows = ri.size().rows();
+   const int cols = ri.size().cols();
+   re.init(rows, cols);
+   for (int t = 0; t < rows; t++)
+      for (int x = 0; x < cols; x++)
+         {
+         // Compute denominator
+         const dbl rar = ra(t, x) * r(t, x);
+         // Copy numerator and divide only for non-zero denominator
+         re(t, x) = (rar > dbl(0)) ? ri(t, x) / rar : ri(t, x);
+         }
    }
 
 /*!
@@ -183,6 +205,9 @@ void turbo<real, dbl>::work_extrinsic(const array2d_t& ra, const array2d_t& ri,
  * \note When using a circular trellis, the start- and end-state probabilities
  * are re-initialize with the stored values from the previous turn.
  *
+ * \note With parallel decoding, each set uses its own component decoder,
+ * so that different sets may be decoded concurrently.
+ *
  * \warning The return matrix re may actually be the input matrix ra,
  * so one must be careful not to overwrite positions that still
  * need to be read.
@@ -191,20 +216,20 @@ template <class real, class dbl>
 void turbo<real, dbl>::bcjr_wrap(const int set, const array2d_t& ra,
       array2d_t& ri, array2d_t& re)
    {
-   // Temporary variables to hold interleaved versions of ra/ri
-   array2d_t rai, rii;
+   component& decoder = decoders[parallel ? set : 0];
    if (circular)
       {
-      BCJR::setstart(ss(set));
-      BCJR::setend(se(set));
+      decoder.setstart(ss(set));
+      decoder.setend(se(set));
       }
-   inter(set)->transform(ra, rai);
-   BCJR::fdecode(R(set), rai, rii);
-   inter(set)->inverse(rii, ri);
+   // interleaved versions of ra/ri are held in the workspace for this set
+   inter(set)->transform(ra, rai(set));
+   decoder.fdecode(R(set), rai(set), rii(set));
+   inter(set)->inverse(rii(set), ri);
    if (circular)
       {
-      ss(set) = BCJR::getstart();
-      se(set) = BCJR::getend();
+      ss(set) = decoder.getstart();
+      se(set) = decoder.getend();
       }
    work_extrinsic(ra, ri, rp, re);
    }
@@ -242,10 +267,17 @@ void turbo<real, dbl>::decode_serial(array2d_t& ri)
 template <class real, class dbl>
 void turbo<real, dbl>::decode_parallel(array2d_t& ri)
    {
-   // here ri is only a temporary space
-   // and ra(set) is updated with the extrinsic information for that set
-   for (int set = 0; set < num_sets(); set++)
-      bcjr_wrap(set, ra(set), ri, ra(set));
+   // ra(set) is updated with the extrinsic information for that set;
+   // the sets are independent, so they may be decoded concurrently
+   const int sets = num_sets();
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static)
+#endif
+   for (int set = 0; set < sets; set++)
+      {
+      // the posteriors are held separately for each set
+      bcjr_wrap(set, ra(set), rip(set), ra(set));
+      }
    // the following are repeated at each frame element, for each possible symbol
    // work in ri the sum of all extrinsic information
    ri = ra(0);
@@ -254,7 +286,9 @@ void turbo<real, dbl>::decode_parallel(array2d_t& ri)
    // compute the next-stage a priori information by subtracting the extrinsic
    // information of the current stage from the sum of all extrinsic information.
    for (int set = 0; set < num_sets(); set++)
-      ra(set) = ri.divide(ra(set));
+      for (int t = 0; t < ri.size().rows(); t++)
+         for (int x = 0; x < ri.size().cols(); x++)
+            ra(set)(t, x) = ri(t, x) / ra(set)(t, x);
    // add the channel information to the sum of extrinsic information
    ri.multiplyby(rp);
    // normalize results
@@ -274,7 +308,7 @@ void turbo<real, dbl>::decode_parallel(array2d_t& ri)
  * \note Clean up this function, removing unnecessary symbol-conversion
  */
 template <class real, class dbl>
-void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
+void turbo<real, dbl>::do_init_decoder(const probtable_t& ptable)
    {
    assert(ptable.size() == This::output_block_size());
    // Inherit sizes
@@ -293,8 +327,8 @@ void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
    if (!initialised)
       allocate();
 
-   // Allocate space for temporary matrices
-   libbase::matrix3<dbl> ptemp(sets, tau, P);
+   // Allocate space for temporary matrices (if necessary)
+   ptemp.init(sets, tau, P);
 
    // Get the necessary data from the channel
    for (int t = 0; t < tau; t++)
@@ -304,7 +338,7 @@ void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
          {
          rp(t, x) = 1;
          for (int i = 0, thisx = x; i < k; i++, thisx /= S)
-            rp(t, x) *= dbl(ptable(t * s + i)(thisx % S));
+            rp(t, x) *= dbl(ptable(t * s + i, thisx % S));
          }
       // Parity bits [all sets]
       for (int x = 0; x < P; x++)
@@ -312,7 +346,7 @@ void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
             {
             ptemp(set, t, x) = 1;
             for (int i = 0, thisx = x; i < p; i++, thisx /= S)
-               ptemp(set, t, x) *= dbl(ptable(t * s + i + offset)(thisx % S));
+               ptemp(set, t, x) *= dbl(ptable(t * s + i + offset, thisx % S));
             offset += p;
             }
       }
@@ -325,7 +359,6 @@ void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
    BCJR::normalize(rp);
 
    // Compute and normalize a priori probabilities (intrinsic - encoded)
-   array2d_t rpi;
    for (int set = 0; set < sets; set++)
       {
       inter(set)->transform(rp, rpi);
@@ -337,6 +370,22 @@ void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
 
    // Reset start- and end-state probabilities
    reset();
+
+   // Reset early stopping state
+   stable_count = -1;
+   stopped = false;
+   }
+
+/*! \copydoc codec_softout::setreceiver()
+ *
+ * The table is copied into a flat workspace table, which is then used to set
+ * up the decoder.
+ */
+template <class real, class dbl>
+void turbo<real, dbl>::do_init_decoder(const array1vd_t& ptable)
+   {
+   pflat.copyfrom(ptable);
+   do_init_decoder(pflat);
    }
 
 template <class real, class dbl>
@@ -450,11 +499,44 @@ void turbo<real, dbl>::do_encode(const array1i_t& source, array1i_t& encoded)
       }
    }
 
+/*! \brief Update early stopping state from the latest posteriors
+ *
+ * Decoding is marked as stopped once the hard decisions (including any tail)
+ * have remained unchanged for 'early_stop' consecutive iterations.
+ */
+template <class real, class dbl>
+void turbo<real, dbl>::update_stopping(const array2d_t& ri)
+   {
+   const int tau = ri.size().rows();
+   const int K = ri.size().cols();
+   hd.init(tau);
+   for (int t = 0; t < tau; t++)
+      {
+      int best = 0;
+      for (int x = 1; x < K; x++)
+         if (ri(t, x) > ri(t, best))
+            best = x;
+      hd(t) = best;
+      }
+   if (stable_count >= 0 && hd.isequalto(last_hd))
+      stable_count++;
+   else
+      stable_count = 0;
+   last_hd = hd;
+   stopped = (stable_count >= early_stop);
+   }
+
 template <class real, class dbl>
 void turbo<real, dbl>::softdecode(array1vd_t& ri)
    {
-   // temporary space to hold complete results (ie. with tail)
-   array2d_t rif;
+   // once stopped, repeat the last result for the remaining iterations
+   if (stopped)
+      {
+      ri = stopped_ri;
+      this->add_timer(0, "c_iteration");
+      return;
+      }
+   // complete results (ie. with tail) are held in the workspace
    // do one iteration, in serial or parallel as required
    if (parallel)
       decode_parallel(rif);
@@ -465,6 +547,14 @@ void turbo<real, dbl>::softdecode(array1vd_t& ri)
    for (int i = 0; i < input_block_size(); i++)
       for (int j = 0; j < num_inputs(); j++)
          ri(i)(j) = rif(i, j);
+   // update early stopping state, if enabled
+   if (early_stop > 0)
+      {
+      update_stopping(rif);
+      if (stopped)
+         stopped_ri = ri;
+      this->add_timer(1, "c_iteration");
+      }
    }
 
 template <class real, class dbl>
@@ -487,6 +577,10 @@ std::string turbo<real, dbl>::description() const
    sout << (endatzero ? "Terminated, " : "Unterminated, ");
    sout << (circular ? "Circular, " : "Non-circular, ");
    sout << (parallel ? "Parallel Decoding, " : "Serial Decoding, ");
+   if (early_stop > 0)
+      sout << "Early Stopping (" << early_stop << " stable), ";
+   if (BCJR::get_algorithm() != BCJR::algorithm_map)
+      sout << BCJR::algorithm_description() << ", ";
    sout << iter << " iterations";
    return sout.str();
    }
@@ -498,7 +592,7 @@ std::ostream& turbo<real, dbl>::serialize(std::ostream& sout) const
    {
    // format version
    sout << "# Version" << std::endl;
-   sout << 2 << std::endl;
+   sout << 4 << std::endl;
    sout << "# Encoder" << std::endl;
    sout << encoder;
    sout << "# Number of parallel sets" << std::endl;
@@ -516,6 +610,10 @@ std::ostream& turbo<real, dbl>::serialize(std::ostream& sout) const
    sout << int(parallel) << std::endl;
    sout << "# Number of iterations" << std::endl;
    sout << iter << std::endl;
+   sout << "# Decoding algorithm (0=MAP, 1=Max-Log-MAP, 2=Log-MAP)" << std::endl;
+   sout << BCJR::get_algorithm() << std::endl;
+   sout << "# Early stopping (iterations with unchanged hard decisions, 0=off)" << std::endl;
+   sout << early_stop << std::endl;
    return sout;
    }
 
@@ -527,6 +625,10 @@ std::ostream& turbo<real, dbl>::serialize(std::ostream& sout) const
  * \version 1 Added version numbering; added explicit first interleaver
  *
  * \version 2 Removed explicit 'tau'
+ *
+ * \version 3 Added choice of decoding algorithm (MAP, Max-Log-MAP, Log-MAP)
+ *
+ * \version 4 Added early stopping on stable hard decisions
  */
 template <class real, class dbl>
 std::istream& turbo<real, dbl>::serialize(std::istream& sin)
@@ -564,6 +666,20 @@ std::istream& turbo<real, dbl>::serialize(std::istream& sin)
    sin >> libbase::eatcomments >> circular >> libbase::verify;
    sin >> libbase::eatcomments >> parallel >> libbase::verify;
    sin >> libbase::eatcomments >> iter >> libbase::verify;
+   // read decoding algorithm, if present
+   if (version >= 3)
+      {
+      int temp;
+      sin >> libbase::eatcomments >> temp >> libbase::verify;
+      BCJR::set_algorithm((typename BCJR::algorithm_t) temp);
+      }
+   else
+      BCJR::set_algorithm(BCJR::algorithm_map);
+   // read early stopping criterion, if present
+   if (version >= 4)
+      sin >> libbase::eatcomments >> early_stop >> libbase::verify;
+   else
+      early_stop = 0;
    init();
    assertalways(sin.good());
    return sin;
@@ -575,6 +691,7 @@ std::istream& turbo<real, dbl>::serialize(std::istream& sin)
 #include "mpgnu.h"
 #include "logreal.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -588,18 +705,21 @@ using libbase::mpreal;
 using libbase::mpgnu;
 using libbase::logreal;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define REAL1_TYPE_SEQ \
    (float)(double) \
    (mpreal)(mpgnu) \
-   (logreal)(logrealfast)
+   (logreal)(logrealfast) \
+   (logrealsimd)
 #define REAL2_TYPE_SEQ \
    (float)(double) \
    (logrealfast)
 
 /* Serialization string: turbo<real1,real2>
  * where:
- *      real1 = float | double | mpreal | mpgnu | logreal | logrealfast
+ *      real1 = float | double | mpreal | mpgnu | logreal | logrealfast |
+ *              logrealsimd
  *              [real1 is the internal arithmetic type]
  *      real2 = float | double | logrealfast
  *              [real2 is the inter-iteration statistics type]
@@ -31,6 +31,7 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 
 namespace libcomm {
 
@@ -63,6 +64,16 @@ namespace libcomm {
  * interpreted as v.0; a flat interleaver is automatically used for the
  * first encoder in these cases.
  *
+ * \note With parallel decoding, the component decoders of all sets are
+ * independent within an iteration; each set therefore has its own copy of
+ * the BCJR decoder, and the sets are decoded concurrently when OpenMP is
+ * available.
+ *
+ * \note Decoding can be stopped early, once the hard decisions have not
+ * changed for a given number of iterations; the remaining iterations then
+ * return the last computed result. When enabled, each iteration records in
+ * the instrumentation (as 'c_iteration') whether it was actually computed.
+ *
  * \todo Fix terminated sequence encoding (currently this implicitly assumes
  * a flat first interleaver)
  *
@@ -90,6 +101,22 @@ private:
    typedef turbo<real, dbl> This;
    typedef codec_softout<libbase::vector, dbl> Base;
    typedef safe_bcjr<real, dbl> BCJR;
+   /*!
+    * \brief Component decoder
+    * Independent copy of the BCJR decoder, exposing the state probability
+    * interface for use by the turbo decoder.
+    */
+   class component : public BCJR {
+   public:
+      explicit component(const BCJR& prototype) :
+            BCJR(prototype)
+         {
+         }
+      using BCJR::getstart;
+      using BCJR::getend;
+      using BCJR::setstart;
+      using BCJR::setend;
+   };
 public:
    /*! \name Type definitions */
    typedef libbase::vector<int> array1i_t;
@@ -97,6 +124,7 @@ public:
    typedef libbase::vector<dbl> array1d_t;
    typedef libbase::matrix<dbl> array2d_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 private:
    /*! \name User-defined parameters */
@@ -107,6 +135,7 @@ private:
    bool endatzero; //!< Flag to indicate that trellises are terminated
    bool parallel; //!< Flag to enable parallel decoding (rather than serial)
    bool circular; //!< Flag to indicate trellis tailbiting
+   int early_stop; //!< Iterations with unchanged hard decisions before stopping (0 = never)
    // @}
    /*! \name Internal object representation */
    bool initialised; //!< Flag to indicate when memory is initialised
@@ -115,6 +144,23 @@ private:
    libbase::vector<array2d_t> ra; //!< A priori extrinsic source statistics
    libbase::vector<array1d_t> ss; //!< Holder for start-state probabilities (used with circular trellises)
    libbase::vector<array1d_t> se; //!< Holder for end-state probabilities (used with circular trellises)
+   std::vector<component> decoders; //!< Component decoders (one per set for parallel decoding)
+   // @}
+   /*! \name Early stopping state */
+   array1i_t last_hd; //!< Hard decisions at the last iteration
+   int stable_count; //!< Number of consecutive iterations with unchanged hard decisions (-1 before the first)
+   bool stopped; //!< Flag to indicate decoding has stopped for this frame
+   array1vd_t stopped_ri; //!< Result to repeat after stopping
+   // @}
+   /*! \name Decoding workspace (kept between frames to avoid reallocation) */
+   libbase::matrix3<dbl> ptemp; //!< Parity statistics, per set
+   array2d_t rpi; //!< Interleaved source statistics
+   libbase::vector<array2d_t> rai; //!< Interleaved a-priori statistics, per set
+   libbase::vector<array2d_t> rii; //!< Interleaved posteriors, per set
+   libbase::vector<array2d_t> rip; //!< Posteriors for parallel decoding, per set
+   array2d_t rif; //!< Complete posteriors (with tail) from an iteration
+   probtable_t pflat; //!< Receiver statistics given as a table of vectors
+   array1i_t hd; //!< Hard decisions at the current iteration
    // @}
    /*! \name Internal functions */
    //! Memory allocator (for internal use only)
@@ -126,6 +172,7 @@ private:
          array2d_t& re);
    void decode_serial(array2d_t& ri);
    void decode_parallel(array2d_t& ri);
+   void update_stopping(const array2d_t& ri);
    // @}
 protected:
    /*! \name Internal functions */
@@ -209,6 +256,7 @@ protected:
       }
    void do_encode(const array1i_t& source, array1i_t& encoded);
    void do_init_decoder(const array1vd_t& ptable);
+   void do_init_decoder(const probtable_t& ptable);
    void do_init_decoder(const array1vd_t& ptable, const array1vd_t& app);
 public:
    /*! \name Constructors / Destructors */
@@ -216,7 +264,7 @@ public:
    turbo();
    turbo(const fsm& encoder, const libbase::vector<interleaver<dbl> *>& inter,
          const int iter, const bool endatzero, const bool parallel = false,
-         const bool circular = false);
+         const bool circular = false, const int early_stop = 0);
    ~turbo()
       {
       free();
@@ -52,6 +52,18 @@ void uncoded<dbl>::do_init_decoder(const array1vd_t& ptable)
    R = ptable;
    }
 
+template <class dbl>
+void uncoded<dbl>::do_init_decoder(const probtable_t& ptable)
+   {
+   // Encoder symbol space must be the same as modulation symbol space
+   assertalways(ptable.size() > 0);
+   assertalways(ptable.cols() == This::num_outputs());
+   // Confirm input sequence to be of the correct length
+   assertalways(ptable.size() == This::output_block_size());
+   // Copy the received (output-referred) statistics
+   ptable.copyto(R);
+   }
+
 template <class dbl>
 void uncoded<dbl>::do_init_decoder(const array1vd_t& ptable, const array1vd_t& app)
    {
@@ -49,6 +49,7 @@ public:
    typedef libbase::vector<int> array1i_t;
    typedef libbase::vector<dbl> array1d_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 private:
    /*! \name User-specified parameters */
@@ -62,6 +63,7 @@ protected:
    // Interface with derived classes
    void do_encode(const array1i_t& source, array1i_t& encoded);
    void do_init_decoder(const array1vd_t& ptable);
+   void do_init_decoder(const probtable_t& ptable);
    void do_init_decoder(const array1vd_t& ptable, const array1vd_t& app);
 public:
    /*! \name Constructors / Destructors */
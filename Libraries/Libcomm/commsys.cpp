@@ -157,29 +157,25 @@ void basic_commsys<S, C>::seedfrom(libbase::random& r)
  * \enddot
  */
 template <class S, template <class > class C>
-C<S> basic_commsys<S, C>::encode_path(const C<int>& source)
+void basic_commsys<S, C>::encode_path(const C<int>& source, C<S>& transmitted)
    {
    // Keep track of what we're transmitting
 #if DEBUG>=2
    lastsource = source;
 #endif
    // Encode
-   C<int> encoded;
    this->cdc->reset_timers();
    this->cdc->encode(source, encoded);
    this->add_timers(*this->cdc);
    // Map
-   C<int> mapped;
    this->map->reset_timers();
    this->map->transform(encoded, mapped);
    this->add_timers(*this->map);
    // Modulate
    const int M = this->mdm->num_symbols();
-   C<S> transmitted;
    this->mdm->reset_timers();
    this->mdm->modulate(M, mapped, transmitted);
    this->add_timers(*this->mdm);
-   return transmitted;
    }
 
 /*!
@@ -197,13 +193,11 @@ C<S> basic_commsys<S, C>::encode_path(const C<int>& source)
  * \enddot
  */
 template <class S, template <class > class C>
-C<S> basic_commsys<S, C>::transmit(const C<S>& transmitted)
+void basic_commsys<S, C>::transmit(const C<S>& transmitted, C<S>& received)
    {
-   C<S> received;
    this->txchan->reset_timers();
    this->txchan->transmit(transmitted, received);
    this->add_timers(*this->txchan);
-   return received;
    }
 
 /*!
@@ -226,7 +220,6 @@ template <class S, template <class > class C>
 void basic_commsys<S, C>::receive_path(const C<S>& received)
    {
    // Demodulate
-   C<array1d_t> ptable_mapped;
    this->mdm->reset_timers();
    this->mdm->demodulate(*this->rxchan, received, ptable_mapped);
    this->add_timers(*this->mdm);
@@ -234,6 +227,30 @@ void basic_commsys<S, C>::receive_path(const C<S>& received)
    softreceive_path(ptable_mapped);
    }
 
+/*!
+ * \copydoc receive_path()
+ *
+ * The demodulator processes all frames of the batch together, when this is
+ * called for the first frame (k = 0); its output for frame 'k' is then taken
+ * through the after-demodulation receive path. Frames must therefore be taken
+ * in order, decoding each before moving to the next.
+ */
+template <class S, template <class > class C>
+void basic_commsys<S, C>::receive_path(const libbase::vector<C<S> >& received,
+      const int k)
+   {
+   assert(k >= 0 && k < received.size());
+   // Demodulate all frames
+   if (k == 0)
+      {
+      this->mdm->reset_timers();
+      this->mdm->demodulate_batch(*this->rxchan, received, ptable_batch);
+      this->add_timers(*this->mdm);
+      }
+   // After-demodulation receive path
+   softreceive_path(ptable_batch(k));
+   }
+
 /*!
  * The after-demodulation receive path consists of the steps depicted in the
  * following diagram:
@@ -252,9 +269,22 @@ void basic_commsys<S, C>::receive_path(const C<S>& received)
  */
 template <class S, template <class > class C>
 void basic_commsys<S, C>::softreceive_path(const C<array1d_t>& ptable_mapped)
+   {
+   // Convert to flat table and follow the usual path
+   this->ptable_mapped.copyfrom(ptable_mapped);
+   softreceive_path(this->ptable_mapped);
+   }
+
+/*!
+ * \copydoc softreceive_path()
+ *
+ * The tables between stages are kept in flat form; components without a
+ * flat interface are handled by adapters in their base classes.
+ */
+template <class S, template <class > class C>
+void basic_commsys<S, C>::softreceive_path(const probtable_t& ptable_mapped)
    {
    // Inverse Map
-   C<array1d_t> ptable_encoded;
    this->map->reset_timers();
    this->map->inverse(ptable_mapped, ptable_encoded);
    this->add_timers(*this->map);
@@ -268,6 +298,23 @@ void basic_commsys<S, C>::softreceive_path(const C<array1d_t>& ptable_mapped)
 #endif
    }
 
+/*!
+ * The demodulator, inverse mapper and codec are advanced in the same way as
+ * for a frame that is received, without processing anything; this allows a
+ * system to decode every n-th frame of a sequence, giving the same results
+ * as a system that decodes all frames.
+ */
+template <class S, template <class > class C>
+void basic_commsys<S, C>::skip_receive_path()
+   {
+   this->mdm->advance_if_dirty();
+   this->mdm->mark_as_dirty();
+   this->map->advance_if_dirty();
+   this->map->mark_as_dirty();
+   this->cdc->advance_if_dirty();
+   this->cdc->mark_as_dirty();
+   }
+
 template <class S, template <class > class C>
 void basic_commsys<S, C>::decode(C<int>& decoded)
    {
@@ -50,6 +50,7 @@ class basic_commsys : public instrumented {
 public:
    /*! \name Type definitions */
    typedef libbase::vector<double> array1d_t;
+   typedef libbase::probtable<double> probtable_t;
    // @}
 
 protected:
@@ -61,6 +62,13 @@ protected:
    channel<S, C> *rxchan; //!< Channel model - receiver side
    bool singlechannel; //!< Flag indicating RX = TX channel
    // @}
+   /*! \name Internal workspace (kept between frames to avoid reallocation) */
+   C<int> encoded; //!< Encoder output
+   C<int> mapped; //!< Mapper output
+   probtable_t ptable_mapped; //!< Demodulator output
+   probtable_t ptable_encoded; //!< Inverse mapper output
+   libbase::vector<C<array1d_t> > ptable_batch; //!< Demodulator output for a batch of frames
+   // @}
 #ifndef NDEBUG
    bool lastframecorrect;
    C<int> lastsource;
@@ -115,13 +123,34 @@ public:
 
    /*! \name Communication System Interface */
    //! Perform complete encode path
-   virtual C<S> encode_path(const C<int>& source);
+   virtual void encode_path(const C<int>& source, C<S>& transmitted);
+   //! Perform complete encode path, returning the transmitted sequence
+   C<S> encode_path(const C<int>& source)
+      {
+      C<S> transmitted;
+      encode_path(source, transmitted);
+      return transmitted;
+      }
    //! Perform channel transmission
-   virtual C<S> transmit(const C<S>& transmitted);
+   virtual void transmit(const C<S>& transmitted, C<S>& received);
+   //! Perform channel transmission, returning the received sequence
+   C<S> transmit(const C<S>& transmitted)
+      {
+      C<S> received;
+      transmit(transmitted, received);
+      return received;
+      }
    //! Perform complete receive path, except for final decoding
    virtual void receive_path(const C<S>& received);
+   //! Perform complete receive path for frame 'k' of a batch, except for final decoding
+   virtual void receive_path(const libbase::vector<C<S> >& received,
+         const int k);
    //! Perform after-demodulation receive path, except for final decoding
    virtual void softreceive_path(const C<array1d_t>& ptable_mapped);
+   //! Perform after-demodulation receive path, from a flat table
+   virtual void softreceive_path(const probtable_t& ptable_mapped);
+   //! Advance the receiver components past a frame that is not received
+   virtual void skip_receive_path();
    //! Perform a decoding iteration, with hard decision
    virtual void decode(C<int>& decoded);
    // @}
@@ -78,6 +78,11 @@ public:
       }
    // Communication System Interface
    void receive_path(const C<S>& received);
+   //! Demodulation is repeated during decoding, so frames in a batch are taken separately
+   void receive_path(const libbase::vector<C<S> >& received, const int k)
+      {
+      receive_path(received(k));
+      }
    void decode(C<int>& decoded);
    // Informative functions
    int num_iter() const
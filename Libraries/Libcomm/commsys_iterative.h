@@ -56,6 +56,11 @@ private:
 public:
    // Communication System Interface
    void receive_path(const C<S>& received);
+   //! Demodulation is iterative, so frames in a batch are taken separately
+   void receive_path(const libbase::vector<C<S> >& received, const int k)
+      {
+      receive_path(received(k));
+      }
 
    // Description
    std::string description() const;
@@ -24,6 +24,7 @@
 
 #include "blockembedder.h"
 #include "embedder.h"
+#include "randgen.h"
 
 namespace libcomm {
 
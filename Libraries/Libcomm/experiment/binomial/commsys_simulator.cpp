@@ -49,17 +49,17 @@ namespace libcomm {
 
 /*!
  * \brief Create source sequence to be encoded
- * \return Source sequence of the required length
+ * \param[out] source Source sequence of the required length
  *
  * The source sequence consists of uniformly random symbols followed by a
  * tail sequence if required by the given codec.
  */
 template <class S, class R>
-libbase::vector<int> commsys_simulator<S, R>::createsource()
+void commsys_simulator<S, R>::createsource(array1i_t& source)
    {
-   // determine size and allocate space
+   // determine size and allocate space (if necessary)
    const int tau = sys->input_block_size();
-   libbase::vector<int> source(tau);
+   source.init(tau);
    // fill as required
    switch (input_mode)
       {
@@ -85,7 +85,6 @@ libbase::vector<int> commsys_simulator<S, R>::createsource()
          failwith("Unknown input mode");
          break;
       }
-   return source;
    }
 
 // Experiment handling
@@ -100,12 +99,20 @@ libbase::vector<int> commsys_simulator<S, R>::createsource()
  * \note The results collector assumes that the result vector is an accumulator,
  * so that every call adds to the existing result. This explains the need to
  * initialize the result vector to zero.
+ *
+ * \note Intermediate sequences are kept in workspace members, so that once
+ * the first frame has been simulated, a sample cycle does not need to
+ * allocate any vectors or matrices. The number of such allocations made
+ * during the cycle is added to the system timers as "c_allocs", so that it
+ * can be observed with the timing collector.
  */
 template <class S, class R>
 void commsys_simulator<S, R>::sample(libbase::vector<double>& result)
    {
    // Reset timers
    this->reset_timers();
+   // Keep track of array allocations in this thread
+   const libbase::int64u allocations = libbase::array_allocations();
    // Initialise result vector
    result.init(count());
    result = 0;
@@ -113,15 +120,14 @@ void commsys_simulator<S, R>::sample(libbase::vector<double>& result)
    fidelity_pos* rc = dynamic_cast<fidelity_pos*>(this);
 
    // Create source stream
-   libbase::vector<int> source = createsource();
+   createsource(source);
    // Encode -> Map -> Modulate
-   libbase::vector<S> transmitted = sys->encode_path(source);
+   sys->encode_path(source, transmitted);
    // Transmit
-   libbase::vector<S> received = sys->transmit(transmitted);
+   sys->transmit(transmitted, received);
    // Demodulate -> Inverse Map -> Translate
    sys->receive_path(received);
    // For every iteration
-   libbase::vector<int> decoded;
    for (int i = 0; i < sys->num_iter(); i++)
       {
       // Decode
@@ -178,6 +184,9 @@ void commsys_simulator<S, R>::sample(libbase::vector<double>& result)
       last_event(i) = source(i);
       last_event(i + tau) = decoded(i);
       }
+   // Record the number of array allocations made
+   sys->add_timer(double(libbase::array_allocations() - allocations),
+         "c_allocs");
    }
 
 // Description & Serialization
@@ -68,6 +68,12 @@ protected:
    /*! \name Internal state */
    array1i_t last_event;
    // @}
+   /*! \name Internal workspace (kept between samples to avoid reallocation) */
+   array1i_t source; //!< Source sequence
+   libbase::vector<S> transmitted; //!< Modulated sequence
+   libbase::vector<S> received; //!< Channel output sequence
+   array1i_t decoded; //!< Decoder output
+   // @}
 
 protected:
    /*! \name Setup functions */
@@ -91,7 +97,14 @@ protected:
       }
    // @}
    /*! \name Internal functions */
-   array1i_t createsource();
+   void createsource(array1i_t& source);
+   //! Create source sequence to be encoded, returning the sequence
+   array1i_t createsource()
+      {
+      array1i_t source;
+      createsource(source);
+      return source;
+      }
    // @}
    // System Interface for Results
    int get_symbolsperframe() const
@@ -51,7 +51,7 @@ public:
       return G::elements();
       }
    //! Cause a substitution error to given symbol (all other values equally likely)
-   static G corrupt(const G& s, libbase::randgen& r)
+   static G corrupt(const G& s, libbase::random& r)
       {
       return s + G(r.ival(G::elements() - 1) + 1);
       }
@@ -90,7 +90,7 @@ public:
       return 2;
       }
    //! Cause a substitution error to given symbol
-   static bool corrupt(const bool& s, libbase::randgen& r)
+   static bool corrupt(const bool& s, libbase::random& r)
       {
       return !s;
       }
@@ -0,0 +1,343 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __framed_stream_h
+#define __framed_stream_h
+
+#include "config.h"
+#include "vector.h"
+#include "matrix.h"
+#include "gf.h"
+#include "erasable.h"
+#include "sigspace.h"
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+/*!
+ * \file
+ * \brief   Binary Framed Stream Format.
+ *
+ * Functions to read and write a sequence of frames (vectors or matrices)
+ * in binary form, as an alternative to the text serialization used by the
+ * command-line tools. Each frame consists of a fixed-size header followed
+ * by the payload:
+ * - 4-byte magic sequence "CSFB"
+ * - 32-bit row count (number of elements for vectors)
+ * - 32-bit column count (always 1 for vectors)
+ * - 32-bit element size in bytes
+ * - rows x cols elements, in row-major order
+ *
+ * Elements are stored in native byte order, as given by framed_element<>;
+ * the element size must be the same for all elements in a frame. Each frame
+ * is transferred with a single read or write on the underlying stream.
+ *
+ * \note Streams must be opened in binary mode on platforms where this
+ * makes a difference.
+ */
+
+namespace libcomm {
+
+/*!
+ * \brief   Binary representation of a frame element.
+ *
+ * Each specialization provides the size in bytes of a given element, and
+ * methods to pack an element into (and unpack from) a byte buffer.
+ */
+
+template <class T>
+class framed_element;
+
+template <>
+class framed_element<bool> {
+public:
+   static int size(const bool& x)
+      {
+      return 1;
+      }
+   static void pack(char *p, const bool& x)
+      {
+      *p = x ? 1 : 0;
+      }
+   static void unpack(const char *p, const int size, bool& x)
+      {
+      assertalways(size == 1);
+      x = (*p != 0);
+      }
+};
+
+template <>
+class framed_element<int> {
+public:
+   static int size(const int& x)
+      {
+      return sizeof(int32_t);
+      }
+   static void pack(char *p, const int& x)
+      {
+      const int32_t v = x;
+      memcpy(p, &v, sizeof(v));
+      }
+   static void unpack(const char *p, const int size, int& x)
+      {
+      assertalways(size == sizeof(int32_t));
+      int32_t v;
+      memcpy(&v, p, sizeof(v));
+      x = v;
+      }
+};
+
+template <>
+class framed_element<double> {
+public:
+   static int size(const double& x)
+      {
+      return sizeof(double);
+      }
+   static void pack(char *p, const double& x)
+      {
+      memcpy(p, &x, sizeof(x));
+      }
+   static void unpack(const char *p, const int size, double& x)
+      {
+      assertalways(size == sizeof(double));
+      memcpy(&x, p, sizeof(x));
+      }
+};
+
+//! Field elements are stored as their integer representation
+template <int m, int poly>
+class framed_element<libbase::gf<m, poly> > {
+public:
+   static int size(const libbase::gf<m, poly>& x)
+      {
+      return sizeof(int32_t);
+      }
+   static void pack(char *p, const libbase::gf<m, poly>& x)
+      {
+      framed_element<int>::pack(p, int(x));
+      }
+   static void unpack(const char *p, const int size, libbase::gf<m, poly>& x)
+      {
+      int v;
+      framed_element<int>::unpack(p, size, v);
+      x = libbase::gf<m, poly>(v);
+      }
+};
+
+//! Erasable symbols are stored as their integer representation, or -1
+template <class symbol>
+class framed_element<libbase::erasable<symbol> > {
+public:
+   static int size(const libbase::erasable<symbol>& x)
+      {
+      return sizeof(int32_t);
+      }
+   static void pack(char *p, const libbase::erasable<symbol>& x)
+      {
+      framed_element<int>::pack(p, x.is_erased() ? -1 : int(x));
+      }
+   static void unpack(const char *p, const int size,
+         libbase::erasable<symbol>& x)
+      {
+      int v;
+      framed_element<int>::unpack(p, size, v);
+      if (v < 0)
+         {
+         x = libbase::erasable<symbol>();
+         x.erase();
+         }
+      else
+         x = libbase::erasable<symbol>(v);
+      }
+};
+
+//! Signal-space points are stored as the in-phase and quadrature values
+template <>
+class framed_element<sigspace> {
+public:
+   static int size(const sigspace& x)
+      {
+      return 2 * sizeof(double);
+      }
+   static void pack(char *p, const sigspace& x)
+      {
+      const double v[2] = {x.i(), x.q()};
+      memcpy(p, v, sizeof(v));
+      }
+   static void unpack(const char *p, const int size, sigspace& x)
+      {
+      assertalways(size == 2 * sizeof(double));
+      double v[2];
+      memcpy(v, p, sizeof(v));
+      x = sigspace(v[0], v[1]);
+      }
+};
+
+//! Probability tables are stored with the per-symbol vector as one element
+template <>
+class framed_element<libbase::vector<double> > {
+public:
+   static int size(const libbase::vector<double>& x)
+      {
+      return x.size() * sizeof(double);
+      }
+   static void pack(char *p, const libbase::vector<double>& x)
+      {
+      for (int i = 0; i < x.size(); i++, p += sizeof(double))
+         memcpy(p, &x(i), sizeof(double));
+      }
+   static void unpack(const char *p, const int size,
+         libbase::vector<double>& x)
+      {
+      assertalways(size % sizeof(double) == 0);
+      x.init(size / sizeof(double));
+      for (int i = 0; i < x.size(); i++, p += sizeof(double))
+         memcpy(&x(i), p, sizeof(double));
+      }
+};
+
+// internal helpers
+
+namespace framed_stream {
+
+//! Size of frame header in bytes
+const int header_size = 4 + 3 * sizeof(int32_t);
+
+//! Write header and payload for given frame size, element size and data
+inline void write(std::ostream& sout, const int rows, const int cols,
+      const int elsize, const std::vector<char>& payload)
+   {
+   char header[header_size];
+   const int32_t v[3] = {rows, cols, elsize};
+   memcpy(header, "CSFB", 4);
+   memcpy(header + 4, v, sizeof(v));
+   sout.write(header, header_size);
+   if (!payload.empty())
+      sout.write(&payload[0], payload.size());
+   assertalways(sout.good());
+   }
+
+/*! \brief Read header and payload for next frame
+ * \return false if the stream was at end-of-file before the header
+ */
+inline bool read(std::istream& sin, int& rows, int& cols, int& elsize,
+      std::vector<char>& payload)
+   {
+   char header[header_size];
+   sin.read(header, header_size);
+   // a clean end-of-stream is only allowed at a frame boundary
+   if (sin.gcount() == 0 && sin.eof())
+      return false;
+   assertalways(sin.gcount() == header_size);
+   if (memcmp(header, "CSFB", 4) != 0)
+      failwith("Invalid frame header in binary stream");
+   int32_t v[3];
+   memcpy(v, header + 4, sizeof(v));
+   rows = v[0];
+   cols = v[1];
+   elsize = v[2];
+   assertalways(rows >= 0 && cols >= 0 && elsize >= 0);
+   payload.resize(size_t(rows) * cols * elsize);
+   if (!payload.empty())
+      sin.read(&payload[0], payload.size());
+   assertalways(sin.gcount() == std::streamsize(payload.size()));
+   return true;
+   }
+
+} // end namespace
+
+/*! \brief Write a vector as a single binary frame
+ * \note All elements must have the same binary size.
+ */
+template <class T>
+void write_frame(std::ostream& sout, const libbase::vector<T>& x)
+   {
+   const int n = x.size();
+   const int elsize = (n > 0) ? framed_element<T>::size(x(0)) : 0;
+   std::vector<char> payload(size_t(n) * elsize);
+   for (int i = 0; i < n; i++)
+      {
+      assert(framed_element<T>::size(x(i)) == elsize);
+      framed_element<T>::pack(&payload[size_t(i) * elsize], x(i));
+      }
+   framed_stream::write(sout, n, 1, elsize, payload);
+   }
+
+/*! \brief Write a matrix as a single binary frame
+ * \note All elements must have the same binary size.
+ */
+template <class T>
+void write_frame(std::ostream& sout, const libbase::matrix<T>& x)
+   {
+   const int rows = x.size().rows();
+   const int cols = x.size().cols();
+   const int elsize = (rows > 0 && cols > 0) ? framed_element<T>::size(x(0, 0))
+         : 0;
+   std::vector<char> payload(size_t(rows) * cols * elsize);
+   for (int i = 0, k = 0; i < rows; i++)
+      for (int j = 0; j < cols; j++, k++)
+         {
+         assert(framed_element<T>::size(x(i, j)) == elsize);
+         framed_element<T>::pack(&payload[size_t(k) * elsize], x(i, j));
+         }
+   framed_stream::write(sout, rows, cols, elsize, payload);
+   }
+
+/*! \brief Read the next binary frame into a vector
+ * \return false if there are no more frames in the stream
+ */
+template <class T>
+bool read_frame(std::istream& sin, libbase::vector<T>& x)
+   {
+   int rows, cols, elsize;
+   std::vector<char> payload;
+   if (!framed_stream::read(sin, rows, cols, elsize, payload))
+      return false;
+   assertalways(cols == 1);
+   x.init(rows);
+   for (int i = 0; i < rows; i++)
+      framed_element<T>::unpack(&payload[size_t(i) * elsize], elsize, x(i));
+   return true;
+   }
+
+/*! \brief Read the next binary frame into a matrix
+ * \return false if there are no more frames in the stream
+ */
+template <class T>
+bool read_frame(std::istream& sin, libbase::matrix<T>& x)
+   {
+   int rows, cols, elsize;
+   std::vector<char> payload;
+   if (!framed_stream::read(sin, rows, cols, elsize, payload))
+      return false;
+   x.init(rows, cols);
+   for (int i = 0, k = 0; i < rows; i++)
+      for (int j = 0; j < cols; j++, k++)
+         framed_element<T>::unpack(&payload[size_t(k) * elsize], elsize,
+               x(i, j));
+   return true;
+   }
+
+} // end namespace
+
+#endif
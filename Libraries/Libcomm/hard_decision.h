@@ -92,32 +92,38 @@ public:
       // Inherit size
       const int K = ri.size();
       assert(K > 0);
-      // Keep track of maximum value and list of indices
+      // Keep track of maximum value, its first index, and number of indices
       dbl maxval = 0;
-      std::list<int> indices;
-      // Find list of indices with maximum value
+      int first = -1;
+      int count = 0;
+      // Find maximum value and how many indices have it
       for (int i = 0; i < K; i++)
          if (ri(i) > maxval)
             {
             maxval = ri(i);
-            indices.clear();
-            indices.push_back(i);
+            first = i;
+            count = 1;
             }
          else if (ri(i) == maxval)
-            indices.push_back(i);
+            {
+            if (count == 0)
+               first = i;
+            count++;
+            }
       // Return index of maximum value, if there is only one
-      assert(indices.size() > 0);
-      if (indices.size() == 1)
-         return S(indices.front());
+      assert(count > 0);
+      if (count == 1)
+         return S(first);
       // pick randomly in case of ties
 #if DEBUG>=2
       ties++;
 #endif
-      std::list<int>::const_iterator it = indices.begin();
-      const int skip = r.ival(indices.size());
-      for (int i = 0; i < skip; i++)
-         it++;
-      return S(*it);
+      int skip = r.ival(count);
+      int i = first;
+      for (;; i++)
+         if (ri(i) == maxval && skip-- == 0)
+            break;
+      return S(i);
       }
 };
 
@@ -33,7 +33,7 @@ using libbase::matrix;
 
 template <class real>
 onetimepad<real>::onetimepad() :
-   encoder(NULL)
+   encoder(NULL), initialised(false)
    {
    }
 
@@ -41,7 +41,7 @@ template <class real>
 onetimepad<real>::onetimepad(const fsm& encoder, const int tau,
       const bool terminated, const bool renewable) :
    terminated(terminated), renewable(renewable), encoder(
-         dynamic_cast<fsm*> (encoder.clone()))
+         dynamic_cast<fsm*> (encoder.clone())), initialised(false)
    {
    const int k = encoder.num_inputs();
    pad.init(tau * k);
@@ -50,7 +50,8 @@ onetimepad<real>::onetimepad(const fsm& encoder, const int tau,
 template <class real>
 onetimepad<real>::onetimepad(const onetimepad& x) :
    terminated(x.terminated), renewable(x.renewable), encoder(
-         dynamic_cast<fsm*> (x.encoder->clone())), pad(x.pad), r(x.r)
+         dynamic_cast<fsm*> (x.encoder->clone())), pad(x.pad), r(x.r), initialised(
+         x.initialised)
    {
    }
 
@@ -73,8 +74,6 @@ void onetimepad<real>::seedfrom(libbase::random& r)
 template <class real>
 void onetimepad<real>::advance()
    {
-   static bool initialised = false;
-
    // do not advance if this interleaver is not renewable
    if (!renewable && initialised)
       return;
@@ -184,6 +183,7 @@ std::istream& onetimepad<real>::serialize(std::istream& sin)
    int N;
    sin >> libbase::eatcomments >> N >> libbase::verify;
    pad.init(N);
+   initialised = false;
    sin >> libbase::eatcomments >> encoder >> libbase::verify;
    return sin;
    }
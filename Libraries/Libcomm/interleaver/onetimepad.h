@@ -42,6 +42,7 @@ class onetimepad : public interleaver<real> {
    fsm *encoder;
    libbase::vector<int> pad;
    libbase::randgen r;
+   bool initialised; //!< Flag to indicate the pad has been generated
 protected:
    onetimepad();
 public:
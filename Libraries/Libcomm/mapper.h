@@ -25,6 +25,7 @@
 #include "config.h"
 #include "vector.h"
 #include "matrix.h"
+#include "probtable.h"
 #include "serializer.h"
 #include "random.h"
 #include "blockprocess.h"
@@ -73,6 +74,13 @@ private:
 public:
    /*! \name Type definitions */
    typedef libbase::vector<dbl> array1d_t;
+   typedef libbase::probtable<dbl> probtable_t;
+   // @}
+
+private:
+   /*! \name Internal workspace */
+   mutable C<array1d_t> pin_legacy; //!< Input table for legacy mappers
+   mutable C<array1d_t> pout_legacy; //!< Output table for legacy mappers
    // @}
 
 protected:
@@ -94,6 +102,20 @@ protected:
    virtual void dotransform(const C<array1d_t>& pin, C<array1d_t>& pout) const = 0;
    //! \copydoc inverse()
    virtual void doinverse(const C<array1d_t>& pin, C<array1d_t>& pout) const = 0;
+   /*!
+    * \copydoc inverse()
+    *
+    * Default implementation converts to and from tables of vectors, using
+    * the vector interface; derived classes should override this where the
+    * flat tables can be used directly.
+    */
+   virtual void doinverse(const probtable_t& pin, probtable_t& pout) const
+      {
+      pin_legacy.init(output_block_size());
+      pin.copyto(pin_legacy);
+      doinverse(pin_legacy, pout_legacy);
+      pout.copyfrom(pout_legacy);
+      }
    // @}
 
 public:
@@ -164,6 +186,25 @@ public:
       std::cerr << "DEBUG (mapper): inverse pout = " << pout;
 #endif
       }
+   /*!
+    * \brief Inverse-transform the blockmodem receiver probabilities to decoder
+    * input (M->N), using flat tables
+    * \param[in]  pin   Table of likelihoods from demodulator
+    * \param[out] pout  Table of likelihoods for decoder
+    *
+    * \note An empty input table is handled as a special condition
+    *
+    * \note p(i,d) is the a posteriori probability of symbol 'd' at time 'i'
+    */
+   void inverse(const probtable_t& pin, probtable_t& pout) const
+      {
+      advance_if_dirty();
+      if (pin.size() == 0)
+         pout = pin;
+      else
+         doinverse(pin, pout);
+      mark_as_dirty();
+      }
    // @}
 
    /*! \name Setup functions */
@@ -58,6 +58,7 @@ public:
    typedef libbase::vector<dbl> array1d_t;
    typedef libbase::vector<int> array1i_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 
 protected:
@@ -82,6 +83,10 @@ protected:
       {
       pout = pin;
       }
+   void doinverse(const probtable_t& pin, probtable_t& pout) const
+      {
+      pout = pin;
+      }
 
 public:
    // Description
@@ -112,6 +117,7 @@ public:
    typedef libbase::vector<dbl> array1d_t;
    typedef libbase::matrix<int> array2i_t;
    typedef libbase::matrix<array1d_t> array2vd_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 
 protected:
@@ -136,6 +142,10 @@ protected:
       {
       pout = pin;
       }
+   void doinverse(const probtable_t& pin, probtable_t& pout) const
+      {
+      pout = pin;
+      }
 
 public:
    // Description
@@ -53,20 +53,33 @@ void direct_blockmodem_implementation<G, vector, dbl>::dodemodulate(
    {
    // Inherit sizes
    const int M = this->num_symbols();
-   // Allocate space for temporary results
-   vector<vector<double> > ptable_double;
-      {
-      // Create a matrix of all possible transmitted symbols
-      vector<G> tx(M);
-      for (int x = 0; x < M; x++)
-         tx(x) = Implementation::modulate(x);
-      // Work out the probabilities of each possible signal
-      chan.receive(tx, rx, ptable_double);
-      }
+   // Create a matrix of all possible transmitted symbols
+   vector<G> tx(M);
+   for (int x = 0; x < M; x++)
+      tx(x) = Implementation::modulate(x);
+   // Work out the probabilities of each possible signal
+   chan.receive(tx, rx, ptable_double);
    // Convert result
    ptable = ptable_double;
    }
 
+template <class G, class dbl>
+void direct_blockmodem_implementation<G, vector, dbl>::dodemodulate(
+      const channel<G, vector>& chan, const vector<G>& rx,
+      probtable_t& ptable)
+   {
+   // Inherit sizes
+   const int M = this->num_symbols();
+   // Create a matrix of all possible transmitted symbols
+   vector<G> tx(M);
+   for (int x = 0; x < M; x++)
+      tx(x) = Implementation::modulate(x);
+   // Work out the probabilities of each possible signal
+   chan.receive(tx, rx, ptable_flat);
+   // Convert result
+   ptable.copyfrom(ptable_flat);
+   }
+
 // *** Templated GF(q) blockmodem ***
 
 // Description
@@ -55,6 +55,14 @@ public:
    /*! \name Type definitions */
    typedef direct_modem_implementation<G> Implementation;
    typedef libbase::vector<dbl> array1d_t;
+   typedef libbase::probtable<dbl> probtable_t;
+   // @}
+private:
+   /*! \name Internal object representation */
+   //! Channel likelihoods, kept between frames to avoid reallocation
+   libbase::vector<libbase::vector<double> > ptable_double;
+   //! Channel likelihoods as a flat table, kept between frames
+   libbase::probtable<double> ptable_flat;
    // @}
 protected:
    // Interface with derived classes
@@ -62,6 +70,8 @@ protected:
          libbase::vector<G>& tx);
    void dodemodulate(const channel<G, libbase::vector>& chan,
          const libbase::vector<G>& rx, libbase::vector<array1d_t>& ptable);
+   void dodemodulate(const channel<G, libbase::vector>& chan,
+         const libbase::vector<G>& rx, probtable_t& ptable);
 };
 
 /*!
@@ -83,6 +93,7 @@ public:
    /*! \name Type definitions */
    typedef direct_blockmodem_implementation<G, C, dbl> Implementation;
    typedef libbase::vector<dbl> array1d_t;
+   typedef libbase::probtable<dbl> probtable_t;
    // @}
 protected:
    // Interface with derived classes
@@ -102,6 +113,14 @@ protected:
       // De-reference
       Implementation::dodemodulate(chan, rx, ptable);
       }
+   void dodemodulate(const channel<G, C>& chan, const C<G>& rx,
+         probtable_t& ptable)
+      {
+      // Check validity
+      assertalways(rx.size() == this->input_block_size());
+      // De-reference
+      Implementation::dodemodulate(chan, rx, ptable);
+      }
 
 public:
    // Use implementation from base
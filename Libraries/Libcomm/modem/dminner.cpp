@@ -169,29 +169,23 @@ void dminner<real>::checkforchanges(int m1_min, int m1_max, int mn_min,
       int mn_max, int mtau_min, int mtau_max) const
    {
 #ifndef NDEBUG
-   static int last_m1_min = 0;
-   static int last_m1_max = 0;
-   if (last_m1_min != m1_min || last_m1_max != m1_max)
+   if (last.m1_min != m1_min || last.m1_max != m1_max)
       {
       std::cerr << "DEBUG (dminner): m1_min = " << m1_min << ", m1_max = " << m1_max << std::endl;
-      last_m1_min = m1_min;
-      last_m1_max = m1_max;
+      last.m1_min = m1_min;
+      last.m1_max = m1_max;
       }
-   static int last_mn_min = 0;
-   static int last_mn_max = 0;
-   if (last_mn_min != mn_min || last_mn_max != mn_max)
+   if (last.mn_min != mn_min || last.mn_max != mn_max)
       {
       std::cerr << "DEBUG (dminner): mn_min = " << mn_min << ", mn_max = " << mn_max << std::endl;
-      last_mn_min = mn_min;
-      last_mn_max = mn_max;
+      last.mn_min = mn_min;
+      last.mn_max = mn_max;
       }
-   static int last_mtau_min = 0;
-   static int last_mtau_max = 0;
-   if (last_mtau_min != mtau_min || last_mtau_max != mtau_max)
+   if (last.mtau_min != mtau_min || last.mtau_max != mtau_max)
       {
       std::cerr << "DEBUG (dminner): mtau_min = " << mtau_min << ", mtau_max = " << mtau_max << std::endl;
-      last_mtau_min = mtau_min;
-      last_mtau_max = mtau_max;
+      last.mtau_min = mtau_min;
+      last.mtau_max = mtau_max;
       }
 #endif
    }
@@ -294,6 +288,10 @@ void dminner<real>::normalize_results(const array1vr_t& in, array1vd_t& out) con
 template <class real>
 void dminner<real>::init()
    {
+   // Clear the record of reported state space limits
+   last.m1_min = last.m1_max = 0;
+   last.mn_min = last.mn_max = 0;
+   last.mtau_min = last.mtau_max = 0;
    // Fill default codebook if necessary
    if (codebook_type == codebook_sparse)
       {
@@ -105,6 +105,11 @@ private:
    qids<bool,float> mychan; //!< bound channel object
    mutable libbase::randgen r; //!< marker sequence generator
    mutable array1i_t marker; //!< marker sequence
+   mutable struct {
+      int m1_min, m1_max;
+      int mn_min, mn_max;
+      int mtau_min, mtau_max;
+   } last; //!< state space limits last reported by checkforchanges()
    // @}
 private:
    // Implementations of channel-specific metrics for fba
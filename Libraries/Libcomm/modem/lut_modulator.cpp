@@ -70,14 +70,19 @@ void lut_modulator::dodemodulate(const channel<sigspace>& chan,
    {
    // Check validity
    assertalways(rx.size() == this->input_block_size());
-   // Inherit sizes
-   const int M = this->num_symbols();
-   // Create a matrix of all possible transmitted symbols
-   libbase::vector<sigspace> tx(M);
-   for (int x = 0; x < M; x++)
-      tx(x) = this->modulate(x);
-   // Work out the probabilities of each possible signal
-   chan.receive(tx, rx, ptable);
+   // Work out the probabilities of each possible signal, using the table of
+   // all possible transmitted symbols
+   chan.receive(lut, rx, ptable);
+   }
+
+void lut_modulator::dodemodulate(const channel<sigspace>& chan,
+      const libbase::vector<sigspace>& rx, probtable_t& ptable)
+   {
+   // Check validity
+   assertalways(rx.size() == this->input_block_size());
+   // Work out the probabilities of each possible signal, using the table of
+   // all possible transmitted symbols
+   chan.receive(lut, rx, ptable);
    }
 
 void lut_modulator::dodemodulate(const channel<sigspace>& chan,
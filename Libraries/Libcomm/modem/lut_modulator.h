@@ -36,6 +36,7 @@ public:
    /*! \name Type definitions */
    typedef informed_modulator<sigspace> Base;
    typedef libbase::vector<double> array1d_t;
+   typedef libbase::probtable<double> probtable_t;
    // @}
 
 protected:
@@ -48,6 +49,8 @@ protected:
    void dodemodulate(const channel<sigspace>& chan,
          const libbase::vector<sigspace>& rx,
          libbase::vector<array1d_t>& ptable);
+   void dodemodulate(const channel<sigspace>& chan,
+         const libbase::vector<sigspace>& rx, probtable_t& ptable);
    void dodemodulate(const channel<sigspace>& chan,
          const libbase::vector<sigspace>& rx,
          const libbase::vector<array1d_t>& app,
@@ -192,6 +192,52 @@ void marker<sig, real, real2>::dodemodulate(const channel<sig>& chan,
    {
    // Initialize for known-start
    init(chan);
+   // Delegate
+   demodulate_known(chan, rx, app, ptable);
+   }
+
+/*!
+ * \brief Demodulate a batch of frames with known boundaries
+ * \param[in]  chan     The channel model (used to obtain likelihoods)
+ * \param[in]  rx       Set of received frames
+ * \param[in]  app      Set of a-priori tables, one per frame (may be empty)
+ * \param[out] ptable   Set of posterior tables, one per frame
+ *
+ * Results are identical to separate calls to demodulate() for each frame in
+ * sequence; the channel set-up and FBA initialization are done once for the
+ * whole batch, so that allocated tables are reused across frames. The system
+ * is advanced before each frame as necessary.
+ */
+template <class sig, class real, class real2>
+void marker<sig, real, real2>::demodulate_known(const channel<sig>& chan,
+      const array1vs_t& rx, const array1vvd_t& app, array1vvd_t& ptable)
+   {
+   const int K = rx.size();
+   assertalways(app.size() == 0 || app.size() == K);
+   const array1vd_t no_app; // empty APP table
+   ptable.init(K);
+   for (int k = 0; k < K; k++)
+      {
+      this->advance_if_dirty();
+      // Initialize for known-start (independent of frame contents)
+      if (k == 0)
+         init(chan);
+      demodulate_known(chan, rx(k), app.size() > 0 ? app(k) : no_app,
+            ptable(k));
+      this->mark_as_dirty();
+      }
+   }
+
+/*!
+ * \brief Demodulate a frame with known boundaries
+ *
+ * This method assumes that the init() method has already been called for
+ * known-start decoding.
+ */
+template <class sig, class real, class real2>
+void marker<sig, real, real2>::demodulate_known(const channel<sig>& chan,
+      const array1s_t& rx, const array1vd_t& app, array1vd_t& ptable)
+   {
    // Shorthand for transmitted and received frame sizes
    const int tau = this->output_block_size();
    const int rho = rx.size();
@@ -353,6 +399,9 @@ void marker<sig, real, real2>::init()
    // Seed the generator and clear the per-frame sequence of markers
    r.seed(0);
    frame_marker_sequence.init(0);
+   // Clear the record of reported state space limits
+   last.m1_min = last.m1_max = 0;
+   last.mtau_min = last.mtau_max = 0;
    // Check that everything makes sense
    test_invariant();
    }
@@ -375,21 +424,17 @@ template <class sig, class real, class real2>
 void marker<sig, real, real2>::checkforchanges(int m1_min, int m1_max, int mtau_min, int mtau_max) const
    {
 #ifndef NDEBUG
-   static int last_m1_min = 0;
-   static int last_m1_max = 0;
-   if (last_m1_min != m1_min || last_m1_max != m1_max)
+   if (last.m1_min != m1_min || last.m1_max != m1_max)
       {
       std::cerr << "DEBUG (marker): m1_min = " << m1_min << ", m1_max = " << m1_max << std::endl;
-      last_m1_min = m1_min;
-      last_m1_max = m1_max;
+      last.m1_min = m1_min;
+      last.m1_max = m1_max;
       }
-   static int last_mtau_min = 0;
-   static int last_mtau_max = 0;
-   if (last_mtau_min != mtau_min || last_mtau_max != mtau_max)
+   if (last.mtau_min != mtau_min || last.mtau_max != mtau_max)
       {
       std::cerr << "DEBUG (marker): mtau_min = " << mtau_min << ", mtau_max = " << mtau_max << std::endl;
-      last_mtau_min = mtau_min;
-      last_mtau_max = mtau_max;
+      last.mtau_min = mtau_min;
+      last.mtau_max = mtau_max;
       }
 #endif
    }
@@ -70,6 +70,7 @@ public:
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<real> array1r_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::vector<array1vd_t> array1vvd_t;
    typedef libbase::vector<array1r_t> array1vr_t;
    enum marker_t {
       marker_random = 0, //!< random marker sequence
@@ -93,6 +94,10 @@ private:
    mutable libbase::randgen r; //!< for construction and random application of markers
    mutable array1vs_t frame_marker_sequence; //!< per-frame sequence of markers
    fba_generic<sig, real, real2> fba; //!< algorithm object
+   mutable struct {
+      int m1_min, m1_max;
+      int mtau_min, mtau_max;
+   } last; //!< state space limits last reported by checkforchanges()
    // @}
 private:
    // Atomic modem operations (private as these should never be used)
@@ -124,7 +129,17 @@ protected:
          const array1d_t& sof_prior, const array1d_t& eof_prior,
          const array1vd_t& app, array1vd_t& ptable, array1d_t& sof_post,
          array1d_t& eof_post, const libbase::size_type<libbase::vector> offset);
+   void dodemodulate_batch(const channel<sig>& chan, const array1vs_t& rx,
+         array1vvd_t& ptable)
+      {
+      const array1vvd_t app; // empty APP tables
+      demodulate_known(chan, rx, app, ptable);
+      }
    // Internal methods
+   void demodulate_known(const channel<sig>& chan, const array1s_t& rx,
+         const array1vd_t& app, array1vd_t& ptable);
+   void demodulate_known(const channel<sig>& chan, const array1vs_t& rx,
+         const array1vvd_t& app, array1vvd_t& ptable);
    array1s_t select_marker(const int i) const;
    void fill_frame_marker_sequence(array1vs_t& frame_marker_sequence,
          const int offset, const int length) const;
@@ -188,6 +203,17 @@ public:
       return (d + m) / double(d);
       }
 
+   // Block modem operations - batch extensions
+   using stream_modulator<sig>::demodulate_batch;
+   void demodulate_batch(const channel<sig>& chan, const array1vs_t& rx,
+         const array1vvd_t& app, array1vvd_t& ptable)
+      {
+      this->test_invariant();
+      libbase::cputimer t("t_demodulate");
+      demodulate_known(chan, rx, app, ptable);
+      this->add_timer(t);
+      }
+
    // Block modem operations - streaming extensions
    void get_post_drift_pdf(array1vd_t& pdftable,
          libbase::size_type<libbase::vector>& offset) const
@@ -55,6 +55,10 @@ private:
    mutable array2vs_t encoding_table; //!< Local copy of per-frame encoding table
    std::auto_ptr<typename channel_insdel<sig, real2>::metric_computer> computer; //!< Channel object for computing receiver metric
    // @}
+   /*! \name Internal working space */
+   mutable array1r2_t ptable0_r; //!< Receiver results in internal format (end without deletion)
+   mutable array1r2_t ptable1_r; //!< Receiver results in internal format (end with deletion)
+   // @}
 public:
    /*! \name User initialization (can be adapted for needs of user class) */
    /*! \brief Set up channel receiver
@@ -83,7 +87,6 @@ public:
       // 'tx' is the vector of transmitted symbols that we're considering
       const array1s_t& tx = encoding_table(i, d);
       // set up space for results
-      static array1r2_t ptable0_r, ptable1_r;
       ptable0_r.init(ptable0.size());
       ptable1_r.init(ptable1.size());
       // call batch receiver method
@@ -64,6 +64,9 @@ private:
    mutable array2vs_t encoding_table; //!< Local copy of per-frame encoding table
    std::auto_ptr<typename channel_insdel<sig, real2>::metric_computer> computer; //!< Channel object for computing receiver metric
    // @}
+   /*! \name Internal working space */
+   mutable array1r2_t ptable_r; //!< Receiver results in internal format
+   // @}
 public:
    /*! \name User initialization (can be adapted for needs of user class) */
    /*! \brief Set up channel receiver
@@ -102,10 +105,18 @@ public:
    void R(int d, int i, const array1s_t& r, const array1vd_t& app,
          array1r_t& ptable) const
       {
+      R(d, i, r, app, ptable, ptable_r);
+      }
+   /*! \brief Batch receiver interface, using given working space
+    * This allows concurrent use by separate threads, each with its own
+    * working space.
+    */
+   void R(int d, int i, const array1s_t& r, const array1vd_t& app,
+         array1r_t& ptable, array1r2_t& ptable_r) const
+      {
       // 'tx' is the vector of transmitted symbols that we're considering
       const array1s_t& tx = encoding_table(i, d);
       // set up space for results
-      static array1r2_t ptable_r;
       ptable_r.init(ptable.size());
       // call batch receiver method
       computer->receive(tx, r, ptable_r);
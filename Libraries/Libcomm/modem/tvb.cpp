@@ -266,6 +266,52 @@ void tvb<sig, real, real2>::dodemodulate(const channel<sig>& chan,
    {
    // Initialize for known-start
    init(chan);
+   // Delegate
+   demodulate_known(chan, rx, app, ptable);
+   }
+
+/*!
+ * \brief Demodulate a batch of frames with known boundaries
+ * \param[in]  chan     The channel model (used to obtain likelihoods)
+ * \param[in]  rx       Set of received frames
+ * \param[in]  app      Set of a-priori tables, one per frame (may be empty)
+ * \param[out] ptable   Set of posterior tables, one per frame
+ *
+ * Results are identical to separate calls to demodulate() for each frame in
+ * sequence; the channel set-up and FBA initialization are done once for the
+ * whole batch, so that allocated tables are reused across frames. The system
+ * is advanced before each frame as necessary.
+ */
+template <class sig, class real, class real2>
+void tvb<sig, real, real2>::demodulate_known(const channel<sig>& chan,
+      const array1vs_t& rx, const array1vvd_t& app, array1vvd_t& ptable)
+   {
+   const int K = rx.size();
+   assertalways(app.size() == 0 || app.size() == K);
+   const array1vd_t no_app; // empty APP table
+   ptable.init(K);
+   for (int k = 0; k < K; k++)
+      {
+      this->advance_if_dirty();
+      // Initialize for known-start (independent of frame contents)
+      if (k == 0)
+         init(chan);
+      demodulate_known(chan, rx(k), app.size() > 0 ? app(k) : no_app,
+            ptable(k));
+      this->mark_as_dirty();
+      }
+   }
+
+/*!
+ * \brief Demodulate a frame with known boundaries
+ *
+ * This method assumes that the init() method has already been called for
+ * known-start decoding.
+ */
+template <class sig, class real, class real2>
+void tvb<sig, real, real2>::demodulate_known(const channel<sig>& chan,
+      const array1s_t& rx, const array1vd_t& app, array1vd_t& ptable)
+   {
    // Shorthand for transmitted and received frame sizes
    const int tau = this->output_block_size();
    const int rho = rx.size();
@@ -426,8 +472,7 @@ void tvb<sig, real, real2>::init(const channel<sig>& chan,
          m1_min, m1_max);
    checkforchanges(m1_min, m1_max, mn_min, mn_max, mtau_min, mtau_max);
    //! Determine whether to use global storage
-   static bool globalstore = false; // set to avoid compiler warning
-   bool last_globalstore = globalstore; // keep track of last setting
+   const bool last_globalstore = globalstore; // keep track of last setting
    const int required = fba_type::get_memory_required(N, q, mtau_min, mtau_max,
          mn_min, mn_max);
    switch (storage_type)
@@ -445,6 +490,12 @@ void tvb<sig, real, real2>::init(const channel<sig>& chan,
          checkforchanges(globalstore, required);
          break;
 
+      case storage_windowed:
+         // drift pdf is not kept at every codeword boundary
+         assertalways(lookahead == 0);
+         globalstore = false;
+         break;
+
       default:
          failwith("Unknown storage mode");
          break;
@@ -460,6 +511,7 @@ void tvb<sig, real, real2>::init(const channel<sig>& chan,
       changed_encoding_table = true;
       }
    // Initialize forward-backward algorithm
+   fba_ptr->set_window(storage_type == storage_windowed ? window : 0);
    fba_ptr->init(N, q, mtau_min, mtau_max, mn_min, mn_max, m1_min, m1_max,
          th_inner, th_outer, mychan->get_computer());
 #ifndef NDEBUG
@@ -481,6 +533,15 @@ void tvb<sig, real, real2>::init()
    // Seed the generator and clear the per-frame encoding table
    r.seed(0);
    encoding_table.init(0, 0);
+   // Reset storage mode and the record of reported settings
+   // (the algorithm object is recreated when next needed)
+   fba_ptr.reset();
+   globalstore = false;
+   last.m1_min = last.m1_max = 0;
+   last.mn_min = last.mn_max = 0;
+   last.mtau_min = last.mtau_max = 0;
+   last.globalstore = false;
+   last.reported = false;
    // Check that everything makes sense
    test_invariant();
    }
@@ -660,29 +721,23 @@ void tvb<sig, real, real2>::checkforchanges(int m1_min, int m1_max, int mn_min,
       int mn_max, int mtau_min, int mtau_max) const
    {
 #ifndef NDEBUG
-   static int last_m1_min = 0;
-   static int last_m1_max = 0;
-   if (last_m1_min != m1_min || last_m1_max != m1_max)
+   if (last.m1_min != m1_min || last.m1_max != m1_max)
       {
       std::cerr << "DEBUG (tvb): m1_min = " << m1_min << ", m1_max = " << m1_max << std::endl;
-      last_m1_min = m1_min;
-      last_m1_max = m1_max;
+      last.m1_min = m1_min;
+      last.m1_max = m1_max;
       }
-   static int last_mn_min = 0;
-   static int last_mn_max = 0;
-   if (last_mn_min != mn_min || last_mn_max != mn_max)
+   if (last.mn_min != mn_min || last.mn_max != mn_max)
       {
       std::cerr << "DEBUG (tvb): mn_min = " << mn_min << ", mn_max = " << mn_max << std::endl;
-      last_mn_min = mn_min;
-      last_mn_max = mn_max;
+      last.mn_min = mn_min;
+      last.mn_max = mn_max;
       }
-   static int last_mtau_min = 0;
-   static int last_mtau_max = 0;
-   if (last_mtau_min != mtau_min || last_mtau_max != mtau_max)
+   if (last.mtau_min != mtau_min || last.mtau_max != mtau_max)
       {
       std::cerr << "DEBUG (tvb): mtau_min = " << mtau_min << ", mtau_max = " << mtau_max << std::endl;
-      last_mtau_min = mtau_min;
-      last_mtau_max = mtau_max;
+      last.mtau_min = mtau_min;
+      last.mtau_max = mtau_max;
       }
 #endif
    }
@@ -692,9 +747,7 @@ void tvb<sig, real, real2>::checkforchanges(int m1_min, int m1_max, int mn_min,
 template <class sig, class real, class real2>
 void tvb<sig, real, real2>::checkforchanges(bool globalstore, int required) const
    {
-   static bool first_time = true;
-   static bool last_globalstore = false;
-   if (first_time || last_globalstore != globalstore)
+   if (!last.reported || last.globalstore != globalstore)
       {
       std::cerr << "FBA Global Store ";
       if (globalstore)
@@ -702,8 +755,8 @@ void tvb<sig, real, real2>::checkforchanges(bool globalstore, int required) cons
       else
          std::cerr << "Disabled";
       std::cerr << ", Required: " << required << "MiB" << std::endl;
-      last_globalstore = globalstore;
-      first_time = false;
+      last.globalstore = globalstore;
+      last.reported = true;
       }
    }
 
@@ -785,6 +838,10 @@ std::string tvb<sig, real, real2>::description() const
          sout << ", global storage [≤" << globalstore_limit << " MiB]";
          break;
 
+      case storage_windowed:
+         sout << ", windowed storage [" << window << " codewords]";
+         break;
+
       default:
          failwith("Unknown storage mode");
          break;
@@ -807,7 +864,7 @@ template <class sig, class real, class real2>
 std::ostream& tvb<sig, real, real2>::serialize(std::ostream& sout) const
    {
    sout << "# Version" << std::endl;
-   sout << 11 << std::endl;
+   sout << 12 << std::endl;
    sout << "# Inner threshold" << std::endl;
    sout << th_inner << std::endl;
    sout << "# Outer threshold" << std::endl;
@@ -816,13 +873,18 @@ std::ostream& tvb<sig, real, real2>::serialize(std::ostream& sout) const
    sout << Pr << std::endl;
    sout << "# Lazy computation of gamma?" << std::endl;
    sout << flags.lazy << std::endl;
-   sout << "# Storage mode for gamma (0=local, 1=global, 2=conditional)" << std::endl;
+   sout << "# Storage mode for gamma (0=local, 1=global, 2=conditional, 3=windowed)" << std::endl;
    sout << storage_type << std::endl;
    if (storage_type == storage_conditional)
       {
       sout << "#: Memory threshold for global storage (in MiB)" << std::endl;
       sout << globalstore_limit << std::endl;
       }
+   else if (storage_type == storage_windowed)
+      {
+      sout << "#: Window size (in codewords)" << std::endl;
+      sout << window << std::endl;
+      }
    sout << "# Number of codewords to look ahead when stream decoding"
          << std::endl;
    sout << lookahead << std::endl;
@@ -910,6 +972,8 @@ std::ostream& tvb<sig, real, real2>::serialize(std::ostream& sout) const
  * \version 11 Added support for codebooks with different codeword length;
  *      removed internal representation of user-defined marker sequences
  *      (use separate codebooks instead)
+ *
+ * \version 12 Added windowed storage mode, with window size
  */
 
 template <class sig, class real, class real2>
@@ -955,6 +1019,12 @@ std::istream& tvb<sig, real, real2>::serialize(std::istream& sin)
       storage_type = (storage_t) temp;
       if (storage_type == storage_conditional)
          sin >> libbase::eatcomments >> globalstore_limit >> libbase::verify;
+      else if (storage_type == storage_windowed)
+         {
+         assertalways(version >= 12);
+         sin >> libbase::eatcomments >> window >> libbase::verify;
+         assertalways(window > 0);
+         }
       }
    else if ((version >= 2 && flags.lazy) || version >= 3)
       {
@@ -1110,6 +1180,7 @@ std::istream& tvb<sig, real, real2>::serialize(std::istream& sin)
 #include "gf.h"
 #include "mpgnu.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 namespace libcomm {
 
@@ -1123,6 +1194,7 @@ namespace libcomm {
 using libbase::serializer;
 using libbase::mpgnu;
 using libbase::logrealfast;
+using libbase::logrealsimd;
 
 #define USING_GF(r, x, type) \
       using libbase::type;
@@ -1141,6 +1213,7 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
 #define REAL_PAIRS_SEQ \
    ((mpgnu)(mpgnu)) \
    ((logrealfast)(logrealfast)) \
+   ((logrealsimd)(double)) \
    ((double)(double)) \
    ((double)(float)) \
    ((float)(float))
@@ -1149,7 +1222,7 @@ BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
 /* Serialization string: tvb<type,real,real2>
  * where:
  *      type = bool | gf2 | gf4 ...
- *      real = float | double | [logrealfast | mpgnu (CPU only)]
+ *      real = float | double | [logrealfast | logrealsimd | mpgnu (CPU only)]
  *      real2 = float | double | [logrealfast | mpgnu (CPU only)]
  */
 #define INSTANTIATE3(args) \
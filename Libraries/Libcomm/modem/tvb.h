@@ -68,6 +68,7 @@ public:
    typedef libbase::vector<double> array1d_t;
    typedef libbase::vector<real> array1r_t;
    typedef libbase::vector<array1d_t> array1vd_t;
+   typedef libbase::vector<array1vd_t> array1vvd_t;
    typedef libbase::vector<array1r_t> array1vr_t;
    enum codebook_t {
       codebook_sparse = 0, //!< sparse codes of length 'n', as in DM construction
@@ -87,6 +88,7 @@ public:
       storage_local = 0, //!< always use local storage
       storage_global, //!< always use global storage
       storage_conditional, //!< use global storage below memory limit
+      storage_windowed, //!< use local storage, keeping forward metric only at window boundaries
       storage_undefined
    };
    // @}
@@ -105,6 +107,7 @@ private:
    } flags;
    storage_t storage_type; //!< enum indicating storage mode for gamma metric
    int globalstore_limit; //!< fba memory threshold in MiB for global storage, if applicable
+   int window; //!< fba window size in codewords for windowed storage, if applicable
    int lookahead; //!< Number of codewords to look ahead when stream decoding
    // @}
    /*! \name Internally-used objects */
@@ -116,6 +119,14 @@ private:
    int mtau_max; //!< The largest positive drift within a whole frame is \f$ m_\tau^{+} \f$
    typedef fba2_interface<sig, real, real2> fba_type;
    boost::shared_ptr<fba_type> fba_ptr; //!< pointer to algorithm object
+   bool globalstore; //!< flag indicating global storage of gamma in algorithm object
+   mutable struct {
+      int m1_min, m1_max;
+      int mn_min, mn_max;
+      int mtau_min, mtau_max;
+      bool globalstore;
+      bool reported;
+   } last; //!< settings last reported by checkforchanges()
    // @}
 private:
    // Atomic modem operations (private as these should never be used)
@@ -147,7 +158,17 @@ protected:
          const array1d_t& sof_prior, const array1d_t& eof_prior,
          const array1vd_t& app, array1vd_t& ptable, array1d_t& sof_post,
          array1d_t& eof_post, const libbase::size_type<libbase::vector> offset);
+   void dodemodulate_batch(const channel<sig>& chan, const array1vs_t& rx,
+         array1vvd_t& ptable)
+      {
+      const array1vvd_t app; // empty APP tables
+      demodulate_known(chan, rx, app, ptable);
+      }
    // Internal methods
+   void demodulate_known(const channel<sig>& chan, const array1s_t& rx,
+         const array1vd_t& app, array1vd_t& ptable);
+   void demodulate_known(const channel<sig>& chan, const array1vs_t& rx,
+         const array1vvd_t& app, array1vvd_t& ptable);
    int select_codebook(const int i) const;
    array1s_t select_marker(const int i, const int n) const;
    void fill_encoding_table(array2vs_t& encoding_table, const int offset,
@@ -237,10 +258,10 @@ public:
          q(x.q), marker_type(x.marker_type), codebook_type(x.codebook_type), codebook_name(
                x.codebook_name), codebook_tables(x.codebook_tables), th_inner(
                x.th_inner), th_outer(x.th_outer), Pr(x.Pr), flags(x.flags), storage_type(
-               x.storage_type), globalstore_limit(x.globalstore_limit), lookahead(
+               x.storage_type), globalstore_limit(x.globalstore_limit), window(x.window), lookahead(
                x.lookahead), r(x.r), encoding_table(x.encoding_table), changed_encoding_table(
                x.changed_encoding_table), mtau_min(x.mtau_min), mtau_max(
-               x.mtau_max)
+               x.mtau_max), globalstore(x.globalstore), last(x.last)
       {
       if (x.mychan.get())
          mychan.reset(dynamic_cast<channel_insdel<sig, real2>*> (x.mychan->clone()));
@@ -306,6 +327,17 @@ public:
       return get_avg_codeword_length();
       }
 
+   // Block modem operations - batch extensions
+   using stream_modulator<sig>::demodulate_batch;
+   void demodulate_batch(const channel<sig>& chan, const array1vs_t& rx,
+         const array1vvd_t& app, array1vvd_t& ptable)
+      {
+      this->test_invariant();
+      libbase::cputimer t("t_demodulate");
+      demodulate_known(chan, rx, app, ptable);
+      this->add_timer(t);
+      }
+
    // Block modem operations - streaming extensions
    void get_post_drift_pdf(array1vd_t& pdftable,
          libbase::size_type<libbase::vector>& offset) const
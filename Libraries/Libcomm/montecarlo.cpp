@@ -25,9 +25,14 @@
 #include "fsm.h"
 #include "itfunc.h"
 #include "randgen.h"
+#include "philox.h"
 #include <sstream>
 #include <limits>
 
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
+
 namespace libcomm {
 
 using std::cerr;
@@ -53,13 +58,15 @@ void montecarlo::slave_getcode(void)
    cerr << "Date: " << libbase::timer::date() << std::endl;
    cerr << system->description() << std::endl;
    cerr << "Digest: " << std::string(sysdigest) << std::endl;
+   // Seed the experiment here, so that a later change of parameter continues
+   // with the same random streams, rather than repeating them
+   seed_experiment();
    }
 
 void montecarlo::slave_getparameter(void)
    {
    cerr << "Date: " << libbase::timer::date() << std::endl;
 
-   seed_experiment();
    double x;
    if (!receive(x))
       exit(1);
@@ -71,23 +78,31 @@ void montecarlo::slave_getparameter(void)
 
 void montecarlo::slave_work(void)
    {
+   // Get number of samples to compute (zero to use the default time budget)
+   libbase::int64u samples;
+   if (!receive(samples))
+      exit(1);
+
    // Initialise running values
    system->reset();
 
-   // Iterate for 500ms, which is a good compromise between efficiency and usability
    libbase::walltimer tslave("montecarlo_slave");
-   while (tslave.elapsed() < 0.5)
-      sampleandaccumulate();
+   if (samples == 0)
+      {
+      // Iterate for 500ms, which is a good compromise between efficiency and usability
+      while (tslave.elapsed() < 0.5)
+         sampleandaccumulate();
+      }
+   else
+      {
+      for (libbase::int64u i = 0; i < samples; i++)
+         sampleandaccumulate();
+      }
+   const double elapsed = tslave.elapsed();
    tslave.stop(); // to avoid expiry
 
-   // Send system digest and current parameter back to master
-   assertalways(send(sysdigest));
-   assertalways(send(system->get_parameter()));
-   // Send accumulated results back to master
-   libbase::vector<double> state;
-   system->get_state(state);
-   assertalways(send(system->get_samplecount()));
-   assertalways(send(state));
+   // Send results back to master as a single frame
+   assertalways(send(packresults(elapsed)));
 
    // print something to inform the user of our progress
    vector<double> result, errormargin;
@@ -97,6 +112,68 @@ void montecarlo::slave_work(void)
 
 // helper functions
 
+/*! \brief Pack the results of a work unit into a binary frame
+ * \param   elapsed  Wall-clock time taken by the work unit
+ *
+ * The frame contains the system digest, the current parameter, the sample
+ * count, the time taken, the CPU time used since the last report, and the
+ * accumulated state, so that results are returned to the master in a single
+ * transfer.
+ */
+std::string montecarlo::packresults(double elapsed)
+   {
+   std::string frame;
+   // system digest and current parameter
+   const std::string digest = sysdigest;
+   pack(frame, int(digest.length()));
+   frame += digest;
+   pack(frame, system->get_parameter());
+   // sample count, timing and usage information
+   pack(frame, system->get_samplecount());
+   pack(frame, elapsed);
+   pack(frame, claimcputime());
+   // accumulated results
+   libbase::vector<double> state;
+   system->get_state(state);
+   pack(frame, state.size().length());
+   for (int i = 0; i < state.size(); i++)
+      pack(frame, state(i));
+   return frame;
+   }
+
+/*! \brief Unpack the results of a work unit from a binary frame
+ * \return False if the frame is malformed, in which case the output values
+ * are undefined
+ * \sa packresults()
+ */
+bool montecarlo::unpackresults(const std::string& frame, std::string& digest,
+      double& parameter, libbase::int64u& samplecount, double& elapsed,
+      double& cputime, libbase::vector<double>& state)
+   {
+   size_t pos = 0;
+   // system digest and current parameter
+   int len;
+   if (!unpack(frame, pos, len) || len < 0 || pos + len > frame.length())
+      return false;
+   digest = frame.substr(pos, len);
+   pos += len;
+   if (!unpack(frame, pos, parameter))
+      return false;
+   // sample count, timing and usage information
+   if (!unpack(frame, pos, samplecount) || !unpack(frame, pos, elapsed)
+         || !unpack(frame, pos, cputime))
+      return false;
+   // accumulated results
+   int count;
+   if (!unpack(frame, pos, count) || count < 0
+         || pos + count * sizeof(double) != frame.length())
+      return false;
+   state.init(count);
+   for (int i = 0; i < count; i++)
+      unpack(frame, pos, state(i));
+   return true;
+   }
+
 std::string montecarlo::get_systemstring()
    {
    std::ostringstream os;
@@ -117,6 +194,130 @@ void montecarlo::seed_experiment()
    cerr << "Seed: " << seed << std::endl;
    }
 
+/*! \brief Create the per-thread copies of the system for local sampling
+ * \param   systemstring   Serialized system description
+ *
+ * Each worker is created from the serialized system, as is done for slaves,
+ * so that no state is shared with the master copy. Each worker is seeded
+ * from its own substream of a counter-based PRNG keyed with the stored seed,
+ * so that the seeds of a worker depend only on the stored seed and the
+ * worker index; results are repeatable for a given seed and thread count.
+ */
+void montecarlo::createworkers(const std::string& systemstring)
+   {
+   assert(workers.empty());
+   libbase::philox prng;
+   prng.seed(seed);
+   for (int i = 0; i < threads; i++)
+      {
+      prng.set_substream(i);
+      experiment *worker;
+      std::istringstream is(systemstring);
+      is >> worker;
+      assertalways(worker != NULL);
+      worker->set_parameter(system->get_parameter());
+      worker->seedfrom(prng);
+      workers.push_back(worker);
+      }
+   cerr << "Seed: " << seed << ", " << threads << " threads" << std::endl;
+   }
+
+void montecarlo::destroyworkers()
+   {
+   for (size_t i = 0; i < workers.size(); i++)
+      delete workers[i];
+   workers.clear();
+   }
+
+/*! \brief Set up the look-ahead points for the pending parameter values
+ * \param   systemstring   Serialized system description
+ * \return  True if results gathered in advance were taken over
+ *
+ * Any results already gathered for the current parameter value are merged
+ * into the system being estimated, and the CPU usage count is set to the
+ * time spent on them. Look-ahead points are then kept or created for the
+ * first 'lookahead' pending values; any others are discarded. Look-ahead
+ * points are created from the serialized system, as is done for slaves, and
+ * are only used to accumulate results returned by slaves.
+ */
+bool montecarlo::setuplookahead(const std::string& systemstring)
+   {
+   std::vector<lookahead_point> previous;
+   previous.swap(ahead);
+   // take over any results for the current parameter
+   bool merged = false;
+   double cputime = 0;
+   for (size_t i = 0; i < previous.size(); i++)
+      {
+      experiment *point = previous[i].system;
+      if (point->get_parameter() != system->get_parameter())
+         continue;
+      if (point->get_samplecount() > 0)
+         {
+         cerr << "NOTICE: Taking over " << point->get_samplecount()
+               << " samples gathered in advance." << std::endl;
+         libbase::vector<double> state;
+         point->get_state(state);
+         system->accumulate_state(point->get_samplecount(), state);
+         cputime = previous[i].cputime;
+         merged = true;
+         }
+      delete point;
+      previous[i].system = NULL;
+      break;
+      }
+   resetcputime(cputime);
+   // keep or create points for the following parameters
+   for (int i = 0; i < std::min(lookahead, pending.size().length()); i++)
+      {
+      lookahead_point p;
+      p.system = NULL;
+      p.cputime = 0;
+      for (size_t j = 0; j < previous.size(); j++)
+         if (previous[j].system != NULL
+               && previous[j].system->get_parameter() == pending(i))
+            {
+            p = previous[j];
+            previous[j].system = NULL;
+            break;
+            }
+      if (p.system == NULL)
+         {
+         std::istringstream is(systemstring);
+         is >> p.system;
+         assertalways(p.system != NULL);
+         p.system->set_parameter(pending(i));
+         p.system->reset();
+         }
+      ahead.push_back(p);
+      }
+   // discard the rest
+   for (size_t i = 0; i < previous.size(); i++)
+      delete previous[i].system;
+   return merged;
+   }
+
+void montecarlo::destroylookahead()
+   {
+   for (size_t i = 0; i < ahead.size(); i++)
+      delete ahead[i].system;
+   ahead.clear();
+   }
+
+/*! \brief Find the system accumulating results for the given parameter
+ * \return  The system being estimated, or the corresponding look-ahead
+ * point, or NULL if this parameter value is not in flight
+ */
+experiment *montecarlo::findpoint(double x)
+   {
+   if (x == system->get_parameter())
+      return system;
+   for (size_t i = 0; i < ahead.size(); i++)
+      if (x == ahead[i].system->get_parameter())
+         return ahead[i].system;
+   return NULL;
+   }
+
 void montecarlo::createfunctors(void)
    {
    fgetcode = new libbase::specificfunctor<montecarlo>(this,
@@ -138,6 +339,26 @@ void montecarlo::destroyfunctors(void)
    delete fwork;
    }
 
+// Simulation parameters
+
+void montecarlo::set_threads(int threads)
+   {
+   assertalways(threads >= 0);
+#ifdef USE_OMP
+   if (threads == 0)
+      threads = omp_get_num_procs();
+#else
+   if (threads != 1)
+      std::cerr
+            << "WARNING (montecarlo): no OpenMP support, using a single thread"
+            << std::endl;
+   threads = 1;
+#endif
+   trace << "DEBUG (montecarlo): setting number of threads to " << threads
+         << std::endl;
+   montecarlo::threads = threads;
+   }
+
 // System-specific file-handler functions
 
 void montecarlo::writeheader(std::ostream& sout) const
@@ -259,6 +480,8 @@ void montecarlo::display(const libbase::vector<double>& result,
       clog << "Timer: " << t << ", ";
       if (isenabled())
          clog << getnumslaves() << " clients, ";
+      else if (!workers.empty())
+         clog << "local (" << workers.size() << " threads), ";
       else
          clog << "local, ";
       clog << getcputime() / t.elapsed() << "× usage, ";
@@ -274,12 +497,48 @@ void montecarlo::display(const libbase::vector<double>& result,
 
 // main process
 
+/*!
+ * \brief Sample the system concurrently on all local workers
+ *
+ * Each worker samples its copy of the system for 500ms (as for slaves), after
+ * which the results accumulated by each worker are merged into the master
+ * copy, in worker order.
+ */
+void montecarlo::workersampleandaccumulate()
+   {
+   const int n = int(workers.size());
+#ifdef USE_OMP
+#pragma omp parallel for num_threads(n) schedule(static,1)
+#endif
+   for (int i = 0; i < n; i++)
+      {
+      experiment *worker = workers[i];
+      worker->reset();
+      libbase::walltimer tworker("montecarlo_worker");
+      do
+         {
+         libbase::vector<double> result;
+         worker->sample(result);
+         worker->accumulate(result);
+         } while (tworker.elapsed() < 0.5);
+      tworker.stop(); // to avoid expiry
+      }
+   // merge results into master
+   for (int i = 0; i < n; i++)
+      {
+      libbase::vector<double> state;
+      workers[i]->get_state(state);
+      system->accumulate_state(workers[i]->get_samplecount(), state);
+      }
+   }
+
 /*!
  * \brief Determine overall estimate from accumulated results
+ * \param[in]  system      System whose accumulated results are to be used
  * \param[out] result      Vector containing the set of estimates
  * \param[out] errormargin Corresponding margin of error (radius of confidence interval)
  */
-void montecarlo::updateresults(vector<double>& result,
+void montecarlo::updateresults(const experiment *system, vector<double>& result,
       vector<double>& errormargin) const
    {
    const double cfactor = libbase::Qinv((1.0 - confidence) / 2.0);
@@ -290,6 +549,161 @@ void montecarlo::updateresults(vector<double>& result,
    errormargin *= cfactor;
    }
 
+/*!
+ * \brief Determine whether the given results have converged
+ * \param   system      System whose accumulated results are being checked
+ * \param   result      Vector containing the set of estimates
+ * \param   errormargin Corresponding margin of error
+ *
+ * Results have converged when we have the accuracy we need, and we have
+ * enough samples for the accuracy to be meaningful.
+ */
+bool montecarlo::hasconverged(const experiment *system,
+      const vector<double>& result, const vector<double>& errormargin) const
+   {
+   // check we have done enough samples
+   if (system->get_samplecount() < libbase::int64u(min_samples))
+      return false;
+   // check accuracy reached
+   switch (mode)
+      {
+      case mode_relative_error:
+         {
+         // determine error margin as a fraction of result mean
+         const vector<double> result_acc = errormargin / result;
+         // check if this is less than threshold
+         return result_acc.max() <= threshold;
+         }
+      case mode_absolute_error:
+         {
+         // check if error margin is less than threshold
+         return errormargin.max() <= threshold;
+         }
+      case mode_accumulated_result:
+         {
+         // determine the absolute accumulated result
+         vector<double> result_acc = result;
+         for (int i = 0; i < result_acc.size(); i++)
+            result_acc(i) *= system->get_samplecount(i);
+         // check if this is more than threshold
+         return result_acc.min() >= threshold;
+         }
+      default:
+         failwith("Convergence mode not supported.");
+         break;
+      }
+   return false;
+   }
+
+/*!
+ * \brief Estimate the number of further samples needed for convergence
+ * \param   system   System whose accumulated results are being considered
+ *
+ * This assumes that the margin of error shrinks with the square root of the
+ * sample count, and that the accumulated result grows linearly with it.
+ * An infinite value is returned if no estimate is possible yet (i.e. when
+ * there are no samples, or when any result is still zero).
+ */
+double montecarlo::remainingsamples(const experiment *system) const
+   {
+   const double inf = std::numeric_limits<double>::infinity();
+   const double n = double(system->get_samplecount());
+   if (n == 0)
+      return inf;
+   vector<double> result, errormargin;
+   updateresults(system, result, errormargin);
+   if (hasconverged(system, result, errormargin))
+      return 0;
+   // determine the factor by which the sample count needs to grow
+   double factor = inf;
+   switch (mode)
+      {
+      case mode_relative_error:
+         if (result.min() > 0)
+            {
+            const double r = (errormargin / result).max() / threshold;
+            factor = r * r;
+            }
+         break;
+      case mode_absolute_error:
+         {
+         const double r = errormargin.max() / threshold;
+         factor = r * r;
+         break;
+         }
+      case mode_accumulated_result:
+         {
+         vector<double> result_acc = result;
+         for (int i = 0; i < result_acc.size(); i++)
+            result_acc(i) *= system->get_samplecount(i);
+         if (result_acc.min() > 0)
+            factor = threshold / result_acc.min();
+         break;
+         }
+      default:
+         failwith("Convergence mode not supported.");
+         break;
+      }
+   if (!(factor < inf))
+      return inf;
+   return std::max(min_samples - n, n * (factor - 1));
+   }
+
+/*!
+ * \brief Choose the parameter value an idle slave should work on
+ *
+ * Parameter values in flight are considered in order, starting with the one
+ * being estimated. The first one whose remaining samples are not already
+ * covered by the slaves working on it is chosen; slaves working on a time
+ * budget are assumed to return as many samples as the last one did. If all
+ * are covered, the current parameter value is chosen.
+ */
+double montecarlo::selectparameter() const
+   {
+   for (int i = -1; i < int(ahead.size()); i++)
+      {
+      const experiment *point = (i < 0) ? system : ahead[i].system;
+      const double x = point->get_parameter();
+      // count the samples being computed by slaves on this parameter
+      double busy = 0;
+      for (std::map<slave *, double>::const_iterator it = slaveworking.begin(); it
+            != slaveworking.end(); ++it)
+         if (it->second == x)
+            {
+            std::map<slave *, libbase::int64u>::const_iterator b =
+                  slavebatch.find(it->first);
+            if (b != slavebatch.end() && b->second > 0)
+               busy += double(b->second);
+            else
+               busy += double(passsamples);
+            }
+      if (busy < remainingsamples(point))
+         return x;
+      }
+   return system->get_parameter();
+   }
+
+/*!
+ * \brief Set the size of the next work unit for the given slave
+ * \param   s           Slave that returned results
+ * \param   samplecount Number of samples in the last work unit
+ * \param   elapsed     Time taken by the slave for the last work unit
+ *
+ * The number of samples is chosen to keep the slave busy for about one
+ * second, at the rate achieved on its last work unit. To avoid large swings
+ * due to timing noise, the size may grow by at most a factor of ten at a
+ * time.
+ */
+void montecarlo::updatebatch(slave *s, libbase::int64u samplecount,
+      double elapsed)
+   {
+   const double worktime = 1.0;
+   double batch = 10.0 * double(samplecount);
+   if (elapsed > 0)
+      batch = std::min(batch, samplecount * worktime / elapsed);
+   slavebatch[s] = std::max(libbase::int64u(1), libbase::int64u(batch));
+   }
+
 /*!
  * \brief Initialize given slave
  * \param   s              Slave to be initialized
@@ -308,6 +722,8 @@ void montecarlo::initslave(slave *s, std::string systemstring)
       return;
    if (!send(s, system->get_parameter()))
       return;
+   slaveparameter[s] = system->get_parameter();
+   slavebatch.erase(s);
    trace << "DEBUG (estimate): Slave (" << s << ") initialized ok."
          << std::endl;
    }
@@ -340,6 +756,10 @@ void montecarlo::initnewslaves(std::string systemstring)
  * be discarded during the next turn. This method avoids the master hanging up waiting for
  * results from slaves that will never come (happens if the machine is locked up but the
  * TCP/IP stack is still running).
+ *
+ * When look-ahead points are in flight, slaves that are not needed for the
+ * current parameter value are set to work on a subsequent one instead; the
+ * slave is sent the new parameter value before being asked to work.
  */
 void montecarlo::workidleslaves(bool converged)
    {
@@ -347,8 +767,17 @@ void montecarlo::workidleslaves(bool converged)
       {
       trace << "DEBUG (estimate): Idle slave found (" << s
             << "), assigning work." << std::endl;
-      if (!call(s, "slave_work"))
+      const double x = selectparameter();
+      if (slaveparameter.count(s) == 0 || slaveparameter[s] != x)
+         {
+         slaveparameter.erase(s);
+         if (!call(s, "slave_getparameter") || !send(s, x))
+            continue;
+         slaveparameter[s] = x;
+         }
+      if (!call(s, "slave_work") || !send(s, slavebatch[s]))
          continue;
+      slaveworking[s] = x;
       trace << "DEBUG (estimate): Slave (" << s << ") work assigned ok."
             << std::endl;
       }
@@ -361,9 +790,13 @@ void montecarlo::workidleslaves(bool converged)
  * If there are any slaves in the EVENT_PENDING state, read their results. Values
  * returned are accumulated into the running totals.
  *
+ * Results for a look-ahead point are accumulated there instead, and the CPU
+ * time used is accounted for separately.
+ *
  * If any slave returns a result that does not correspond to the same system
- * or parameter that are now being simulated, this is discarded and the slave
- * is marked as 'new'.
+ * that is now being simulated, this is discarded and the slave is marked as
+ * 'new'. Results for a parameter value that is no longer in flight are also
+ * discarded; the slave is sent a new parameter value when next given work.
  */
 bool montecarlo::readpendingslaves()
    {
@@ -372,31 +805,65 @@ bool montecarlo::readpendingslaves()
       {
       trace << "DEBUG (estimate): Pending event from slave (" << s
             << "), trying to read." << std::endl;
-      // get digest and parameter for simulated system
+      slaveworking.erase(s);
+      // get results frame
+      std::string frame;
+      if (!receive(s, frame))
+         continue;
+      // extract digest and parameter for simulated system, and results
       std::string simdigest;
       double simparameter;
-      if (!receive(s, simdigest) || !receive(s, simparameter))
-         continue;
-      // set up space for results that need to be returned
-      libbase::int64u estsamplecount = 0;
+      libbase::int64u estsamplecount;
+      double elapsed, cputime;
       vector<double> eststate;
-      // get results
-      if (!receive(s, estsamplecount) || !receive(s, eststate))
+      if (!unpackresults(frame, simdigest, simparameter, estsamplecount,
+            elapsed, cputime, eststate))
+         {
+         cerr << "ERROR: Slave (" << s << ") returned a malformed results "
+               "frame, re-initializing." << std::endl;
+         slaveparameter.erase(s);
+         slavebatch.erase(s);
+         resetslave(s);
          continue;
+         }
       // check that results correspond to system under simulation
-      if (std::string(sysdigest) != simdigest || simparameter
-            != system->get_parameter())
+      if (std::string(sysdigest) != simdigest)
          {
          trace << "DEBUG (estimate): Slave returned invalid results (" << s
                << "), re-initializing." << std::endl;
+         addcputime(cputime);
+         slaveparameter.erase(s);
+         slavebatch.erase(s);
          resetslave(s);
          continue;
          }
+      // set size of next work unit
+      updatebatch(s, estsamplecount, elapsed);
+      // find where results need to be accumulated
+      experiment *point = findpoint(simparameter);
+      if (point == NULL)
+         {
+         trace << "DEBUG (estimate): Slave returned stale results (" << s
+               << "), discarding." << std::endl;
+         addcputime(cputime);
+         continue;
+         }
       // accumulate
-      system->accumulate_state(estsamplecount, eststate);
+      point->accumulate_state(estsamplecount, eststate);
+      passsamples = estsamplecount;
       // update usage information and return flag
-      updatecputime(s);
-      results_available = true;
+      if (point == system)
+         {
+         addcputime(cputime);
+         results_available = true;
+         }
+      else
+         {
+         // account for CPU time with the look-ahead point
+         for (size_t i = 0; i < ahead.size(); i++)
+            if (ahead[i].system == point)
+               ahead[i].cputime += cputime;
+         }
       trace << "DEBUG (estimate): Read from slave (" << s << ") succeeded."
             << std::endl;
       }
@@ -428,12 +895,25 @@ void montecarlo::estimate(vector<double>& result, vector<double>& errormargin)
       setupfile();
 
    // Set up for master-slave system (if necessary)
-   // and seed the experiment
+   // and seed the experiment (or the local workers)
+   bool merged = false;
    if (isenabled())
       {
-      resetslaves();
-      resetcputime();
+      // slaves are only kept across parameter values when looking ahead,
+      // and as long as the system itself is unchanged
+      if (lookahead == 0 || aheaddigest != std::string(sysdigest))
+         {
+         resetslaves();
+         slaveparameter.clear();
+         slaveworking.clear();
+         slavebatch.clear();
+         destroylookahead();
+         aheaddigest = std::string(sysdigest);
+         }
+      merged = setuplookahead(systemstring);
       }
+   else if (threads > 1)
+      createworkers(systemstring);
    else
       seed_experiment();
 
@@ -442,6 +922,12 @@ void montecarlo::estimate(vector<double>& result, vector<double>& errormargin)
    // 2) We have enough samples for the accuracy to be meaningful
    // An interrupt from the user overrides everything...
    bool converged = false;
+   // check any results gathered in advance
+   if (merged)
+      {
+      updateresults(result, errormargin);
+      converged = hasconverged(system, result, errormargin);
+      }
    while (!converged)
       {
       bool results_available = false;
@@ -457,6 +943,11 @@ void montecarlo::estimate(vector<double>& result, vector<double>& errormargin)
          // accumulate results from any pending slaves
          results_available = readpendingslaves();
          }
+      else if (!workers.empty())
+         {
+         workersampleandaccumulate();
+         results_available = true;
+         }
       else
          {
          sampleandaccumulate();
@@ -467,42 +958,7 @@ void montecarlo::estimate(vector<double>& result, vector<double>& errormargin)
          {
          updateresults(result, errormargin);
          // if we have done enough samples, check accuracy reached
-         if (system->get_samplecount() >= libbase::int64u(min_samples))
-            {
-            switch (mode)
-               {
-               case mode_relative_error:
-                  {
-                  // determine error margin as a fraction of result mean
-                  const vector<double> result_acc = errormargin / result;
-                  // check if this is less than threshold
-                  if (result_acc.max() <= threshold)
-                     converged = true;
-                  break;
-                  }
-               case mode_absolute_error:
-                  {
-                  // check if error margin is less than threshold
-                  if (errormargin.max() <= threshold)
-                     converged = true;
-                  break;
-                  }
-               case mode_accumulated_result:
-                  {
-                  // determine the absolute accumulated result
-                  vector<double> result_acc = result;
-                  for (int i = 0; i < result_acc.size(); i++)
-                     result_acc(i) *= system->get_samplecount(i);
-                  // check if this is more than threshold
-                  if (result_acc.min() >= threshold)
-                     converged = true;
-                  break;
-                  }
-               default:
-                  failwith("Convergence mode not supported.");
-                  break;
-               }
-            }
+         converged = hasconverged(system, result, errormargin);
          // print something to inform the user of our progress
          display(result, errormargin);
          // write interim results
@@ -519,6 +975,9 @@ void montecarlo::estimate(vector<double>& result, vector<double>& errormargin)
    if (resultsfile::isinitialized())
       writefinalresults(result, errormargin, interrupt());
 
+   // release local workers
+   destroyworkers();
+
    t.stop();
    }
 
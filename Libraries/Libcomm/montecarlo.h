@@ -31,6 +31,8 @@
 #include "resultsfile.h"
 #include "truerand.h"
 #include <sstream>
+#include <vector>
+#include <map>
 
 namespace libcomm {
 
@@ -63,6 +65,27 @@ private:
    mutable libbase::walltimer tupdate; //!< timer to keep track of display rate
    sha sysdigest; //!< digest of the currently-simulated system
    // @}
+   /*! \name Local worker pool */
+   int threads; //!< number of local worker threads (1 for serial computation)
+   std::vector<experiment *> workers; //!< per-thread copies of system being sampled
+   // @}
+   /*! \name Parameter look-ahead (master-slave only) */
+   //! Results gathered in advance for a subsequent parameter value
+   struct lookahead_point {
+      experiment *system; //!< Copy of system, used to accumulate results
+      double cputime; //!< CPU time used by slaves for this parameter
+   };
+   int lookahead; //!< number of subsequent parameter values to keep in flight
+   libbase::vector<double> pending; //!< parameter values to be simulated after the current one
+   std::vector<lookahead_point> ahead; //!< look-ahead points, in order of parameter
+   std::string aheaddigest; //!< digest of the system used by slaves and look-ahead points
+   std::map<slave *, double> slaveparameter; //!< parameter value last sent to each slave
+   std::map<slave *, double> slaveworking; //!< parameter value each busy slave is working on
+   libbase::int64u passsamples; //!< number of samples in the last result returned by a slave
+   // @}
+   /*! \name Slave work units (master only) */
+   std::map<slave *, libbase::int64u> slavebatch; //!< number of samples in next work unit for each slave (zero for default time budget)
+   // @}
 private:
    /*! \name Slave process functions & their functors */
    void slave_getcode(void);
@@ -74,8 +97,36 @@ private:
    // @}
 private:
    /*! \name Helper functions */
+   std::string packresults(double elapsed);
+   static bool unpackresults(const std::string& frame, std::string& digest,
+         double& parameter, libbase::int64u& samplecount, double& elapsed,
+         double& cputime, libbase::vector<double>& state);
+   //! Append the binary representation of a value to a frame
+   template <class T>
+   static void pack(std::string& frame, const T& x)
+      {
+      frame.append(reinterpret_cast<const char *> (&x), sizeof(x));
+      }
+   /*! \brief Extract the binary representation of a value from a frame
+    * \return False if the frame is too short to contain the value
+    */
+   template <class T>
+   static bool unpack(const std::string& frame, size_t& pos, T& x)
+      {
+      if (pos + sizeof(x) > frame.length())
+         return false;
+      std::copy(frame.data() + pos, frame.data() + pos + sizeof(x),
+            reinterpret_cast<char *> (&x));
+      pos += sizeof(x);
+      return true;
+      }
    std::string get_systemstring();
    void seed_experiment();
+   void createworkers(const std::string& systemstring);
+   void destroyworkers();
+   bool setuplookahead(const std::string& systemstring);
+   void destroylookahead();
+   experiment *findpoint(double x);
    void createfunctors(void);
    void destroyfunctors(void);
    // @}
@@ -89,8 +140,21 @@ private:
       system->sample(result);
       system->accumulate(result);
       }
-   void updateresults(libbase::vector<double>& result,
+   void workersampleandaccumulate();
+   void updateresults(const experiment *system,
+         libbase::vector<double>& result,
          libbase::vector<double>& errormargin) const;
+   void updateresults(libbase::vector<double>& result,
+         libbase::vector<double>& errormargin) const
+      {
+      updateresults(system, result, errormargin);
+      }
+   bool hasconverged(const experiment *system,
+         const libbase::vector<double>& result,
+         const libbase::vector<double>& errormargin) const;
+   double remainingsamples(const experiment *system) const;
+   double selectparameter() const;
+   void updatebatch(slave *s, libbase::int64u samplecount, double elapsed);
    void initslave(slave *s, std::string systemstring);
    void initnewslaves(std::string systemstring);
    void workidleslaves(bool converged);
@@ -128,7 +192,7 @@ public:
    montecarlo() :
          bound(false), system(NULL), min_samples(128), confidence(0.95), threshold(
                0.10), mode(mode_relative_error), t("montecarlo"), tupdate(
-               "montecarlo_update")
+               "montecarlo_update"), threads(1), lookahead(0), passsamples(0)
       {
       createfunctors();
       // Use a true RNG to determine the initial seed value
@@ -138,6 +202,8 @@ public:
    virtual ~montecarlo()
       {
       release();
+      destroyworkers();
+      destroylookahead();
       delete system;
       destroyfunctors();
       tupdate.stop();
@@ -168,6 +234,39 @@ public:
          std::cerr << "WARNING (montecarlo): seed value unused in master-slave system" << std::endl;
       montecarlo::seed = seed;
       }
+   /*!
+    * \brief Set number of local worker threads
+    *
+    * When using the local-computation model, this determines the number of
+    * threads used to sample the system concurrently; a value of zero uses
+    * one thread per available processor. This setting is ignored in a
+    * master-slave system.
+    */
+   void set_threads(int threads);
+   /*!
+    * \brief Set number of subsequent parameter values to keep in flight
+    *
+    * In a master-slave system, slaves that are not needed to complete the
+    * current parameter value are given work on up to this many of the
+    * pending parameter values (see set_pending()). Results gathered in
+    * advance are taken over when estimate() is called for that parameter,
+    * so that estimates are still returned one parameter value at a time, in
+    * order. A value of zero (the default) simulates one parameter value at a
+    * time. This setting is ignored in the local-computation model.
+    */
+   void set_lookahead(int lookahead)
+      {
+      assertalways(lookahead >= 0);
+      libbase::trace
+            << "DEBUG (montecarlo): setting number of look-ahead points to "
+            << lookahead << std::endl;
+      montecarlo::lookahead = lookahead;
+      }
+   //! Set parameter values to be simulated after the current one, in order
+   void set_pending(const libbase::vector<double>& pending)
+      {
+      montecarlo::pending = pending;
+      }
    //! Set minimum number of samples
    void set_min_samples(int min_samples)
       {
@@ -216,9 +315,9 @@ public:
       montecarlo::mode = mode_accumulated_result;
       }
    //! Associates with given results file
-   void set_resultsfile(const std::string& fname)
+   void set_resultsfile(const std::string& fname, bool incremental = true)
       {
-      resultsfile::init(fname);
+      resultsfile::init(fname, incremental);
       }
    //! Get confidence level as a string
    std::string get_confidence_level() const
@@ -22,6 +22,7 @@
 #include "resultsfile.h"
 
 #include <fstream>
+#include <algorithm>
 
 #ifdef _WIN32
 #  include <io.h>
@@ -30,6 +31,7 @@
 #else
 #  include <unistd.h>
 #  include <sys/types.h>
+#  include <sys/stat.h>
 #endif
 
 namespace libcomm {
@@ -37,6 +39,16 @@ namespace libcomm {
 using std::cerr;
 using libbase::trace;
 using libbase::vector;
+using libbase::int64u;
+
+// Incremental mode parameters
+
+namespace {
+
+const int tail_length = 4096; //!< Number of bytes at end of file to digest
+const int journal_limit = 20; //!< Number of interim records before compaction
+
+} // end namespace
 
 // Results file helper functions
 
@@ -53,6 +65,7 @@ void resultsfile::writeheaderifneeded(std::fstream& file)
       headerwritten = true;
       // update file-write position
       fileptr = file.tellp();
+      journalptr = fileptr;
       }
    }
 
@@ -67,7 +80,7 @@ void resultsfile::finishwithfile(std::fstream& file)
    truncate(length);
    // re-open and update digest
    file.open(fname.c_str(), std::ios::in);
-   filedigest.process(file);
+   updatedigest(file);
    }
 
 void resultsfile::truncate(std::streampos length)
@@ -83,17 +96,87 @@ void resultsfile::truncate(std::streampos length)
 #endif
    }
 
+/*! \brief Get file length, modification time and serial number
+ * \return True if the file information could be obtained
+ * \note On Windows there is no meaningful serial number, and zero is returned.
+ */
+bool resultsfile::getfilestats(int64u& size, int64u& time, int64u& id) const
+   {
+   assert(!fname.empty());
+#ifdef _WIN32
+   struct _stat64 st;
+   if (_stat64(fname.c_str(), &st) != 0)
+      return false;
+   id = 0;
+#else
+   struct stat st;
+   if (stat(fname.c_str(), &st) != 0)
+      return false;
+   id = st.st_ino;
+#endif
+   size = st.st_size;
+   time = st.st_mtime;
+   return true;
+   }
+
+/*! \brief Update the digest of file contents as at last update
+ * In incremental mode, only the tail of the file is digested, and the file
+ * length, modification time and serial number are kept instead.
+ *
+ * \note If the file information cannot be obtained, the file length is taken
+ * from the stream, and the other values are cleared; the next check will
+ * then find the file modified, unless these are also unavailable.
+ */
+void resultsfile::updatedigest(std::fstream& file)
+   {
+   assert(file.good());
+   if (incremental)
+      {
+      if (!getfilestats(filesize, filetime, fileid))
+         {
+         file.seekg(0, std::ios_base::end);
+         filesize = int64u(std::streamoff(file.tellg()));
+         filetime = fileid = 0;
+         }
+      file.seekg(std::streamoff(filesize - std::min(filesize, int64u(
+            tail_length))));
+      }
+   else
+      file.seekg(0);
+   filedigest.process(file);
+   // reset file
+   file.clear();
+   }
+
 void resultsfile::checkformodifications(std::fstream& file)
    {
    assert(file.good());
    trace << "DEBUG (resultsfile): checking file for modifications." << std::endl;
    // check for user modifications
-   sha curdigest;
-   file.seekg(0);
-   curdigest.process(file);
-   // reset file
-   file.clear();
-   if (curdigest == filedigest)
+   bool modified;
+   if (incremental)
+      {
+      // a file we cannot get information on is treated as modified
+      int64u cursize, curtime, curid;
+      modified = !getfilestats(cursize, curtime, curid) || cursize
+            != filesize || curtime != filetime || curid != fileid;
+      }
+   else
+      modified = false;
+   if (!modified)
+      {
+      sha curdigest;
+      if (incremental)
+         file.seekg(std::streamoff(filesize - std::min(filesize, int64u(
+               tail_length))));
+      else
+         file.seekg(0);
+      curdigest.process(file);
+      // reset file
+      file.clear();
+      modified = (curdigest != filedigest);
+      }
+   if (!modified)
       file.seekp(fileptr);
    else
       {
@@ -101,17 +184,21 @@ void resultsfile::checkformodifications(std::fstream& file)
       // set current write position to end-of-file
       file.seekp(0, std::ios_base::end);
       fileptr = file.tellp();
+      // start a new journal
+      journalptr = fileptr;
+      journalsize = 0;
       }
    }
 
 // File handling interface
 
-void resultsfile::init(const std::string& fname)
+void resultsfile::init(const std::string& fname, bool incremental)
    {
    assert(!t.isrunning());
    filesetup = false;
    headerwritten = false;
    resultsfile::fname = fname;
+   resultsfile::incremental = incremental;
    }
 
 // Results handling interface
@@ -146,9 +233,10 @@ void resultsfile::setupfile()
    // set write position at end
    file.seekp(0, std::ios_base::end);
    fileptr = file.tellp();
+   journalptr = fileptr;
+   journalsize = 0;
    // update digest
-   file.seekg(0);
-   filedigest.process(file);
+   updatedigest(file);
    // start timer for interim results writing
    t.start();
    // update flags
@@ -158,26 +246,41 @@ void resultsfile::setupfile()
 /*! \brief Write current results and state
  * This method can be called as many times as required; usually this is
  * called after every update. File writes are limited to occur no more often
- * than 30 seconds (this quantity is hard-wired).
+ * than the set interval (30 seconds by default).
+ *
+ * The state is written before the result, so that the result is always the
+ * last entry in the file.
  *
  * \note This method does not change the write position so that this result is
- * overwritten on the next write.
+ * overwritten on the next write. In incremental mode, the state is appended
+ * to the journal instead, and only the result is overwritten; the file
+ * therefore has a single result for the interim record, followed by the
+ * states (which are comments) of earlier records until the journal is
+ * compacted.
  */
 void resultsfile::writeinterimresults(libbase::vector<double>& result,
       libbase::vector<double>& errormargin)
    {
    assert(filesetup);
    assert(t.isrunning());
-   // restrict updates to occur every 30 seconds or less
-   if (t.elapsed() < 30)
+   // restrict the rate of updates
+   if (t.elapsed() < interval)
       return;
    // open file for input and output
    std::fstream file(fname.c_str());
    assertalways(file.good());
    checkformodifications(file);
+   // append to the journal, or compact it if full
+   if (incremental && journalsize < journal_limit)
+      file.seekp(journalptr);
+   else
+      journalsize = 0;
    writeheaderifneeded(file);
-   writeresults(file, result, errormargin);
    writestate(file);
+   // update journal (the result is overwritten next time)
+   journalptr = file.tellp();
+   journalsize++;
+   writeresults(file, result, errormargin);
    finishwithfile(file);
    // restart timer
    t.start();
@@ -205,8 +308,10 @@ void resultsfile::writefinalresults(libbase::vector<double>& result,
    writeresults(file, result, errormargin);
    if (savestate)
       writestate(file);
-   // update write-position
+   // update write-position (this also compacts the journal)
    fileptr = file.tellp();
+   journalptr = fileptr;
+   journalsize = 0;
    finishwithfile(file);
    // stop timer and clear setup flag (in preparation for next simulation run)
    t.stop();
@@ -42,6 +42,16 @@ namespace libcomm {
  * any external changes. In such cases, the file is considered 'modified'
  * and the next write happens at the end of the file.
  *
+ * In incremental mode (the default), the check avoids re-reading the whole
+ * file: instead the file size, modification time and serial number (inode)
+ * are kept, together with a digest of the tail of the file only; if these
+ * cannot be obtained, the file is considered 'modified'. The state of
+ * interim records is also appended to a journal at the end of the file
+ * rather than overwriting the previous one, with only the interim result
+ * overwritten, so that the file has a single result line for the record.
+ * The journal is compacted (i.e. overwritten from its start) when it reaches
+ * a fixed number of records, and on the final write.
+ *
  * The handler also allows 'interim' result writing. In this case, the result
  * is written together with the simulation state. This allows the user to
  * continue an aborted simulation (due to simulator or machine crash, for
@@ -62,7 +72,7 @@ namespace libcomm {
  *       already set up at this point, so that a valid comparison can be made.
  *    c) writeinterimresults() as many times as required; usually this is
  *       called after every update. The handler limits file writes to occur
- *       no more often than 30 seconds.
+ *       no more often than a set interval (30 seconds by default).
  *    d) writefinalresults() one last time; this is guaranteed to happen.
  */
 
@@ -74,8 +84,15 @@ private:
    /*! \name Internal variables */
    bool filesetup; //!< Flag to indicate that the results file was set up
    bool headerwritten; //!< Flag to indicate that the results header has been written
+   bool incremental; //!< Flag to enable incremental checks and journalling
    std::streampos fileptr; //!< Position in file where we should write the next result
-   sha filedigest; //!< Digest of file as at last update
+   std::streampos journalptr; //!< Position in file where we should write the next interim record
+   int journalsize; //!< Number of interim records in the journal
+   double interval; //!< Minimum time between interim writes, in seconds
+   sha filedigest; //!< Digest of file (or its tail, if incremental) as at last update
+   libbase::int64u filesize; //!< File length as at last update
+   libbase::int64u filetime; //!< File modification time as at last update
+   libbase::int64u fileid; //!< File serial number as at last update
    libbase::walltimer t; //!< Timer to keep track of running estimate
    // @}
 private:
@@ -83,6 +100,9 @@ private:
    void writeheaderifneeded(std::fstream& file);
    void finishwithfile(std::fstream& file);
    void truncate(std::streampos length);
+   bool getfilestats(libbase::int64u& size, libbase::int64u& time,
+         libbase::int64u& id) const;
+   void updatedigest(std::fstream& file);
    void checkformodifications(std::fstream& file);
    // @}
 protected:
@@ -94,11 +114,20 @@ protected:
    virtual void writestate(std::ostream& sout) const = 0;
    virtual void lookforstate(std::istream& sin) = 0;
    // @}
+   /*! \name Setup functions */
+   //! Set the minimum time between interim writes, in seconds
+   void set_interval(double seconds)
+      {
+      assert(seconds >= 0);
+      interval = seconds;
+      }
+   // @}
 public:
    /*! \name Constructor/destructor */
    // Constructor/destructor
    resultsfile() :
-      filesetup(false), headerwritten(false), t("resultsfile", false)
+      filesetup(false), headerwritten(false), incremental(true),
+            interval(30), t("resultsfile", false)
       {
       }
    virtual ~resultsfile()
@@ -110,8 +139,10 @@ public:
    /*! \name File handling interface */
    /*! \brief Provide filename
     * After this, the results handling interface methods can be used.
+    * Incremental mode may be disabled, so that the whole file is checked for
+    * external changes before every write.
     */
-   void init(const std::string& fname);
+   void init(const std::string& fname, bool incremental = true);
    /*! \brief Check whether the handler has been initialized
     * Indicates whether the results handling interface methods can be used.
     */
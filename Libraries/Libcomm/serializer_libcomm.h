@@ -31,6 +31,7 @@
 #include "mpreal.h"
 #include "logreal.h"
 #include "logrealfast.h"
+#include "logrealsimd.h"
 
 // Channels
 #include "channel.h"
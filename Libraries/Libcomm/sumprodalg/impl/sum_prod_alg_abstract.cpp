@@ -33,6 +33,29 @@ namespace libcomm {
 template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::spa_iteration(
       array1vd_t& ro)
    {
+   if (this->layered)
+      {
+      this->layered_iteration();
+      }
+   else
+      {
+      this->flooding_iteration();
+      }
+
+   //compute the new probabilities for all symbols given the information in this iteration.
+   //This will be used in a tentative decoding to see whether we have found a codeword
+   this->compute_probs(ro);
+
+#if DEBUG>=3
+   libbase::trace
+   << "The newly computed normalised probabilities are given by:" << std::endl;
+   ro.serialize(libbase::trace, ' ');
+#endif
+
+   }
+
+template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::flooding_iteration()
+   {
    //carry out the horizontal step
    //this uses the description of the algorithm as given by
    //MacKay in Information Theory, Inference and Learning Algorithms(2003)
@@ -45,19 +68,15 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::spa_it
    // if the parity check is satisfied the conditional probability is 1 and 0 otherwise
    // so we are simply adding up the products for which the parity check is satisfied.
 
-   //the number of symbols in N_m, eg the number of variables that participate in check m
-   int size_N_m;
-
    //loop over all check nodes - the horizontal step
+   //the checks are independent, so they can be split across threads
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (this->dim_m >= parallel_threshold)
+#endif
    for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
       {
-      // get the bits that participate in this check
-      size_N_m = this->N_m(loop_m).size();
-      for (int loop_n = 0; loop_n < size_N_m; loop_n++)
-         {
-         //this will compute the relevant r_nms fixing the x_n given by loop_n
-         this->compute_r_mn(loop_m, loop_n, this->N_m(loop_m));
-         }
+      //this will compute the relevant r_nms for all the bits in this check
+      this->compute_r_m(loop_m, this->N_m(loop_m));
       }
 
 #if DEBUG>=2
@@ -66,17 +85,17 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::spa_it
    this->print_marginal_probs(3, libbase::trace);
 #endif
 
-   //this array holds the checks that use symbol n
-   array1i_t M_n;
-   //the number of checks in that array
-   int size_M_n;
-
    //loop over all the bit nodes - the vertical step
-
+   //as for the checks, the symbols can be split across threads
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (this->length_n >= parallel_threshold)
+#endif
    for (int loop_n = 0; loop_n < this->length_n; loop_n++)
       {
-      M_n = this->M_n(loop_n);
-      size_M_n = M_n.size().length();
+      //this array holds the checks that use symbol n
+      const array1i_t& M_n = this->M_n(loop_n);
+      //the number of checks in that array
+      const int size_M_n = M_n.size();
       for (int loop_m = 0; loop_m < size_M_n; loop_m++)
          {
          this->compute_q_mn(loop_m, loop_n, M_n);
@@ -88,17 +107,35 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::spa_it
    << "After the vertical step, the marginal matrix at col x is given by:" << std::endl;
    this->print_marginal_probs(3, libbase::trace);
 #endif
+   }
 
-   //compute the new probabilities for all symbols given the information in this iteration.
-   //This will be used in a tentative decoding to see whether we have found a codeword
-   this->compute_probs(ro);
+template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::layered_iteration()
+   {
+   //each check is a layer: the messages from its symbols are computed from
+   //the current messages of all their other checks, including those that
+   //were already updated in this iteration, and then the check is updated.
+   //Note that the r_mxn's are set to 1 by spa_init, so the first layer only
+   //sees the received probabilities.
+   int non_zeros;
+   int pos;
+   int edge;
+   for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+      {
+      non_zeros = this->N_m(loop_m).size();
+      for (int loop_n = 0; loop_n < non_zeros; loop_n++)
+         {
+         pos = this->N_m(loop_m)(loop_n) - 1;//we count from zero
+         edge = this->check_edge(loop_m, loop_n);
+         this->compute_q_mn(this->edge_var_pos(edge), pos, this->M_n(pos));
+         }
+      this->compute_r_m(loop_m, this->N_m(loop_m));
+      }
 
-#if DEBUG>=3
+#if DEBUG>=2
    libbase::trace
-   << "The newly computed normalised probabilities are given by:" << std::endl;
-   ro.serialize(libbase::trace, ' ');
+   << std::endl << "After the layered step, the marginal matrix at col x is given by:" << std::endl;
+   this->print_marginal_probs(3, libbase::trace);
 #endif
-
    }
 
 template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::compute_probs(
@@ -109,20 +146,20 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::comput
 
    //initialise some helper variables
    int num_of_elements = GF_q::elements();
-   real a_n = real(0.0);
-   int size_of_M_n = 0;
-   int pos_m;
+   //the symbols are independent, so they can be split across threads
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (this->length_n >= parallel_threshold)
+#endif
    for (int loop_n = 0; loop_n < this->length_n; loop_n++)
       {
       ro(loop_n) = this->received_probs(loop_n);
-      size_of_M_n = this->M_n(loop_n).size();
+      const int size_of_M_n = this->M_n(loop_n).size();
       for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
          {
          for (int loop_m = 0; loop_m < size_of_M_n; loop_m++)
             {
-            pos_m = this->M_n(loop_n)(loop_m) - 1;//we count from 0
-            ro(loop_n)(loop_e) *= this->marginal_probs(pos_m, loop_n).r_mxn(
-                  loop_e);
+            const int edge = this->var_edge_at(loop_n, loop_m);
+            ro(loop_n)(loop_e) *= this->r_mxn(edge * num_of_elements + loop_e);
             }
          //Use appropriate clipping method
          perform_clipping(ro(loop_n)(loop_e));
@@ -131,7 +168,7 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::comput
       //look neater - however it only adds a small overhead
 
       //normalise the result so that q_n_0+q_n_1=1
-      a_n = ro(loop_n).sum();
+      const real a_n = ro(loop_n).sum();
       assertalways(a_n!=real(0.0));
       ro(loop_n) /= a_n;
       }
@@ -140,82 +177,27 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::comput
 template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::print_marginal_probs(
       std::ostream& sout)
    {
-   int num_of_elements = GF_q::elements();
-   bool used;
+   int non_zeros;
    for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
       {
+      sout << std::endl << "row=" << loop_m + 1;
       sout << std::endl << "[";
-      for (int loop_n = 0; loop_n < this->length_n; loop_n++)
+      non_zeros = this->N_m(loop_m).size();
+      for (int loop_n = 0; loop_n < non_zeros; loop_n++)
          {
-         sout << " <q=(";
-         used = this->marginal_probs(loop_m, loop_n).q_mxn.size() > 0;
-         if (used)
-            {
-            for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-               {
-               sout << this->marginal_probs(loop_m, loop_n).q_mxn(loop_e)
-                     << ", ";
-               }
-            sout << this->marginal_probs(loop_m, loop_n).q_mxn(num_of_elements
-                  - 1);
-            }
-         else
-            {
-            sout << " n/a ";
-            }
-         sout << "), q_conv=(";
-         if (used)
-            {
-            for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-               {
-               sout << this->marginal_probs(loop_m, loop_n).qmn_conv(loop_e)
-                     << ", ";
-               }
-            sout << this->marginal_probs(loop_m, loop_n).qmn_conv(
-                  num_of_elements - 1);
-            }
-         else
-            {
-            sout << " n/a ";
-            }
-         sout << "), r=(";
-         if (used)
-            {
-            for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-               {
-               sout << this->marginal_probs(loop_m, loop_n).r_mxn(loop_e)
-                     << ", ";
-               }
-            sout << this->marginal_probs(loop_m, loop_n).r_mxn(num_of_elements
-                  - 1);
-            }
-         else
-            {
-            sout << "n/a ";
-            }
-         sout << "), val=(";
-         if (used)
-            {
-            sout << this->marginal_probs(loop_m, loop_n).val;
-            }
-         else
-            {
-            sout << " n/a ";
-            }
-         sout << ")>";
+         sout << std::endl << " col=" << this->N_m(loop_m)(loop_n);
+         this->print_edge(this->check_edge(loop_m, loop_n), sout);
          }
       sout << "]" << std::endl;
       }
    }
+
 template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::print_marginal_probs(
       int col, std::ostream& sout)
    {
-   int num_of_elements = GF_q::elements();
    int tmp_row;
-   int tmp_col;
    sout << "only printing the necessary values for col=" << col;
    col--;//we count from 0
-   array1i_t tmp_N_m;
    int num_of_elements_in_col = this->M_n(col).size();
    int num_of_elements_in_row = 0;
 
@@ -224,51 +206,47 @@ template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::print_
       tmp_row = this->M_n(col)(loop_m) - 1;
       sout << std::endl << "row=" << tmp_row + 1;
       sout << std::endl << "[";
-      tmp_N_m = this->N_m(tmp_row);
-      num_of_elements_in_row = tmp_N_m.size();
+      num_of_elements_in_row = this->N_m(tmp_row).size();
       for (int loop_n = 0; loop_n < num_of_elements_in_row; loop_n++)
          {
-         tmp_col = tmp_N_m(loop_n) - 1;
-         sout << std::endl << " <q=(";
-         for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-            {
-            sout << this->marginal_probs(tmp_row, tmp_col).q_mxn(loop_e)
-                  << ", ";
-            }
-         sout << this->marginal_probs(tmp_row, tmp_col).q_mxn(num_of_elements
-               - 1);
-         bool used = this->marginal_probs(tmp_row, tmp_col).qmn_conv.size() > 0;
-         if (used)
-            {
-            sout << "),\n q_conv=(";
-            for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-               {
-               sout << this->marginal_probs(tmp_row, tmp_col).qmn_conv(loop_e)
-                     << ", ";
-               }
-            sout << this->marginal_probs(tmp_row, tmp_col).qmn_conv(
-                  num_of_elements - 1);
-            }
-         sout << "),\n r=(";
-
-         for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
-            {
-            sout << this->marginal_probs(tmp_row, tmp_col).r_mxn(loop_e)
-                  << ", ";
-            }
-         sout << this->marginal_probs(tmp_row, tmp_col).r_mxn(num_of_elements
-               - 1);
-
-         sout << "), val=(";
-
-         sout << this->marginal_probs(tmp_row, tmp_col).val;
-
-         sout << ")>";
+         this->print_edge(this->check_edge(tmp_row, loop_n), sout);
          }
       sout << "]" << std::endl;
       }
    }
 
+template <class GF_q, class real> void sum_prod_alg_abstract<GF_q, real>::print_edge(
+      int edge, std::ostream& sout)
+   {
+   int num_of_elements = GF_q::elements();
+   int pos = edge * num_of_elements;
+   sout << std::endl << " <q=(";
+   for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
+      {
+      sout << this->q_mxn(pos + loop_e) << ", ";
+      }
+   sout << this->q_mxn(pos + num_of_elements - 1);
+   bool used = this->qmn_conv.size() > 0;
+   if (used)
+      {
+      sout << "),\n q_conv=(";
+      for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
+         {
+         sout << this->qmn_conv(pos + loop_e) << ", ";
+         }
+      sout << this->qmn_conv(pos + num_of_elements - 1);
+      }
+   sout << "),\n r=(";
+   for (int loop_e = 0; loop_e < num_of_elements - 1; loop_e++)
+      {
+      sout << this->r_mxn(pos + loop_e) << ", ";
+      }
+   sout << this->r_mxn(pos + num_of_elements - 1);
+   sout << "), val=(";
+   sout << this->edge_val(edge);
+   sout << ")>";
+   }
+
 } // end namespace
 
 #include "gf.h"
@@ -27,20 +27,46 @@
 #include "matrix.h"
 #include "sumprodalg/sum_prod_alg_inf.h"
 #include <limits>
+#include <algorithm>
+
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
 
 namespace libcomm {
 
 /*! \brief Sum Product Algorithm(SPA) implementation
  *
  * Currently 2 types of the SPA: trad and gdl
- * The trad version computes the probabilities for the r__mxn's by computing
- * all the possible combinations of info symbols that satisfy the check node.
- * This can be very expensive computationally (especially when GF(q>2)
- * but it easy to code and understand.
+ * The trad version computes the probabilities for the r__mxn's directly in
+ * the probability domain, by convolving the distributions of the symbols
+ * that participate in the check. It uses only addition and multiplication,
+ * so it can also be used with log-domain representations of 'real'.
  * The gdl version uses the fact that these probabilities can be grouped differently
  * using the distributive law and hence be computed much faster. The version
  * that is implemented here is based on Declercqs and Fossorier's 2006 paper:
  * Decoding Algorithms for Nonbinary LDPC Codes over GF(q)
+ *
+ * In both versions, all the r_mxn's of a check are computed together, using
+ * forward and backward partial results over the participating symbols; this
+ * avoids recomputing the contribution of the other symbols for each edge.
+ *
+ * Messages are only kept for the non-zero entries of the parity check
+ * matrix (ie. the edges of the Tanner graph), in contiguous arrays indexed
+ * by edge; see the edge-indexed message store below.
+ *
+ * Two message-passing schedules are available. With flooding, every check
+ * is updated from the symbol messages of the previous iteration, and then
+ * every symbol from the new check messages. With the layered (or shuffled)
+ * schedule, the checks are processed in turn, and the messages from the
+ * symbols of each check are recomputed just before it is updated, so that
+ * each check already sees the new messages of the checks before it. This
+ * typically converges in about half the number of iterations.
+ *
+ * With flooding, the checks (and then the symbols) are independent, so
+ * when OpenMP is available they are split across threads for long codes.
+ * Each thread has its own work space, allocated by spa_init, so that no
+ * memory is allocated while passing messages.
  */
 template <class GF_q, class real = double> class sum_prod_alg_abstract : public sum_prod_alg_inf<
       GF_q, real> {
@@ -58,28 +84,66 @@ public:
     */
    sum_prod_alg_abstract(int n, int m, const array1vi_t& non_zero_col_pos,
          const array1vi_t& non_zero_row_pos,
-         const libbase::matrix<GF_q>& pchk_matrix) :
-      length_n(n), dim_m(m), M_n(non_zero_col_pos), N_m(non_zero_row_pos)
+         const libbase::matrix<GF_q>& pchk_matrix, bool layered) :
+      length_n(n), dim_m(m), M_n(non_zero_col_pos), N_m(non_zero_row_pos),
+            layered(layered)
       {
       //default values for clipping method
       this->almostzero = real(1E-100);
       this->clipping_method = 0;
 
-      this->marginal_probs.init(m, n);
-
+      int num_of_elements = GF_q::elements();
       int non_zeros = 0;
       int pos = 0;
 
+      //number the edges in check order
+      this->check_start.init(this->dim_m + 1);
+      this->check_start(0) = 0;
+      this->max_row_weight = 0;
+      for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+         {
+         non_zeros = this->N_m(loop_m).size();
+         this->check_start(loop_m + 1) = this->check_start(loop_m) + non_zeros;
+         this->max_row_weight = std::max(this->max_row_weight, non_zeros);
+         }
+      this->num_edges = this->check_start(this->dim_m);
+
+      //index the same edges in variable order
+      this->var_start.init(this->length_n + 1);
+      this->var_start(0) = 0;
+      for (int loop_n = 0; loop_n < this->length_n; loop_n++)
+         {
+         non_zeros = this->M_n(loop_n).size();
+         this->var_start(loop_n + 1) = this->var_start(loop_n) + non_zeros;
+         }
+      assertalways(this->var_start(this->length_n) == this->num_edges);
+      this->var_edge.init(this->num_edges);
+      this->var_edge = -1;
+      this->edge_var_pos.init(this->num_edges);
+
+      this->edge_val.init(this->num_edges);
       for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
          {
          non_zeros = this->N_m(loop_m).size();
          for (int loop_n = 0; loop_n < non_zeros; loop_n++)
             {
             pos = this->N_m(loop_m)(loop_n) - 1;//we count from zero;
-
-            this->marginal_probs(loop_m, pos).val = pchk_matrix(loop_m, pos);
+            const int edge = this->check_start(loop_m) + loop_n;
+            this->edge_val(edge) = pchk_matrix(loop_m, pos);
+            //find this check in the list for the variable
+            const int size_M_n = this->M_n(pos).size();
+            int loop_e = 0;
+            while (loop_e < size_M_n && this->M_n(pos)(loop_e) - 1 != loop_m)
+               loop_e++;
+            assertalways(loop_e < size_M_n);
+            this->var_edge(this->var_start(pos) + loop_e) = edge;
+            this->edge_var_pos(edge) = loop_e;
             }
          }
+
+      //allocate the messages; q_conv is only used by some implementations
+      this->q_mxn.init(this->num_edges * num_of_elements);
+      this->r_mxn.init(this->num_edges * num_of_elements);
       }
    /*! \brief default destructor
     *
@@ -142,7 +206,8 @@ public:
 
    /*!\brief carry out one iteration of the SPA
     * This method will carry out the horizontal and vertical step
-    * of the SPA and store the result in the ro vector
+    * of the SPA (either flooding or layered) and store the result in the
+    * ro vector
     */
    void spa_iteration(array1vd_t& ro);
 
@@ -170,40 +235,99 @@ public:
       }
 
 protected:
-   /*! \brief carries out the horizontal step of SPA
-    * The r_mxn probabilities are computed
+   /*! \brief the number of threads that may pass messages concurrently
+    *
+    */
+   static int max_threads()
+      {
+#ifdef USE_OMP
+      return omp_get_max_threads();
+#else
+      return 1;
+#endif
+      }
+
+   /*! \brief the index of the calling thread, which selects its work space
+    *
+    */
+   static int thread_index()
+      {
+#ifdef USE_OMP
+      return omp_get_thread_num();
+#else
+      return 0;
+#endif
+      }
+
+   /*! \brief ensure there is a work space for each thread
+    * This is called by spa_init, so that the number of threads may change
+    * between frames; the work space is only reallocated when it does.
+    */
+   void prepare_workspace()
+      {
+      const int threads = max_threads();
+      if (this->q_mn_work.size() != threads)
+         {
+         this->allocate_workspace(threads);
+         }
+      }
+
+   /*! \brief allocate the work space for the given number of threads
+    * Implementations that need their own work space should extend this.
+    */
+   virtual void allocate_workspace(int threads)
+      {
+      this->q_mn_work.init(threads);
+      for (int loop_t = 0; loop_t < threads; loop_t++)
+         {
+         this->q_mn_work(loop_t).init(GF_q::elements());
+         }
+      }
+
+   /*! \brief carries out the horizontal step of SPA for check m
+    * The r_mxn probabilities are computed for all the symbols n that
+    * participate in check m
     */
-   virtual void compute_r_mn(int m, int n, const array1i_t & tmpN_m)=0;
+   virtual void compute_r_m(int m, const array1i_t & tmpN_m)=0;
    /*! \brief carried out the horizontal step of the SPA
     * the q_mxn probabilities are computed
     */
    virtual void compute_q_mn(int m, int n, const array1i_t & M_n)=0;
 
+   /*! \brief returns the suffix to the SPA type for the schedule used
+    *
+    */
+   std::string schedule_suffix() const
+      {
+      return this->layered ? "-layered" : "";
+      }
+
+   /*! \brief index of the edge joining check m to its n-th symbol
+    *
+    */
+   int check_edge(int m, int n) const
+      {
+      return this->check_start(m) + n;
+      }
+
+   /*! \brief index of the edge joining symbol n to its m-th check
+    *
+    */
+   int var_edge_at(int n, int m) const
+      {
+      return this->var_edge(this->var_start(n) + m);
+      }
+
 private:
+   void flooding_iteration();
+   void layered_iteration();
    void compute_probs(array1vd_t& ro);
    void print_marginal_probs(std::ostream& sout);
    void print_marginal_probs(int col, std::ostream& sout);
+   void print_edge(int edge, std::ostream& sout);
 
 protected:
 
-   /*! \name Data structures
-    * LDPC specific datastructure used by the Sum-Product Algorithm
-    */
-
-   /* see MacKay's Information Theory, Inference and Learning Algs (2003, ch 47.3,pp 559-561)
-    * for a proper definition of the following variables.
-    */
-
-   //!this struct holds the probabilities that check m is satisfied if symbol n of the received word is
-   //fixed at symbols and the other symbols(<>n) have separable distributions given by q_mxn
-   struct marginals {
-      array1d_t q_mxn;
-      array1d_t qmn_conv;//! this holds the fast FFT transforms of the q_mxns
-      array1d_t r_mxn;
-      GF_q val; //this holds the non_zero entry at position (m,n)
-   };
-   // @}
-
    //the number of cols
    int length_n;
    //the number of rows
@@ -217,8 +341,44 @@ protected:
    //the positions of the non-zero entries per row
    array1vi_t N_m;
 
-   //! this matrix holds the r_mxn probabilities
-   libbase::matrix<marginals> marginal_probs;
+   /*! \name Data structures
+    * LDPC specific datastructure used by the Sum-Product Algorithm
+    */
+
+   /* see MacKay's Information Theory, Inference and Learning Algs (2003, ch 47.3,pp 559-561)
+    * for a proper definition of the following variables.
+    *
+    * Each non-zero entry of the parity check matrix is an edge of the graph.
+    * Edges are numbered in check order: the edges of check m are
+    * check_start(m) to check_start(m+1)-1, in the order given by N_m(m).
+    * The edges of symbol n are listed in var_edge, from var_start(n) to
+    * var_start(n+1)-1, in the order given by M_n(n).
+    * Messages are held contiguously, with q=|GF_q| values per edge, so the
+    * values for edge e are at positions e*q to e*q+q-1.
+    */
+   //! the number of edges, ie non-zero entries in the parity check matrix
+   int num_edges;
+   //! the largest number of symbols in a check
+   int max_row_weight;
+   //! the first edge of each check, with an extra entry for the end
+   array1i_t check_start;
+   //! the first position in var_edge for each symbol, with an extra entry
+   array1i_t var_start;
+   //! the edges of each symbol, in symbol order
+   array1i_t var_edge;
+   //! the position of each edge in the list of checks of its symbol
+   array1i_t edge_var_pos;
+   //! the non-zero entry of the parity check matrix at each edge
+   libbase::vector<GF_q> edge_val;
+   //! q_mxn(x): the probability that symbol n is x, given the information
+   //! from checks other than m
+   array1d_t q_mxn;
+   //! the fast Hadamard transforms of the q_mxns
+   array1d_t qmn_conv;
+   //! r_mxn(x): the probability that check m is satisfied if symbol n is x
+   //! and the other symbols have separable distributions given by q_mxn
+   array1d_t r_mxn;
+   // @}
 
    //! the clipping method used
    // 0-replace 0 with almostzero
@@ -228,6 +388,15 @@ protected:
    //! this is the value we assign to zero probs
    real almostzero;
 
+   //! flag indicating the layered schedule is used instead of flooding
+   bool layered;
+
+   //! per-thread work space for computing the q_mxn's of a symbol
+   array1vd_t q_mn_work;
+
+   //! the smallest number of nodes for which a pass is split across threads
+   static const int parallel_threshold = 256;
+
 };
 
 } // end namespace
@@ -40,6 +40,8 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
    real tmp_prob = real(0.0);
    real alpha = real(0.0);
 
+   this->prepare_workspace();
+
    //initialise the marginal prob values
    //ensure we don't have zero probabilities
    //and normalise the probs at the same time
@@ -74,8 +76,8 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
    int pos = 0;
    int non_zeros = 0;
    int h_m_n = 0;
-
-   array1vd_t qmn_conv;
+   int edge = 0;
+   int base = 0;
 
    //simply set q_mxn(0)=P_n(0)=P(x_n=0) and q_mxn(1)=P_n(1)=P(x_n=1)
    for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
@@ -84,8 +86,10 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
       for (int loop_n = 0; loop_n < non_zeros; loop_n++)
          {
          pos = this->N_m(loop_m)(loop_n) - 1;//we count from zero;
-         h_m_n = this-> marginal_probs(loop_m, pos).val;
-         this->marginal_probs(loop_m, pos).q_mxn = this->received_probs(pos);
+         edge = this->check_edge(loop_m, loop_n);
+         base = edge * num_of_elements;
+         h_m_n = this->edge_val(edge);
+         this->q_mxn.segment(base, num_of_elements) = this->received_probs(pos);
 
          // If h_m_n is not 1 we need to permute the probs.
          if (1 != h_m_n)
@@ -99,26 +103,26 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
                {
                //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
                //computation (I hope)
-               this ->marginal_probs(loop_m, pos).qmn_conv(this->perms(h_m_n)(
-                     loop_e)) = this->received_probs(pos)(loop_e);
+               this->qmn_conv(base + this->perms(h_m_n)(loop_e))
+                     = this->received_probs(pos)(loop_e);
                }
             }
          else
             {
             //no permutation needed as h_m_n=1
-            this->marginal_probs(loop_m, pos).qmn_conv = this->received_probs(
-                  pos);
+            this->qmn_conv.segment(base, num_of_elements)
+                  = this->received_probs(pos);
             }
-         this ->compute_convs(this ->marginal_probs(loop_m, pos).qmn_conv, 0,
-               num_of_elements - 1);
+         this ->compute_convs(this->qmn_conv, base, base + num_of_elements - 1);
          }
-      this->marginal_probs(loop_m, pos).r_mxn = 0.0;
       }
+   //start with neutral messages, as needed by the layered schedule
+   this->r_mxn = 1.0;
 
 #if DEBUG>=2
    libbase::trace << " Memory Usage:\n ";
-   libbase::trace << this->marginal_probs.size()
-   * sizeof(sum_prod_alg_abstract<GF_q,real>::marginals) / double(1 << 20)
+   libbase::trace << (this->q_mxn.size() + this->qmn_conv.size()
+         + this->r_mxn.size()) * sizeof(real) / double(1 << 20)
    << " MB" << std::endl;
 
    libbase::trace << std::endl << "The marginal matrix is given by:" << std::endl;
@@ -127,6 +131,23 @@ void sum_prod_alg_gdl<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
 
    }
 
+template <class GF_q, class real>
+void sum_prod_alg_gdl<GF_q, real>::allocate_workspace(int threads)
+   {
+   sum_prod_alg_abstract<GF_q, real>::allocate_workspace(threads);
+   //allocate the work space for the largest check
+   int num_of_elements = GF_q::elements();
+   this->fwd_prod.init(threads);
+   this->bwd_prod.init(threads);
+   this->q_nm_conv_prod.init(threads);
+   for (int loop_t = 0; loop_t < threads; loop_t++)
+      {
+      this->fwd_prod(loop_t).init((this->max_row_weight + 1) * num_of_elements);
+      this->bwd_prod(loop_t).init((this->max_row_weight + 1) * num_of_elements);
+      this->q_nm_conv_prod(loop_t).init(num_of_elements);
+      }
+   }
+
 template <class GF_q, class real>
 void sum_prod_alg_gdl<GF_q, real>::compute_convs(array1d_t & conv_out,
       int pos1, int pos2)
@@ -159,89 +180,138 @@ void sum_prod_alg_gdl<GF_q, real>::compute_convs(array1d_t & conv_out,
 
 //specialisation for GF(2)
 template <>
-void sum_prod_alg_gdl<libbase::gf2 , double>::compute_r_mn(int m, int n,
+void sum_prod_alg_gdl<libbase::gf2 , double>::compute_r_m(int m,
       const array1i_t & tmpN_m)
    {
    //the number of participating symbols
    int num_of_var_syms = tmpN_m.size();
-
-   int pos_n = tmpN_m(n) - 1;//we count from 1;
-
-   int pos_n_dash;
-
-   double q_nm_conv_prod = 1.0;
-   for (int loop2 = 0; loop2 < num_of_var_syms; loop2++)
+   //the work space for this thread
+   const int thread = this->thread_index();
+   array1d_t& fwd_prod = this->fwd_prod(thread);
+   array1d_t& bwd_prod = this->bwd_prod(thread);
+
+   //forward pass: fwd_prod(j) is the product over the symbols before j
+   fwd_prod(0) = 1.0;
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      if (loop2 != n)
-         {
-         pos_n_dash = tmpN_m(loop2) - 1;//we count from zero
-         q_nm_conv_prod *= this->marginal_probs(m, pos_n_dash).qmn_conv(1);
-         }
+      fwd_prod(loop1 + 1) = fwd_prod(loop1) * this->qmn_conv(2
+            * this->check_edge(m, loop1) + 1);
+      }
+   //backward pass: bwd_prod(j) is the product over the symbols from j on
+   bwd_prod(num_of_var_syms) = 1.0;
+   for (int loop1 = num_of_var_syms - 1; loop1 >= 0; loop1--)
+      {
+      bwd_prod(loop1) = bwd_prod(loop1 + 1) * this->qmn_conv(2
+            * this->check_edge(m, loop1) + 1);
       }
-   this->marginal_probs(m, pos_n).r_mxn(0) = 0.5 * (1.0 + q_nm_conv_prod);
-   this->marginal_probs(m, pos_n).r_mxn(1) = 0.5 * (1.0 - q_nm_conv_prod);
 
+   int edge;
+   double q_nm_conv_prod;
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
+      {
+      //the product over all the other symbols
+      q_nm_conv_prod = fwd_prod(loop1) * bwd_prod(loop1 + 1);
+      edge = this->check_edge(m, loop1);
+      this->r_mxn(2 * edge) = 0.5 * (1.0 + q_nm_conv_prod);
+      this->r_mxn(2 * edge + 1) = 0.5 * (1.0 - q_nm_conv_prod);
+      }
    }
 
 template <class GF_q, class real>
-void sum_prod_alg_gdl<GF_q, real>::compute_r_mn(int m, int n,
+void sum_prod_alg_gdl<GF_q, real>::compute_r_m(int m,
       const array1i_t & tmpN_m)
    {
    //the number of participating symbols
    int num_of_var_syms = tmpN_m.size();
    int num_of_elements = GF_q::elements();
-
-   int pos_n = tmpN_m(n) - 1;//we count from 1;
-   //note the following should never be a division by zero!
-   int h_m_n = this->marginal_probs(m, pos_n).val;
-
-   int pos_n_dash;
-
-   array1d_t q_nm_conv_prod;
-   q_nm_conv_prod.init(num_of_elements);
-   q_nm_conv_prod = 1.0;
-   for (int loop2 = 1; loop2 < num_of_elements; loop2++)
+   //the work space for this thread
+   const int thread = this->thread_index();
+   array1d_t& fwd_prod = this->fwd_prod(thread);
+   array1d_t& bwd_prod = this->bwd_prod(thread);
+   array1d_t& q_nm_conv_prod = this->q_nm_conv_prod(thread);
+
+   int edge;
+   int base;
+   int h_m_n;
+
+   //this uses the FFT of the q_mxn to work out the r_mn
+   //note that the first entry of each transform is the sum of the
+   //(normalised) probabilities, so that it is taken to be 1
+
+   //forward pass: fwd_prod(j) is the product over the symbols before j
+   for (int loop2 = 0; loop2 < num_of_elements; loop2++)
+      {
+      fwd_prod(loop2) = 1.0;
+      }
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
+      base = this->check_edge(m, loop1) * num_of_elements;
+      fwd_prod((loop1 + 1) * num_of_elements) = 1.0;
+      for (int loop2 = 1; loop2 < num_of_elements; loop2++)
          {
-         if (loop1 != n)
-            {
-            pos_n_dash = tmpN_m(loop1) - 1;//we count from zero
-
-            //this uses the FFT of the q_mxn to work out the r_mn
-            q_nm_conv_prod(loop2)
-                  *= this->marginal_probs(m, pos_n_dash).qmn_conv(loop2);
-            }
+         fwd_prod((loop1 + 1) * num_of_elements + loop2)
+               = fwd_prod(loop1 * num_of_elements + loop2)
+                     * this->qmn_conv(base + loop2);
          }
       }
-
-   //apply the FFT again to get the proper values
-   this->compute_convs(q_nm_conv_prod, 0, num_of_elements - 1);
-
-   /*
-    * ensure that the values in q_nm_conv_prod make sense, ie
-    * they should all be >0 and sum up to 1
-    * Note we don't allow zero values either as no prob should be
-    * completely 0.
-    */
-   real sum_qnm = real(0.0);
-   for (int loop1 = 0; loop1 < num_of_elements; loop1++)
+   //backward pass: bwd_prod(j) is the product over the symbols from j on
+   for (int loop2 = 0; loop2 < num_of_elements; loop2++)
       {
-      //Clipping HACK
-      this->perform_clipping(q_nm_conv_prod(loop1));
-      sum_qnm += q_nm_conv_prod(loop1);
+      bwd_prod(num_of_var_syms * num_of_elements + loop2) = 1.0;
+      }
+   for (int loop1 = num_of_var_syms - 1; loop1 >= 0; loop1--)
+      {
+      base = this->check_edge(m, loop1) * num_of_elements;
+      bwd_prod(loop1 * num_of_elements) = 1.0;
+      for (int loop2 = 1; loop2 < num_of_elements; loop2++)
+         {
+         bwd_prod(loop1 * num_of_elements + loop2) = bwd_prod(
+               (loop1 + 1) * num_of_elements + loop2) * this->qmn_conv(base
+               + loop2);
+         }
       }
 
-   //normalise them instead of simply dividing by the number of field elements.
-   assertalways(sum_qnm != real(0.0));
-   q_nm_conv_prod /= sum_qnm;
-
-   for (int loop1 = 0; loop1 < num_of_elements; loop1++)
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
-      //computation (I hope)
-      this ->marginal_probs(m, pos_n).r_mxn(loop1) = q_nm_conv_prod(
-            this->perms(h_m_n)(loop1));
+      edge = this->check_edge(m, loop1);
+      //note the following should never be a division by zero!
+      h_m_n = this->edge_val(edge);
+
+      //the product over all the other symbols
+      for (int loop2 = 0; loop2 < num_of_elements; loop2++)
+         {
+         q_nm_conv_prod(loop2) = fwd_prod(loop1 * num_of_elements
+               + loop2) * bwd_prod((loop1 + 1) * num_of_elements + loop2);
+         }
+
+      //apply the FFT again to get the proper values
+      this->compute_convs(q_nm_conv_prod, 0, num_of_elements - 1);
+
+      /*
+       * ensure that the values in q_nm_conv_prod make sense, ie
+       * they should all be >0 and sum up to 1
+       * Note we don't allow zero values either as no prob should be
+       * completely 0.
+       */
+      real sum_qnm = real(0.0);
+      for (int loop2 = 0; loop2 < num_of_elements; loop2++)
+         {
+         //Clipping HACK
+         this->perform_clipping(q_nm_conv_prod(loop2));
+         sum_qnm += q_nm_conv_prod(loop2);
+         }
+
+      //normalise them instead of simply dividing by the number of field elements.
+      assertalways(sum_qnm != real(0.0));
+      q_nm_conv_prod /= sum_qnm;
+
+      for (int loop2 = 0; loop2 < num_of_elements; loop2++)
+         {
+         //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
+         //computation (I hope)
+         this->r_mxn(edge * num_of_elements + loop2) = q_nm_conv_prod(
+               this->perms(h_m_n)(loop2));
+         }
       }
    }
 
@@ -251,11 +321,12 @@ void sum_prod_alg_gdl<GF_q, real>::compute_q_mn(int m, int n,
    {
    //initialise some helper variables
    int num_of_elements = GF_q::elements();
-   array1d_t q_mn(this -> received_probs(n));
+   array1d_t& q_mn = this->q_mn_work(this->thread_index());
+   q_mn = this->received_probs(n);
    real a_nxm = q_mn.sum();//sum up the values in q_mn
    assertalways(a_nxm!=real(0));
-   int m_dash = 0;
-   int pos_m = M_n(m) - 1;//we count from 1;
+   int edge_dash = 0;
+   int edge = this->var_edge_at(n, m);
 
    //compute q_mn(sym) = a_mxn * P_n(sym) * \prod_{m'\in M(n)\m} r_m'xn(0) for all sym in GF_q
    int size_of_M_n = M_n.size().length();
@@ -266,9 +337,9 @@ void sum_prod_alg_gdl<GF_q, real>::compute_q_mn(int m, int n,
          {
          if (m != loop_m)
             {
-            m_dash = M_n(loop_m) - 1; //we start counting from zero
+            edge_dash = this->var_edge_at(n, loop_m);
 
-            q_mn(loop_e) *= this->marginal_probs(m_dash, n).r_mxn(loop_e);
+            q_mn(loop_e) *= this->r_mxn(edge_dash * num_of_elements + loop_e);
             }
          }
       //Clipping HACK
@@ -289,10 +360,10 @@ void sum_prod_alg_gdl<GF_q, real>::compute_q_mn(int m, int n,
             {
             if (m != loop_m)
                {
-               m_dash = M_n(loop_m) - 1; //we start counting from zero
+               edge_dash = this->var_edge_at(n, loop_m);
                std::cerr << "q_mn(" << loop_e << ")=" << q_mn(loop_e) << " x "
-                     << this->marginal_probs(m_dash, n).r_mxn(loop_e) << std::endl;
-               q_mn(loop_e) *= this->marginal_probs(m_dash, n).r_mxn(loop_e);
+                     << this->r_mxn(edge_dash * num_of_elements + loop_e) << std::endl;
+               q_mn(loop_e) *= this->r_mxn(edge_dash * num_of_elements + loop_e);
                }
             }
          //Clipping HACK - just for error display purposes
@@ -322,18 +393,17 @@ void sum_prod_alg_gdl<GF_q, real>::compute_q_mn(int m, int n,
    assertalways(a_nxm!=real(0));
    q_mn /= a_nxm; //normalise
    //store the values
-   this->marginal_probs(pos_m, n).q_mxn = q_mn;
+   int base = edge * num_of_elements;
+   this->q_mxn.segment(base, num_of_elements) = q_mn;
    //compute the FFT and store it for the next iteration
-   int h_m_n = this->marginal_probs(pos_m, n).val;
+   int h_m_n = this->edge_val(edge);
    for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
       {
       //perms(h_m_n)(loop)=GF_q(h_m_n)*GF_q(loop) - a look-up is quicker than a
       //computation (I hope)
-      this ->marginal_probs(pos_m, n).qmn_conv(this->perms(h_m_n)(loop_e))
-            = q_mn(loop_e);
+      this->qmn_conv(base + this->perms(h_m_n)(loop_e)) = q_mn(loop_e);
       }
-   this ->compute_convs(this ->marginal_probs(pos_m, n).qmn_conv, 0,
-         num_of_elements - 1);
+   this ->compute_convs(this->qmn_conv, base, base + num_of_elements - 1);
 
    }
 
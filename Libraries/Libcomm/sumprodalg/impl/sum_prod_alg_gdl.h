@@ -47,23 +47,13 @@ public:
     */
    sum_prod_alg_gdl(int n, int m, const array1vi_t& non_zero_col_pos,
          const array1vi_t& non_zero_row_pos,
-         const libbase::matrix<GF_q>& pchk_matrix) :
+         const libbase::matrix<GF_q>& pchk_matrix, bool layered = false) :
       sum_prod_alg_abstract<GF_q, real>::sum_prod_alg_abstract(n, m,
-            non_zero_col_pos, non_zero_row_pos, pchk_matrix)
+            non_zero_col_pos, non_zero_row_pos, pchk_matrix, layered)
       {
       int num_of_elements = GF_q::elements();
-      int non_zeros = 0;
       int pos = 0;
-      for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
-         {
-         non_zeros = this->N_m(loop_m).size();
-         for (int loop_n = 0; loop_n < non_zeros; loop_n++)
-            {
-            pos = this->N_m(loop_m)(loop_n) - 1;//we count from zero;
-            this->marginal_probs(loop_m, pos).qmn_conv.init(num_of_elements);
-            this->marginal_probs(loop_m, pos).r_mxn.init(num_of_elements);
-            }
-         }
+      this->qmn_conv.init(this->num_edges * num_of_elements);
 
       this->perms.init(num_of_elements);
       this->perms(0).init(num_of_elements);
@@ -85,13 +75,16 @@ public:
       //nothing to do
       }
    void spa_init(const array1vd_t& ptable);
-   void compute_r_mn(int m, int n, const array1i_t & tmpN_m);
+   void compute_r_m(int m, const array1i_t & tmpN_m);
    void compute_q_mn(int m, int n, const array1i_t & M_n);
    std::string spa_type()
       {
-      return "gdl";
+      return "gdl" + this->schedule_suffix();
       }
 
+protected:
+   void allocate_workspace(int threads);
+
 private:
    /*! \brief compute the Fast Hadamard transform
     * This method will compute the Fast Fourier Transform of the
@@ -116,6 +109,15 @@ private:
     */
    array1vi_t perms;
 
+   /*! \brief per-thread work space for the check node update
+    * For position j in the check, fwd_prod holds the product of the
+    * transforms of the symbols before j, and bwd_prod the product of those
+    * from j onwards, with q values per position.
+    */
+   array1vd_t fwd_prod;
+   array1vd_t bwd_prod;
+   array1vd_t q_nm_conv_prod;
+
 };
 
 }
@@ -0,0 +1,221 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "sum_prod_alg_minsum.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+namespace libcomm {
+
+// Determine debug level:
+// 1 - Normal debug output only
+#ifndef NDEBUG
+#  undef DEBUG
+#  define DEBUG 1
+#endif
+
+template <class GF_q, class real>
+sum_prod_alg_minsum<GF_q, real>::sum_prod_alg_minsum(int n, int m,
+      const array1vi_t& non_zero_col_pos, const array1vi_t& non_zero_row_pos,
+      bool layered) :
+   length_n(n), dim_m(m), layered(layered)
+   {
+   assertalways(GF_q::elements() == 2);
+   assertalways(non_zero_col_pos.size() == n);
+   assertalways(non_zero_row_pos.size() == m);
+   //default values for clipping method
+   this->almostzero = real(1E-100);
+   this->clipping_method = 0;
+
+   //number the edges in check order
+   this->check_start.init(this->dim_m + 1);
+   this->check_start(0) = 0;
+   for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+      {
+      this->check_start(loop_m + 1) = this->check_start(loop_m)
+            + non_zero_row_pos(loop_m).size();
+      }
+   const int num_edges = this->check_start(this->dim_m);
+   this->edge_var.init(num_edges);
+   for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+      {
+      const int non_zeros = non_zero_row_pos(loop_m).size();
+      for (int loop_n = 0; loop_n < non_zeros; loop_n++)
+         {
+         //we count from zero
+         this->edge_var(this->check_start(loop_m) + loop_n)
+               = non_zero_row_pos(loop_m)(loop_n) - 1;
+         }
+      }
+
+   //allocate the messages
+   this->channel_llr.init(this->length_n);
+   this->posterior_llr.init(this->length_n);
+   this->r_llr.init(num_edges);
+   }
+
+template <class GF_q, class real>
+void sum_prod_alg_minsum<GF_q, real>::spa_init(const array1vd_t& ptable)
+   {
+   assertalways(ptable.size() == this->length_n);
+   for (int loop_n = 0; loop_n < this->length_n; loop_n++)
+      {
+      //ensure we don't have zero probabilities
+      real p0 = ptable(loop_n)(0);
+      real p1 = ptable(loop_n)(1);
+      this->perform_clipping(p0);
+      this->perform_clipping(p1);
+      //quantize the log-likelihood ratio, saturating infinite values
+      const double llr = log(double(p0 / p1)) * llr_scale;
+      this->channel_llr(loop_n) = saturate(libbase::int32s(std::max(std::min(
+            llr, double(msg_max)), -double(msg_max))));
+      }
+   this->posterior_llr = this->channel_llr;
+   this->r_llr = 0;
+   }
+
+template <class GF_q, class real>
+void sum_prod_alg_minsum<GF_q, real>::update_check(int m)
+   {
+   const int first = this->check_start(m);
+   const int last = this->check_start(m + 1);
+
+   //find the two smallest magnitudes of the messages from the symbols,
+   //the position of the smallest, and the parity of the signs
+   int min1 = msg_max;
+   int min2 = msg_max;
+   int min_pos = first;
+   int sign = 0;
+   for (int edge = first; edge < last; edge++)
+      {
+      const int q = saturate(this->posterior_llr(this->edge_var(edge))
+            - this->r_llr(edge));
+      const int a = std::abs(q);
+      min2 = std::min(min2, std::max(min1, a));
+      min_pos = (a < min1) ? edge : min_pos;
+      min1 = std::min(min1, a);
+      sign ^= (q < 0);
+      }
+   //scale the magnitudes by 3/4
+   min1 = (3 * min1) >> 2;
+   min2 = (3 * min2) >> 2;
+
+   //the message to each symbol excludes that symbol's own contribution
+   for (int edge = first; edge < last; edge++)
+      {
+      const int n = this->edge_var(edge);
+      const int q = saturate(this->posterior_llr(n) - this->r_llr(edge));
+      const int a = (edge == min_pos) ? min2 : min1;
+      const libbase::int16s r = libbase::int16s((sign ^ (q < 0)) ? -a : a);
+      this->r_llr(edge) = r;
+      if (this->layered)
+         {
+         this->posterior_llr(n) = q + r;
+         }
+      }
+   }
+
+template <class GF_q, class real>
+void sum_prod_alg_minsum<GF_q, real>::spa_iteration(array1vd_t& ro)
+   {
+   if (this->layered)
+      {
+      //each check sees the posteriors updated by the checks before it
+      for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+         {
+         this->update_check(loop_m);
+         }
+      }
+   else
+      {
+      //all the checks see the posteriors of the previous iteration, and
+      //only change their own messages, so they can be split across threads
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if (this->dim_m >= parallel_threshold)
+#endif
+      for (int loop_m = 0; loop_m < this->dim_m; loop_m++)
+         {
+         this->update_check(loop_m);
+         }
+      //now compute the posteriors from the new messages
+      this->posterior_llr = this->channel_llr;
+      const int num_edges = this->r_llr.size();
+      for (int edge = 0; edge < num_edges; edge++)
+         {
+         this->posterior_llr(this->edge_var(edge)) += this->r_llr(edge);
+         }
+      }
+
+   //compute the probabilities for all symbols, for the tentative decoding
+   ro.init(this->length_n);
+   for (int loop_n = 0; loop_n < this->length_n; loop_n++)
+      {
+      //P(x=1) = 1 / (1 + exp(L)), computed to avoid overflow
+      const double llr = double(this->posterior_llr(loop_n)) / llr_scale;
+      const double e = exp(-fabs(llr));
+      const double p_min = e / (1 + e);
+      ro(loop_n).init(2);
+      ro(loop_n)(0) = real(llr < 0 ? p_min : 1 - p_min);
+      ro(loop_n)(1) = real(llr < 0 ? 1 - p_min : p_min);
+      //Use appropriate clipping method
+      this->perform_clipping(ro(loop_n)(0));
+      this->perform_clipping(ro(loop_n)(1));
+      ro(loop_n) /= ro(loop_n).sum();
+      }
+   }
+
+} // end namespace
+
+#include "gf.h"
+#include "mpreal.h"
+#include "logrealfast.h"
+
+namespace libcomm {
+
+// Explicit Realizations
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/seq/for_each_product.hpp>
+#include <boost/preprocessor/seq/enum.hpp>
+
+using libbase::mpreal;
+using libbase::logrealfast;
+
+#define USING_GF(r, x, type) \
+      using libbase::type;
+
+BOOST_PP_SEQ_FOR_EACH(USING_GF, x, GF_TYPE_SEQ)
+
+#define REAL_TYPE_SEQ \
+      (double)(logrealfast)(mpreal)
+
+/* Serialization string: ldpc<type,real>
+ * where:
+ *      type = gf2 | gf4 ...
+ *      real = double | logrealfast | mpreal
+ */
+#define INSTANTIATE(r, args) \
+      template class sum_prod_alg_minsum<BOOST_PP_SEQ_ENUM(args)>;
+
+BOOST_PP_SEQ_FOR_EACH_PRODUCT(INSTANTIATE, (GF_TYPE_SEQ)(REAL_TYPE_SEQ))
+
+} // end namespace
@@ -0,0 +1,166 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SUM_PROD_ALG_MINSUM_H_
+#define SUM_PROD_ALG_MINSUM_H_
+
+#include "config.h"
+#include "vector.h"
+#include "sumprodalg/sum_prod_alg_inf.h"
+#include <string>
+
+namespace libcomm {
+
+/*! \brief Fixed-point Min-Sum decoder for binary LDPC codes
+ *
+ * This replaces the sum-product algorithm by its normalized min-sum
+ * approximation, working with log-likelihood ratios
+ *      L = log(P(x=0) / P(x=1))
+ * held as fixed-point integers with a resolution of 1/llr_scale, so that
+ * message passing uses only integer additions, comparisons and shifts.
+ * The messages on each edge are held as saturated 16-bit integers, in a
+ * contiguous array indexed by edge (in check order); the posterior of each
+ * symbol is held as a 32-bit integer.
+ *
+ * The message from a check to symbol n has the product of the signs of the
+ * messages from the other symbols, and the smallest of their magnitudes,
+ * scaled by 3/4 to compensate for the overestimate of the approximation.
+ * Only the two smallest magnitudes of each check need to be found.
+ *
+ * As for the sum-product implementations, either the flooding or the
+ * layered schedule can be used. With flooding, the checks are split across
+ * threads for long codes when OpenMP is available.
+ *
+ * \note This is only valid for binary codes.
+ *
+ * \note Frames are decoded one at a time through the usual codec interface;
+ * the speed-up comes from the integer messages, not from decoding several
+ * frames together.
+ */
+template <class GF_q, class real = double>
+class sum_prod_alg_minsum : public sum_prod_alg_inf<GF_q, real> {
+public:
+   /*! \name Type definitions */
+   typedef libbase::vector<real> array1d_t;
+   typedef libbase::vector<int> array1i_t;
+   typedef libbase::vector<array1i_t> array1vi_t;
+   typedef libbase::vector<array1d_t> array1vd_t;
+   // @}
+
+   /*! \brief constructor
+    * sets up the edges of the graph from the positions of the non-zero
+    * entries of the parity check matrix
+    */
+   sum_prod_alg_minsum(int n, int m, const array1vi_t& non_zero_col_pos,
+         const array1vi_t& non_zero_row_pos, bool layered = false);
+   virtual ~sum_prod_alg_minsum()
+      {
+      //nothing to do
+      }
+
+   void spa_init(const array1vd_t& ptable);
+   void spa_iteration(array1vd_t& ro);
+   std::string spa_type()
+      {
+      return this->layered ? "minsum-layered" : "minsum";
+      }
+
+   /*! \brief set the way the output probabilities are clipped
+    * Note that this is only applied to the received and output
+    * probabilities, as the messages themselves are saturated.
+    */
+   void set_clipping(std::string clipping_type, real almost_zero)
+      {
+      this->clipping_method = ("zero" == clipping_type) ? 0 : 1;
+      this->almostzero = almost_zero;
+      }
+   std::string get_clipping_type()
+      {
+      return (this->clipping_method == 1) ? "clip" : "zero";
+      }
+   real get_almostzero()
+      {
+      return this->almostzero;
+      }
+   void perform_clipping(real& num)
+      {
+      if (1 == this->clipping_method ? num < this->almostzero : num <= real(0.0))
+         {
+         num = this->almostzero;
+         }
+      }
+
+private:
+   /*! \brief compute the messages from check m to its symbols
+    * The messages from the symbols are the posteriors less the previous
+    * message from this check; with the layered schedule, the posteriors
+    * are updated immediately with the new messages.
+    */
+   void update_check(int m);
+
+   //! saturate a value to the range of the edge messages
+   static libbase::int16s saturate(libbase::int32s x)
+      {
+      return libbase::int16s(x > msg_max ? msg_max : (x < -msg_max ? -msg_max : x));
+      }
+
+private:
+   //! the number of fractional steps per unit of log-likelihood ratio
+   static const int llr_scale = 16;
+   //! the largest magnitude of an edge message
+   static const int msg_max = 32767;
+   //! the smallest number of checks for which a pass is split across threads
+   static const int parallel_threshold = 256;
+
+   //the number of cols
+   int length_n;
+   //the number of rows
+   int dim_m;
+
+   /*! \name Data structures */
+   //! the first edge of each check, with an extra entry for the end
+   array1i_t check_start;
+   //! the symbol at each edge
+   array1i_t edge_var;
+   //! the log-likelihood ratio of each symbol from the channel
+   libbase::vector<libbase::int32s> channel_llr;
+   //! the current posterior log-likelihood ratio of each symbol
+   libbase::vector<libbase::int32s> posterior_llr;
+   //! the message from the check to the symbol at each edge
+   libbase::vector<libbase::int16s> r_llr;
+   // @}
+
+   //! flag indicating the layered schedule is used instead of flooding
+   bool layered;
+
+   //! the clipping method used
+   // 0-replace 0 with almostzero
+   // 1-replace all values below almostzero with almostzero
+   int clipping_method;
+
+   //! this is the value we assign to zero probs
+   real almostzero;
+};
+
+}
+
+#endif /* SUM_PROD_ALG_MINSUM_H_ */
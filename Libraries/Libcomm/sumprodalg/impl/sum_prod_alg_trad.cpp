@@ -39,6 +39,8 @@ void sum_prod_alg_trad<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
    real tmp_prob = real(0.0);
    real alpha = real(0.0);
 
+   this->prepare_workspace();
+
    //ensure we don't have zero probabilities
    //and normalise the probs at the same time
 
@@ -74,17 +76,17 @@ void sum_prod_alg_trad<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
       for (int loop_n = 0; loop_n < non_zeros; loop_n++)
          {
          pos = this->N_m(loop_m)(loop_n) - 1;//we count from zero;
-         this->marginal_probs(loop_m, pos).q_mxn = this->received_probs(pos);
-         this->marginal_probs(loop_m, pos).r_mxn.init(num_of_elements);
-         this->marginal_probs(loop_m, pos).r_mxn = 0.0;
+         this->q_mxn.segment(this->check_edge(loop_m, loop_n)
+               * num_of_elements, num_of_elements) = this->received_probs(pos);
          }
       }
+   //start with neutral messages, as needed by the layered schedule
+   this->r_mxn = 1.0;
 
 #if DEBUG>=2
    libbase::trace << " Memory Usage:\n ";
-   libbase::trace << this->marginal_probs.size()
-   * sizeof(sum_prod_alg_abstract<GF_q,real>::marginals) / double(1 << 20)
-   << " MB" << std::endl;
+   libbase::trace << (this->q_mxn.size() + this->r_mxn.size()) * sizeof(real)
+   / double(1 << 20) << " MB" << std::endl;
 
    libbase::trace << std::endl << "The marginal matrix is given by:" << std::endl;
    this->print_marginal_probs(libbase::trace);
@@ -93,72 +95,116 @@ void sum_prod_alg_trad<GF_q, real>::spa_init(const array1vd_t& recvd_probs)
    }
 
 template <class GF_q, class real>
-void sum_prod_alg_trad<GF_q, real>::compute_r_mn(int m, int n,
+void sum_prod_alg_trad<GF_q, real>::allocate_workspace(int threads)
+   {
+   sum_prod_alg_abstract<GF_q, real>::allocate_workspace(threads);
+   //allocate the work space for the largest check
+   int num_of_elements = GF_q::elements();
+   this->perm_q.init(threads);
+   this->fwd_sum.init(threads);
+   this->bwd_sum.init(threads);
+   for (int loop_t = 0; loop_t < threads; loop_t++)
+      {
+      this->perm_q(loop_t).init(this->max_row_weight * num_of_elements);
+      this->fwd_sum(loop_t).init((this->max_row_weight + 1) * num_of_elements);
+      this->bwd_sum(loop_t).init((this->max_row_weight + 1) * num_of_elements);
+      }
+   }
+
+template <class GF_q, class real>
+void sum_prod_alg_trad<GF_q, real>::compute_r_m(int m,
       const array1i_t & tmpN_m)
    {
-   //the number of remaining symbols that can vary
-   int num_of_var_syms = tmpN_m.size() - 1;
+   //the number of participating symbols
+   int num_of_var_syms = tmpN_m.size();
    int num_of_elements = GF_q::elements();
-   //for each check node we need to consider num_of_elements^num_of_var_symbols cases
-   int num_of_cases = int(pow(num_of_elements, num_of_var_syms));
-   int pos_n = tmpN_m(n) - 1;//we count from 1;
-   int bitmask = num_of_elements - 1;
-
-   //only use the entries that are variable
-   array1i_t rel_N_m;
-   rel_N_m.init(num_of_var_syms);
-   int indx = 0;
-   for (int loop = 0; loop < num_of_var_syms; loop++)
+   //the work space for this thread
+   const int thread = this->thread_index();
+   array1d_t& perm_q = this->perm_q(thread);
+   array1d_t& fwd_sum = this->fwd_sum(thread);
+   array1d_t& bwd_sum = this->bwd_sum(thread);
+
+   //the check is satisfied when the sum of the h_mj*x_j is zero; for each
+   //symbol n we need the distribution of the sum over the other symbols,
+   //which is the convolution of their distributions. Note that addition in
+   //GF(2^k) is the bitwise XOR of the symbol values.
+
+   int edge;
+   int base;
+   GF_q h_m_n;
+
+   //permute the probs so that they give the distribution of h_mj*x_j
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      if (indx == n)
+      edge = this->check_edge(m, loop1);
+      h_m_n = this->edge_val(edge);
+      for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
          {
-         indx++;
+         perm_q(loop1 * num_of_elements + int(h_m_n * GF_q(loop_e)))
+               = this->q_mxn(edge * num_of_elements + loop_e);
          }
-      rel_N_m(loop) = tmpN_m(indx);
-      indx++;
       }
-   //go through all cases - this will use bitwise manipulation
-   GF_q syndrome_sym = GF_q(0);
-   GF_q h_m_n_dash;
-   //GF_q h_m_n;
-   GF_q tmp_chk_val;
 
-   int int_sym_val;
-   int bits;
-   int pos_n_dash;
-   real q_nm_prod = real(1.0);
-
-   this->marginal_probs(m, pos_n).r_mxn = 0.0;
-   GF_q check_value = this->marginal_probs(m, pos_n).val;
-
-   for (int loop1 = 0; loop1 < num_of_cases; loop1++)
+   //forward pass: fwd_sum(j) is the distribution of the sum before j
+   for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+      {
+      fwd_sum(loop_e) = real(0.0);
+      }
+   fwd_sum(0) = real(1.0);
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
       {
-      bits = loop1;
-      syndrome_sym = GF_q(0);
-      q_nm_prod = 1.0;
-      for (int loop2 = 0; loop2 < num_of_var_syms; loop2++)
+      base = loop1 * num_of_elements;
+      for (int loop_s = 0; loop_s < num_of_elements; loop_s++)
          {
+         real tmp_sum = real(0.0);
+         for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+            {
+            tmp_sum += fwd_sum(base + (loop_s ^ loop_e)) * perm_q(
+                  base + loop_e);
+            }
+         fwd_sum(base + num_of_elements + loop_s) = tmp_sum;
+         }
+      }
 
-         pos_n_dash = rel_N_m(loop2) - 1;//we count from zero
-
-         //extract int value of the first symbol
-         int_sym_val = bits & bitmask;
-         //shift bits to the right by the dimension of the finite field
-         bits = bits >> GF_q::dimension();
-
-         //the parity check symbol at this position
-         h_m_n_dash = this->marginal_probs(m, pos_n_dash).val;
-         //compute the value that at this check
-         tmp_chk_val = h_m_n_dash * GF_q(int_sym_val);
+   //backward pass: bwd_sum(j) is the distribution of the sum from j on
+   base = num_of_var_syms * num_of_elements;
+   for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+      {
+      bwd_sum(base + loop_e) = real(0.0);
+      }
+   bwd_sum(base) = real(1.0);
+   for (int loop1 = num_of_var_syms - 1; loop1 >= 0; loop1--)
+      {
+      base = loop1 * num_of_elements;
+      for (int loop_s = 0; loop_s < num_of_elements; loop_s++)
+         {
+         real tmp_sum = real(0.0);
+         for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+            {
+            tmp_sum += bwd_sum(base + num_of_elements + (loop_s
+                  ^ loop_e)) * perm_q(base + loop_e);
+            }
+         bwd_sum(base + loop_s) = tmp_sum;
+         }
+      }
 
-         //add it to the syndrome
-         syndrome_sym = syndrome_sym + tmp_chk_val;
-         //look up the prob that the chk_val was actually sent
-         q_nm_prod *= this->marginal_probs(m, pos_n_dash).q_mxn(int_sym_val);
+   //combine: the sum over the other symbols must be equal to h_mn*x_n
+   for (int loop1 = 0; loop1 < num_of_var_syms; loop1++)
+      {
+      edge = this->check_edge(m, loop1);
+      h_m_n = this->edge_val(edge);
+      base = loop1 * num_of_elements;
+      for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
+         {
+         int sym = h_m_n * GF_q(loop_e);
+         real tmp_sum = real(0.0);
+         for (int loop_s = 0; loop_s < num_of_elements; loop_s++)
+            {
+            tmp_sum += fwd_sum(base + loop_s) * bwd_sum(base
+                  + num_of_elements + (loop_s ^ sym));
+            }
+         this->r_mxn(edge * num_of_elements + loop_e) = tmp_sum;
          }
-      //adjust the appropriate rmn value
-      int_sym_val = syndrome_sym / check_value;
-      this->marginal_probs(m, pos_n).r_mxn(int_sym_val) += q_nm_prod;
       }
    }
 
@@ -169,10 +215,11 @@ void sum_prod_alg_trad<GF_q, real>::compute_q_mn(int m, int n,
 
    //initialise some helper variables
    int num_of_elements = GF_q::elements();
-   array1d_t q_mn(this -> received_probs(n));
+   array1d_t& q_mn = this->q_mn_work(this->thread_index());
+   q_mn = this->received_probs(n);
 
-   int m_dash = 0;
-   int pos_m = M_n(m) - 1;//we count from 1;
+   int edge_dash = 0;
+   int edge = this->var_edge_at(n, m);
 
    //compute q_mn(sym) = a_mxn * P_n(sym) * \prod_{m'\in M(n)\m} r_m'xn(0) for all sym in GF_q
    int size_of_M_n = M_n.size().length();
@@ -180,10 +227,10 @@ void sum_prod_alg_trad<GF_q, real>::compute_q_mn(int m, int n,
       {
       if (m != loop_m)
          {
-         m_dash = M_n(loop_m) - 1; //we start counting from zero
+         edge_dash = this->var_edge_at(n, loop_m);
          for (int loop_e = 0; loop_e < num_of_elements; loop_e++)
             {
-            q_mn(loop_e) *= this->marginal_probs(m_dash, n).r_mxn(loop_e);
+            q_mn(loop_e) *= this->r_mxn(edge_dash * num_of_elements + loop_e);
             }
          }
       }
@@ -194,7 +241,7 @@ void sum_prod_alg_trad<GF_q, real>::compute_q_mn(int m, int n,
    q_mn /= a_nxm; //normalise
 
    //store the values
-   this->marginal_probs(pos_m, n).q_mxn = q_mn;
+   this->q_mxn.segment(edge * num_of_elements, num_of_elements) = q_mn;
    }
 
 } // end namespace
@@ -37,23 +37,38 @@ public:
 
    sum_prod_alg_trad(int n, int m, const array1vi_t& non_zero_col_pos,
          const array1vi_t& non_zero_row_pos,
-         const libbase::matrix<GF_q>& pchk_matrix) :
+         const libbase::matrix<GF_q>& pchk_matrix, bool layered = false) :
       sum_prod_alg_abstract<GF_q, real>::sum_prod_alg_abstract(n, m,
-            non_zero_col_pos, non_zero_row_pos, pchk_matrix)
+            non_zero_col_pos, non_zero_row_pos, pchk_matrix, layered)
       {
+      //nothing to do
       }
    virtual ~sum_prod_alg_trad()
       {
       //nothing to do
       }
    void spa_init(const array1vd_t& ptable);
-   void compute_r_mn(int m, int n, const array1i_t & tmpN_m);
+   void compute_r_m(int m, const array1i_t & tmpN_m);
    void compute_q_mn(int m, int n, const array1i_t & M_n);
 
    std::string spa_type()
       {
-      return "trad";
+      return "trad" + this->schedule_suffix();
       }
+
+protected:
+   void allocate_workspace(int threads);
+
+private:
+   /*! \brief per-thread work space for the check node update
+    * For position j in the check, perm_q holds the distribution of h_mj*x_j,
+    * fwd_sum holds the distribution of the sum of these terms before j, and
+    * bwd_sum that of the sum of the terms from j onwards, with q values per
+    * position.
+    */
+   array1vd_t perm_q;
+   array1vd_t fwd_sum;
+   array1vd_t bwd_sum;
 };
 
 }
@@ -24,6 +24,7 @@
 #include "sum_prod_alg_inf.h"
 #include "sumprodalg/impl/sum_prod_alg_trad.h"
 #include "sumprodalg/impl/sum_prod_alg_gdl.h"
+#include "sumprodalg/impl/sum_prod_alg_minsum.h"
 #include "gf.h"
 #include "matrix.h"
 
@@ -35,11 +36,16 @@
 namespace libcomm {
 /*! \brief factory to return the desired SPA implementation
  * This factory allows the user to choose the SPA implementation
- * required for the code. Two choices are currently supported:
- * trad and gdl
- * trad is computationally expensive but easy to understand
+ * required for the code. Three choices are currently supported:
+ * trad, gdl and minsum
+ * trad works directly with the probabilities, which is simpler to
+ * follow and works with any representation of 'real'
  * gdl uses Fast Hadamard/Fourier Transforms to speed up the
  * computations.
+ * minsum is the fixed-point normalized min-sum approximation, which is
+ * much faster but only works for binary codes.
+ * Any of these can be followed by "-layered" (eg. gdl-layered) to use the
+ * layered schedule instead of flooding.
  */
 template <class GF_q, class real = double>
 class spa_factory {
@@ -59,17 +65,27 @@ public:
          const libbase::matrix<GF_q> pchk_matrix)
       {
       boost::shared_ptr<sum_prod_alg_inf<GF_q, real> > spa_ptr;
-      if ("trad" == type)
+      if ("trad" == type || "trad-layered" == type)
          {
          spa_ptr = boost::shared_ptr<sum_prod_alg_inf<GF_q, real> >(
                new sum_prod_alg_trad<GF_q, real> (n, m, non_zero_col_pos,
-                     non_zero_row_pos, pchk_matrix));
+                     non_zero_row_pos, pchk_matrix, "trad" != type));
          }
-      else if ("gdl" == type)
+      else if ("gdl" == type || "gdl-layered" == type)
          {
          spa_ptr = boost::shared_ptr<sum_prod_alg_inf<GF_q, real> >(
                new sum_prod_alg_gdl<GF_q, real> (n, m, non_zero_col_pos,
-                     non_zero_row_pos, pchk_matrix));
+                     non_zero_row_pos, pchk_matrix, "gdl" != type));
+         }
+      else if ("minsum" == type || "minsum-layered" == type)
+         {
+         if (GF_q::elements() != 2)
+            {
+            failwith("minsum is only available for binary codes");
+            }
+         spa_ptr = boost::shared_ptr<sum_prod_alg_inf<GF_q, real> >(
+               new sum_prod_alg_minsum<GF_q, real> (n, m, non_zero_col_pos,
+                     non_zero_row_pos, "minsum" != type));
          }
       else
          {
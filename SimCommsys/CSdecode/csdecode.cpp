@@ -25,11 +25,17 @@
 #include "commsys_stream.h"
 #include "channel_stream.h"
 #include "codec/codec_softout.h"
+#include "framed_stream.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
 #include <iostream>
 #include <list>
+#include <vector>
+
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
 
 namespace csdecode {
 
@@ -96,10 +102,19 @@ void readsingleblock(std::istream& sin, libbase::matrix<S>& result,
 
 template <class S, template <class > class C>
 void readnextblock(std::istream& sin, C<S>& result,
-      const libbase::size_type<C>& blocksize)
+      const libbase::size_type<C>& blocksize, bool binary)
    {
-   result.init(blocksize);
-   result.serialize(sin);
+   if (binary)
+      {
+      const bool ok = libcomm::read_frame(sin, result);
+      assertalways(ok);
+      assertalways(result.size() == blocksize);
+      }
+   else
+      {
+      result.init(blocksize);
+      result.serialize(sin);
+      }
    }
 
 // block read and receive methods
@@ -113,11 +128,11 @@ void receiver_soft_single(std::istream& sin, libcomm::commsys<S, C>* system,
 
 template <class S, template <class > class C>
 void receiver_soft_multi(std::istream& sin, libcomm::commsys<S, C>* system,
-      const libbase::size_type<C>& blocksize)
+      const libbase::size_type<C>& blocksize, bool binary)
    {
    typedef libbase::vector<double> array1d_t;
    C<array1d_t> ptable_in;
-   readnextblock(sin, ptable_in, blocksize);
+   readnextblock(sin, ptable_in, blocksize, binary);
    system->softreceive_path(ptable_in);
    }
 
@@ -130,15 +145,6 @@ void receiver_single(std::istream& sin, libcomm::commsys<S, C>* system,
    system->receive_path(received);
    }
 
-template <class S, template <class > class C>
-void receiver_multi(std::istream& sin, libcomm::commsys<S, C>* system,
-      const libbase::size_type<C>& blocksize)
-   {
-   C<S> received;
-   readnextblock(sin, received, blocksize);
-   system->receive_path(received);
-   }
-
 //template <class S, template <class > class C>
 //void receiver_multi_stream(std::istream& sin,
 //      libcomm::commsys_stream<S, C>* system,
@@ -226,27 +232,266 @@ void receiver_multi_stream(std::istream& sin, libcomm::commsys_stream<S,
    failwith("Not implemented.");
    }
 
-// results output methods
+// decoding methods
 
 template <class S, template <class > class C>
-void decode_soft(std::ostream& sout, libcomm::commsys<S, C>* system)
+void decode_soft(libcomm::commsys<S, C>* system,
+      C<libbase::vector<double> >& ptable_out)
    {
-   typedef libbase::vector<double> array1d_t;
    typedef libcomm::codec_softout<C> codec_so;
    codec_so& cdc = dynamic_cast<codec_so&> (*system->getcodec());
-   C<array1d_t> ptable_out;
    for (int i = 0; i < system->num_iter(); i++)
       cdc.softdecode(ptable_out);
-   ptable_out.serialize(sout);
    }
 
 template <class S, template <class > class C>
-void decode(std::ostream& sout, libcomm::commsys<S, C>* system)
+void decode(libcomm::commsys<S, C>* system, C<int>& decoded)
    {
-   C<int> decoded;
    for (int i = 0; i < system->num_iter(); i++)
       system->decode(decoded);
-   decoded.serialize(sout, '\n');
+   }
+
+// results output methods
+
+template <template <class > class C>
+void write_soft(std::ostream& sout,
+      const C<libbase::vector<double> >& ptable_out, bool binary)
+   {
+   if (binary)
+      libcomm::write_frame(sout, ptable_out);
+   else
+      ptable_out.serialize(sout);
+   }
+
+template <template <class > class C>
+void write(std::ostream& sout, const C<int>& decoded, bool binary)
+   {
+   if (binary)
+      libcomm::write_frame(sout, decoded);
+   else
+      decoded.serialize(sout, '\n');
+   }
+
+// combined decoding and output
+
+template <class S, template <class > class C>
+void decode_and_write(libcomm::commsys<S, C>* system, bool softout,
+      bool binout, std::ostream& sout)
+   {
+   if (softout)
+      {
+      C<libbase::vector<double> > ptable_out;
+      decode_soft(system, ptable_out);
+      write_soft(sout, ptable_out, binout);
+      }
+   else
+      {
+      C<int> decoded;
+      decode(system, decoded);
+      write(sout, decoded, binout);
+      }
+   }
+
+/*!
+ * \brief   Load system
+ *
+ * Reads the supplied system from file, sets the channel parameter, and
+ * seeds it in the same way as the encoder and transmitter.
+ */
+
+template <class S, template <class > class C>
+libcomm::commsys<S, C>* load_system(const std::string& fname, double p)
+   {
+   libcomm::commsys<S, C> *system = libcomm::loadfromfile<
+         libcomm::commsys<S, C> >(fname);
+   // Set channel parameter
+   system->getrxchan()->set_parameter(p);
+   // Initialize system
+   libbase::randgen r;
+   r.seed(0);
+   system->seedfrom(r);
+   return system;
+   }
+
+#ifdef USE_OMP
+
+//! Working space for a single frame in pipelined mode
+template <class S, template <class > class C>
+struct frame {
+   C<S> received;
+   C<libbase::vector<double> > ptable_in;
+   C<int> decoded;
+   C<libbase::vector<double> > ptable_out;
+};
+
+/*!
+ * \brief   Pipelined process
+ *
+ * Decodes from given input to output stream, with reading, decoding and
+ * writing overlapped on separate threads. Frames are passed between the
+ * stages in batches, through a ring of three buffers: while the reader
+ * fills batch k+1, the decoder threads work on the frames of batch k and
+ * the writer outputs batch k-1. Each decoder thread has its own copy of the
+ * system, and decodes every n-th frame of the sequence (for n threads);
+ * results are written in the original frame order.
+ *
+ * \note Each decoder thread advances its system past the frames decoded by
+ * other threads, so that every frame is decoded by a system in the same
+ * state as for the sequential process (e.g. with the same random
+ * interleaver). The output is therefore the same for any number of threads.
+ */
+
+template <class S, template <class > class C>
+void process_pipelined(const std::string& fname, double p, bool softin,
+      bool softout, int count, const libbase::size_type<C>& blocksize,
+      bool binin, bool binout, int threads, std::istream& sin,
+      std::ostream& sout)
+   {
+   // define types
+   typedef libcomm::commsys<S, C> commsys;
+   typedef frame<S, C> frame_t;
+
+   // Communication systems, one per decoder thread
+   std::vector<commsys*> systems(threads);
+   for (int i = 0; i < threads; i++)
+      systems[i] = load_system<S, C> (fname, p);
+   // Ring of batch buffers
+   const int batchsize = 4 * threads;
+   std::vector<frame_t> batch[3];
+   int used[3] = {0, 0, 0};
+   int first[3] = {0, 0, 0};
+   for (int k = 0; k < 3; k++)
+      batch[k].resize(batchsize);
+   // Pipeline state
+   int frames_read = 0;
+   bool eos = false;
+   bool finished = false;
+
+   // Reader, writer, and decoder threads
+#pragma omp parallel num_threads(threads + 2)
+      {
+      const int tid = omp_get_thread_num();
+      // Number of frames the decoder system for this thread has passed
+      int position = 0;
+#pragma omp single
+      assertalways(omp_get_num_threads() == threads + 2);
+      for (int step = 0; !finished; step++)
+         {
+         if (tid == 0)
+            {
+            // read next batch
+            frame_t* b = &batch[step % 3][0];
+            int& n = used[step % 3];
+            first[step % 3] = frames_read;
+            for (n = 0; n < batchsize && !eos; n++)
+               {
+               if (softin)
+                  readnextblock(sin, b[n].ptable_in, blocksize, binin);
+               else
+                  readnextblock(sin, b[n].received, blocksize, binin);
+               if (binin)
+                  sin.peek();
+               else
+                  libbase::eatwhite(sin);
+               frames_read++;
+               eos = (count > 0) ? (frames_read >= count) : sin.eof();
+               }
+            }
+         else if (tid == 1)
+            {
+            // write the batch decoded in the previous step
+            frame_t* b = &batch[(step + 1) % 3][0];
+            int& n = used[(step + 1) % 3];
+            for (int i = 0; i < n; i++)
+               {
+               if (softout)
+                  write_soft(sout, b[i].ptable_out, binout);
+               else
+                  write(sout, b[i].decoded, binout);
+               }
+            sout.flush();
+            n = 0;
+            }
+         else
+            {
+            // decode the batch read in the previous step
+            commsys* system = systems[tid - 2];
+            frame_t* b = &batch[(step + 2) % 3][0];
+            const int n = used[(step + 2) % 3];
+            const int base = first[(step + 2) % 3];
+            // batches start on a multiple of the number of threads
+            for (int i = tid - 2; i < n; i += threads)
+               {
+               // skip the frames decoded by other threads
+               for (; position < base + i; position++)
+                  system->skip_receive_path();
+               position++;
+               if (softin)
+                  system->softreceive_path(b[i].ptable_in);
+               else
+                  system->receive_path(b[i].received);
+               if (softout)
+                  decode_soft(system, b[i].ptable_out);
+               else
+                  decode(system, b[i].decoded);
+               }
+            }
+#pragma omp barrier
+#pragma omp single
+            {
+            finished = (used[0] == 0 && used[1] == 0 && used[2] == 0);
+            }
+         }
+      }
+
+   // Destroy what was created on the heap
+   for (int i = 0; i < threads; i++)
+      delete systems[i];
+   }
+
+#endif
+
+/*!
+ * \brief   Batched process
+ *
+ * Decodes from given input to output stream, reading frames in batches so
+ * that the demodulator can process all frames in a batch together. Frames
+ * are decoded and written in sequence, so that the output is the same as for
+ * separate frames.
+ */
+
+template <class S, template <class > class C>
+void process_batched(libcomm::commsys<S, C>* system, bool softout, int count,
+      const libbase::size_type<C>& blocksize, bool binin, bool binout,
+      std::istream& sin, std::ostream& sout)
+   {
+   const int batchsize = 16;
+   libbase::vector<C<S> > received(batchsize);
+   // Repeat until required number of blocks read or end of stream
+   bool ready = false;
+   for (int i = 0; !ready;)
+      {
+      // read next batch of frames
+      int n;
+      for (n = 0; n < batchsize && !ready; n++)
+         {
+         readnextblock(sin, received(n), blocksize, binin);
+         if (binin)
+            sin.peek();
+         else
+            libbase::eatwhite(sin);
+         i++;
+         ready = (count > 0) ? (i >= count) : sin.eof();
+         }
+      if (n < batchsize)
+         received = received.extract(0, n);
+      // pass each frame through receiver, decode and output result
+      for (int k = 0; k < n; k++)
+         {
+         system->receive_path(received, k);
+         decode_and_write(system, softout, binout, sout);
+         }
+      }
    }
 
 /*!
@@ -258,27 +503,50 @@ void decode(std::ostream& sout, libcomm::commsys<S, C>* system)
 
 template <class S, template <class > class C>
 void process(const std::string& fname, double p, bool softin, bool softout,
-      bool knownend, int count, libbase::size_type<C>& blocksize,
-      std::istream& sin = std::cin, std::ostream& sout = std::cout)
+      bool knownend, int count, libbase::size_type<C>& blocksize, bool binin,
+      bool binout, int threads, std::istream& sin = std::cin,
+      std::ostream& sout = std::cout)
    {
    // define types
    typedef libcomm::commsys<S, C> commsys;
    typedef libcomm::commsys_stream<S, C, float> commsys_stream;
 
    // Communication system
-   commsys *system = libcomm::loadfromfile<commsys>(fname);
+   commsys *system = load_system<S, C> (fname, p);
    std::cerr << system->description() << std::endl;
-   // Set channel parameter
-   system->getrxchan()->set_parameter(p);
-   // Initialize system
-   libbase::randgen r;
-   r.seed(0);
-   system->seedfrom(r);
    // Determine block size to use if necessary
    if (!knownend && blocksize == 0)
       blocksize = system->output_block_size();
    // Check if this is a stream-oriented system
    commsys_stream* system_stream = dynamic_cast<commsys_stream*> (system);
+   // Check for compatibility
+   if (binin && (knownend || system_stream))
+      failwith("Binary input not supported for stream-oriented systems.");
+
+   // Hand over to pipelined process if requested
+   if (threads > 0)
+      {
+      if (knownend || system_stream)
+         failwith("Pipelined mode not supported for stream-oriented systems.");
+#ifdef USE_OMP
+      delete system;
+      process_pipelined<S, C> (fname, p, softin, softout, count, blocksize,
+            binin, binout, threads, sin, sout);
+      return;
+#else
+      std::cerr << "Pipelined mode needs OpenMP, decoding sequentially."
+            << std::endl;
+#endif
+      }
+
+   // Hard-input frames of fixed size are read and demodulated in batches
+   if (!softin && !knownend && !system_stream)
+      {
+      process_batched<S, C> (system, softout, count, blocksize, binin, binout,
+            sin, sout);
+      delete system;
+      return;
+      }
 
    // Repeat until required number of blocks read or end of stream
    bool ready = false;
@@ -290,26 +558,21 @@ void process(const std::string& fname, double p, bool softin, bool softout,
          if (knownend)
             receiver_soft_single(sin, system, blocksize);
          else
-            receiver_soft_multi(sin, system, blocksize);
+            receiver_soft_multi(sin, system, blocksize, binin);
          }
       else
          {
          if (knownend)
             receiver_single(sin, system, blocksize);
          else
-            {
-            if (system_stream)
-               receiver_multi_stream(sin, system_stream, blocksize);
-            else
-               receiver_multi(sin, system, blocksize);
-            }
+            receiver_multi_stream(sin, system_stream, blocksize);
          }
-      libbase::eatwhite(sin);
-      // decode and output result
-      if (softout)
-         decode_soft(sout, system);
+      if (binin)
+         sin.peek();
       else
-         decode(sout, system);
+         libbase::eatwhite(sin);
+      // decode and output result
+      decode_and_write(system, softout, binout, sout);
       // loop advance
       i++;
       ready = (count > 0) ? (i >= count) : sin.eof();
@@ -352,6 +615,12 @@ int main(int argc, char *argv[])
          "row size to read for matrix container (default: tx size)");
    desc.add_options()("col-size", po::value<int>(),
          "column size to read for matrix container (default: tx size)");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
+   desc.add_options()("threads,p", po::value<int>()->default_value(0),
+         "number of decoder threads for pipelined mode (default: sequential)");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -372,6 +641,9 @@ int main(int argc, char *argv[])
    const bool softout = vm["soft-out"].as<bool> ();
    const bool knownend = vm["known-end"].as<bool> ();
    const int count = vm["block-count"].as<int> ();
+   const bool binin = vm["binary-in"].as<bool> ();
+   const bool binout = vm["binary-out"].as<bool> ();
+   const int threads = vm["threads"].as<int> ();
    // Check for compatibility
    if (knownend && count != 1)
       failwith("Known-end only implemented for single-block input.");
@@ -392,44 +664,44 @@ int main(int argc, char *argv[])
       using libbase::erasable;
       using libcomm::sigspace;
       if (type == "erasable<bool>")
-         process<erasable<bool>, vector> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+         process<erasable<bool>, vector> (filename, parameter, softin, softout,
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "bool")
          process<bool, vector> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+               count, blocksize, binin, binout, threads);
       else if (type == "gf2")
          process<gf<1, 0x3> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf4")
          process<gf<2, 0x7> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf8")
          process<gf<3, 0xB> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf16")
          process<gf<4, 0x13> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf32")
          process<gf<5, 0x25> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf64")
          process<gf<6, 0x43> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf128")
          process<gf<7, 0x89> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf256")
          process<gf<8, 0x11D> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf512")
          process<gf<9, 0x211> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf1024")
          process<gf<10, 0x409> , vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "sigspace")
          process<sigspace, vector> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -452,40 +724,40 @@ int main(int argc, char *argv[])
       using libcomm::sigspace;
       if (type == "bool")
          process<bool, matrix> (filename, parameter, softin, softout, knownend,
-               count, blocksize);
+               count, blocksize, binin, binout, threads);
       else if (type == "gf2")
          process<gf<1, 0x3> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf4")
          process<gf<2, 0x7> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf8")
          process<gf<3, 0xB> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf16")
          process<gf<4, 0x13> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf32")
          process<gf<5, 0x25> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf64")
          process<gf<6, 0x43> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf128")
          process<gf<7, 0x89> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf256")
          process<gf<8, 0x11D> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf512")
          process<gf<9, 0x211> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "gf1024")
          process<gf<10, 0x409> , matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else if (type == "sigspace")
          process<sigspace, matrix> (filename, parameter, softin, softout,
-               knownend, count, blocksize);
+               knownend, count, blocksize, binin, binout, threads);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -21,6 +21,7 @@
 
 #include "serializer_libcomm.h"
 #include "commsys.h"
+#include "framed_stream.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
@@ -29,8 +30,8 @@
 namespace csencode {
 
 template <class S, template <class > class C>
-void process(const std::string& fname, std::istream& sin = std::cin,
-      std::ostream& sout = std::cout)
+void process(const std::string& fname, bool binin, bool binout,
+      std::istream& sin = std::cin, std::ostream& sout = std::cout)
    {
    // Communication system
    libcomm::commsys<S, C> *system = libcomm::loadfromfile<
@@ -41,24 +42,38 @@ void process(const std::string& fname, std::istream& sin = std::cin,
    r.seed(0);
    system->seedfrom(r);
    // Repeat until end of stream
-   for (int i=0; !sin.eof(); i++)
+   for (int i=0; binin || !sin.eof(); i++)
       {
-      // skip any comments
-      libbase::eatcomments(sin);
-      // attempt to read a block of the required size
-      C<int> source(system->input_block_size());
-      source.serialize(sin);
-      // stop here if something went wrong (e.g. incomplete block)
-      if (sin.fail())
+      C<int> source;
+      if (binin)
          {
-         std::cerr << "Failed to read block " << i << std::endl;
-         break;
+         // read next frame, stopping at the end of stream
+         if (!libcomm::read_frame(sin, source))
+            break;
+         assertalways(source.size() == system->input_block_size());
+         }
+      else
+         {
+         // skip any comments
+         libbase::eatcomments(sin);
+         // attempt to read a block of the required size
+         source.init(system->input_block_size());
+         source.serialize(sin);
+         // stop here if something went wrong (e.g. incomplete block)
+         if (sin.fail())
+            {
+            std::cerr << "Failed to read block " << i << std::endl;
+            break;
+            }
+         // skip any trailing whitespace (before check for EOF)
+         libbase::eatwhite(sin);
          }
       // encode block and push to output stream
       C<S> transmitted = system->encode_path(source);
-      transmitted.serialize(sout, '\n');
-      // skip any trailing whitespace (before check for EOF)
-      libbase::eatwhite(sin);
+      if (binout)
+         libcomm::write_frame(sout, transmitted);
+      else
+         transmitted.serialize(sout, '\n');
       }
    // Destroy what was created on the heap
    delete system;
@@ -84,6 +99,10 @@ int main(int argc, char *argv[])
          "modulation symbol type");
    desc.add_options()("container,c", po::value<std::string>()->default_value(
          "vector"), "input/output container type");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -98,6 +117,8 @@ int main(int argc, char *argv[])
    const std::string container = vm["container"].as<std::string> ();
    const std::string type = vm["type"].as<std::string> ();
    const std::string filename = vm["system-file"].as<std::string> ();
+   const bool binin = vm["binary-in"].as<bool> ();
+   const bool binout = vm["binary-out"].as<bool> ();
 
    // Main process
    if (container == "vector")
@@ -107,31 +128,31 @@ int main(int argc, char *argv[])
       using libbase::erasable;
       using libcomm::sigspace;
       if (type == "erasable<bool>")
-         process<erasable<bool>, vector> (filename);
+         process<erasable<bool>, vector> (filename, binin, binout);
       else if (type == "bool")
-         process<bool, vector> (filename);
+         process<bool, vector> (filename, binin, binout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , vector> (filename);
+         process<gf<1, 0x3> , vector> (filename, binin, binout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , vector> (filename);
+         process<gf<2, 0x7> , vector> (filename, binin, binout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , vector> (filename);
+         process<gf<3, 0xB> , vector> (filename, binin, binout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , vector> (filename);
+         process<gf<4, 0x13> , vector> (filename, binin, binout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , vector> (filename);
+         process<gf<5, 0x25> , vector> (filename, binin, binout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , vector> (filename);
+         process<gf<6, 0x43> , vector> (filename, binin, binout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , vector> (filename);
+         process<gf<7, 0x89> , vector> (filename, binin, binout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , vector> (filename);
+         process<gf<8, 0x11D> , vector> (filename, binin, binout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , vector> (filename);
+         process<gf<9, 0x211> , vector> (filename, binin, binout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , vector> (filename);
+         process<gf<10, 0x409> , vector> (filename, binin, binout);
       else if (type == "sigspace")
-         process<sigspace, vector> (filename);
+         process<sigspace, vector> (filename, binin, binout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -144,29 +165,29 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, matrix> (filename);
+         process<bool, matrix> (filename, binin, binout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , matrix> (filename);
+         process<gf<1, 0x3> , matrix> (filename, binin, binout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , matrix> (filename);
+         process<gf<2, 0x7> , matrix> (filename, binin, binout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , matrix> (filename);
+         process<gf<3, 0xB> , matrix> (filename, binin, binout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , matrix> (filename);
+         process<gf<4, 0x13> , matrix> (filename, binin, binout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , matrix> (filename);
+         process<gf<5, 0x25> , matrix> (filename, binin, binout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , matrix> (filename);
+         process<gf<6, 0x43> , matrix> (filename, binin, binout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , matrix> (filename);
+         process<gf<7, 0x89> , matrix> (filename, binin, binout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , matrix> (filename);
+         process<gf<8, 0x11D> , matrix> (filename, binin, binout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , matrix> (filename);
+         process<gf<9, 0x211> , matrix> (filename, binin, binout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , matrix> (filename);
+         process<gf<10, 0x409> , matrix> (filename, binin, binout);
       else if (type == "sigspace")
-         process<sigspace, matrix> (filename);
+         process<sigspace, matrix> (filename, binin, binout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
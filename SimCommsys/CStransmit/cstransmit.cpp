@@ -21,6 +21,7 @@
 
 #include "serializer_libcomm.h"
 #include "commsys.h"
+#include "framed_stream.h"
 #include "cputimer.h"
 
 #include <boost/program_options.hpp>
@@ -29,8 +30,8 @@
 namespace cstransmit {
 
 template <class S, template <class > class C>
-void process(const std::string& fname, double p, std::istream& sin = std::cin,
-      std::ostream& sout = std::cout)
+void process(const std::string& fname, double p, bool binin, bool binout,
+      std::istream& sin = std::cin, std::ostream& sout = std::cout)
    {
    // Communication system
    libcomm::commsys<S, C> *system = libcomm::loadfromfile<
@@ -43,13 +44,27 @@ void process(const std::string& fname, double p, std::istream& sin = std::cin,
    r.seed(0);
    system->seedfrom(r);
    // Repeat until end of stream
-   while (!sin.eof())
+   while (binin || !sin.eof())
       {
-      C<S> transmitted(system->output_block_size());
-      transmitted.serialize(sin);
+      C<S> transmitted;
+      if (binin)
+         {
+         // read next frame, stopping at the end of stream
+         if (!libcomm::read_frame(sin, transmitted))
+            break;
+         assertalways(transmitted.size() == system->output_block_size());
+         }
+      else
+         {
+         transmitted.init(system->output_block_size());
+         transmitted.serialize(sin);
+         libbase::eatwhite(sin);
+         }
       C<S> received = system->transmit(transmitted);
-      received.serialize(sout, '\n');
-      libbase::eatwhite(sin);
+      if (binout)
+         libcomm::write_frame(sout, received);
+      else
+         received.serialize(sout, '\n');
       }
    // Destroy what was created on the heap
    delete system;
@@ -76,6 +91,10 @@ int main(int argc, char *argv[])
    desc.add_options()("container,c", po::value<std::string>()->default_value(
          "vector"), "input/output container type");
    desc.add_options()("parameter,r", po::value<double>(), "channel parameter");
+   desc.add_options()("binary-in", po::bool_switch(),
+         "read input as binary frames");
+   desc.add_options()("binary-out", po::bool_switch(),
+         "write output as binary frames");
    po::variables_map vm;
    po::store(po::parse_command_line(argc, argv, desc), vm);
    po::notify(vm);
@@ -92,6 +111,8 @@ int main(int argc, char *argv[])
    const std::string type = vm["type"].as<std::string> ();
    const std::string filename = vm["system-file"].as<std::string> ();
    const double parameter = vm["parameter"].as<double> ();
+   const bool binin = vm["binary-in"].as<bool> ();
+   const bool binout = vm["binary-out"].as<bool> ();
 
    // Main process
    if (container == "vector")
@@ -100,29 +121,29 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, vector> (filename, parameter);
+         process<bool, vector> (filename, parameter, binin, binout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , vector> (filename, parameter);
+         process<gf<1, 0x3> , vector> (filename, parameter, binin, binout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , vector> (filename, parameter);
+         process<gf<2, 0x7> , vector> (filename, parameter, binin, binout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , vector> (filename, parameter);
+         process<gf<3, 0xB> , vector> (filename, parameter, binin, binout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , vector> (filename, parameter);
+         process<gf<4, 0x13> , vector> (filename, parameter, binin, binout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , vector> (filename, parameter);
+         process<gf<5, 0x25> , vector> (filename, parameter, binin, binout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , vector> (filename, parameter);
+         process<gf<6, 0x43> , vector> (filename, parameter, binin, binout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , vector> (filename, parameter);
+         process<gf<7, 0x89> , vector> (filename, parameter, binin, binout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , vector> (filename, parameter);
+         process<gf<8, 0x11D> , vector> (filename, parameter, binin, binout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , vector> (filename, parameter);
+         process<gf<9, 0x211> , vector> (filename, parameter, binin, binout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , vector> (filename, parameter);
+         process<gf<10, 0x409> , vector> (filename, parameter, binin, binout);
       else if (type == "sigspace")
-         process<sigspace, vector> (filename, parameter);
+         process<sigspace, vector> (filename, parameter, binin, binout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -135,29 +156,29 @@ int main(int argc, char *argv[])
       using libbase::gf;
       using libcomm::sigspace;
       if (type == "bool")
-         process<bool, matrix> (filename, parameter);
+         process<bool, matrix> (filename, parameter, binin, binout);
       else if (type == "gf2")
-         process<gf<1, 0x3> , matrix> (filename, parameter);
+         process<gf<1, 0x3> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf4")
-         process<gf<2, 0x7> , matrix> (filename, parameter);
+         process<gf<2, 0x7> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf8")
-         process<gf<3, 0xB> , matrix> (filename, parameter);
+         process<gf<3, 0xB> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf16")
-         process<gf<4, 0x13> , matrix> (filename, parameter);
+         process<gf<4, 0x13> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf32")
-         process<gf<5, 0x25> , matrix> (filename, parameter);
+         process<gf<5, 0x25> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf64")
-         process<gf<6, 0x43> , matrix> (filename, parameter);
+         process<gf<6, 0x43> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf128")
-         process<gf<7, 0x89> , matrix> (filename, parameter);
+         process<gf<7, 0x89> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf256")
-         process<gf<8, 0x11D> , matrix> (filename, parameter);
+         process<gf<8, 0x11D> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf512")
-         process<gf<9, 0x211> , matrix> (filename, parameter);
+         process<gf<9, 0x211> , matrix> (filename, parameter, binin, binout);
       else if (type == "gf1024")
-         process<gf<10, 0x409> , matrix> (filename, parameter);
+         process<gf<10, 0x409> , matrix> (filename, parameter, binin, binout);
       else if (type == "sigspace")
-         process<sigspace, matrix> (filename, parameter);
+         process<sigspace, matrix> (filename, parameter, binin, binout);
       else
          {
          std::cerr << "Unrecognized symbol type: " << type << std::endl;
@@ -156,10 +156,18 @@ int main(int argc, char *argv[])
          "- 'local', for local-computation model\n"
                "- ':port', for server-mode, bound to given port\n"
                "- 'hostname:port', for client-mode connection");
+   desc.add_options()("threads,t", po::value<int>()->default_value(1),
+         "number of threads for local-computation model "
+               "(0 for one per processor)");
+   desc.add_options()("lookahead", po::value<int>()->default_value(0),
+         "number of subsequent parameter values to simulate concurrently "
+               "(master-slave model only)");
    desc.add_options()("system-file,i", po::value<std::string>(),
          "input file containing system description");
    desc.add_options()("results-file,o", po::value<std::string>(),
          "output file to hold results");
+   desc.add_options()("full-check", po::bool_switch(),
+         "check whole results file for external changes before every write");
    desc.add_options()("start", po::value<double>(), "first parameter value");
    desc.add_options()("stop", po::value<double>(), "last parameter value");
    desc.add_options()("step", po::value<double>(),
@@ -218,7 +226,8 @@ int main(int argc, char *argv[])
          // main process
             {
             // Simulation system & parameters
-            estimator.set_resultsfile(vm["results-file"].as<std::string>());
+            estimator.set_resultsfile(vm["results-file"].as<std::string>(),
+                  !vm["full-check"].as<bool>());
             libcomm::experiment *system = createsystem(
                   vm["system-file"].as<std::string>());
             estimator.bind(system);
@@ -240,11 +249,18 @@ int main(int argc, char *argv[])
                estimator.set_min_samples(vm["min-samples"].as<int>());
             if (vm.count("seed"))
                estimator.set_seed(vm["seed"].as<libbase::int32u> ());
+            estimator.set_threads(vm["threads"].as<int>());
+            estimator.set_lookahead(vm["lookahead"].as<int>());
 
             // Work out the following for every SNR value required
             for (int i = 0; i < pset.size(); i++)
                {
                system->set_parameter(pset(i));
+               // let idle slaves start on the parameter values that follow
+               libbase::vector<double> pending(pset.size() - i - 1);
+               for (int j = 0; j < pending.size(); j++)
+                  pending(j) = pset(i + 1 + j);
+               estimator.set_pending(pending);
 
                cerr << "Simulating system at parameter = " << pset(i)
                      << std::endl;
@@ -129,6 +129,57 @@ void TestMulDiv()
       }
    }
 
+/*!
+ * \brief Reference multiplication of polynomial representations
+ *
+ * The full product is formed first, and then reduced modulo the field
+ * polynomial from the highest power down; this is independent of the table
+ * look-ups and of the shift-and-add method used in the class.
+ */
+template <int m, int poly>
+int PolyMultiply(int a, int b)
+   {
+   int result = 0;
+   for (int i = 0; i < m; i++)
+      if (b & (1 << i))
+         result ^= a << i;
+   for (int i = 2 * m - 2; i >= m; i--)
+      if (result & (1 << i))
+         result ^= poly << (i - m);
+   return result;
+   }
+
+/*!
+ * \brief Check multiplication, division and inversion for all elements
+ *
+ * Every product is compared with polynomial multiplication, every quotient
+ * with the corresponding product, and every inverse is checked by
+ * multiplying it back.
+ */
+template <int m, int poly>
+void TestArithmetic()
+   {
+   typedef gf<m, poly> GF;
+   const int q = GF::elements();
+   int errors = 0;
+   for (int a = 0; a < q; a++)
+      {
+      for (int b = 0; b < q; b++)
+         {
+         const int c = PolyMultiply<m, poly> (a, b);
+         if (int(GF(a) * GF(b)) != c)
+            errors++;
+         if (b != 0 && int(GF(c) / GF(b)) != a)
+            errors++;
+         }
+      if (a != 0 && PolyMultiply<m, poly> (a, GF(a).inverse()) != 1)
+         errors++;
+      }
+   cout << std::endl << "GF(" << m << ",0x" << hex << poly << dec
+         << ") arithmetic: " << errors << " errors" << std::endl;
+   assertalways(errors == 0);
+   }
+
 void TestGenPowerGF2()
    {
    cout << std::endl << "Binary generator matrix power sequence:" << std::endl;
@@ -1351,6 +1402,17 @@ int main(int argc, char *argv[])
    ListField<3, 0xB> ();
    ListField<4, 0x13> ();
    TestMulDiv<3, 0xB> ();
+   TestArithmetic<1, 0x3> ();
+   TestArithmetic<2, 0x7> ();
+   TestArithmetic<3, 0xB> ();
+   TestArithmetic<4, 0x13> ();
+   TestArithmetic<5, 0x25> ();
+   TestArithmetic<6, 0x43> ();
+   TestArithmetic<7, 0x89> ();
+   TestArithmetic<8, 0x11D> ();
+   TestArithmetic<9, 0x211> ();
+   TestArithmetic<10, 0x409> ();
+   TestArithmetic<8, 0x11B> ();
    TestGenPowerGF2();
    TestGenPowerGF8();
    // TODO: templatize tests for gf_fast
@@ -34,7 +34,14 @@
 
 #include <boost/program_options.hpp>
 
+#ifdef USE_OMP
+#  include <omp.h>
+#endif
+
 #include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
 
 using std::cerr;
 using std::cout;
@@ -398,6 +405,304 @@ void test_cc_code()
 
    }
 
+/*!
+ * \brief Serialized form of a regular (3,6) LDPC code of length n
+ *
+ * The parity check matrix is made of three bands of n/6 checks, as in
+ * Gallager's construction: in the first band, check i covers symbols 6i to
+ * 6i+5, while the other two bands are random column permutations of the
+ * first. The non-zero values are ones for binary codes, and are otherwise
+ * chosen at random.
+ */
+
+template <class GF>
+string make_code(const int n, const string& spa_type, const int iter)
+   {
+   const int band = n / 6;
+   const int m = 3 * band;
+   randgen r;
+   r.seed(0);
+   // positions of the non-zero entries in each column (counting from 1)
+   array1vi_t M_n(n);
+   for (int j = 0; j < n; j++)
+      M_n(j).init(3);
+   array1i_t perm(n);
+   for (int b = 0; b < 3; b++)
+      {
+      for (int j = 0; j < n; j++)
+         perm(j) = j;
+      if (b > 0)
+         for (int j = n - 1; j > 0; j--)
+            std::swap(perm(j), perm(r.ival(j + 1)));
+      for (int j = 0; j < n; j++)
+         M_n(perm(j))(b) = b * band + j / 6 + 1;
+      }
+   // weights
+   array1i_t col_weight(n);
+   col_weight = 3;
+   array1i_t row_weight(m);
+   row_weight = 6;
+   // version, SPA, iterations, clipping, almostzero, reduce to REF
+   std::ostringstream sout;
+   sout << "5\n" << spa_type << "\n" << iter << "\nzero\n1e-100\n0\n";
+   // length, dimension, max col/row weight, non-zero values
+   sout << n << "\n" << m << "\n3\n6\n";
+   if (GF::elements() == 2)
+      sout << "ones\n";
+   else
+      sout << "random\n1\n";
+   sout << col_weight << row_weight;
+   for (int j = 0; j < n; j++)
+      sout << M_n(j);
+   return sout.str();
+   }
+
+//! Set up an LDPC codec with the given SPA type
+
+template <class GF>
+void create_codec(ldpc<GF, double>& codec, const int n, const string& spa_type,
+      const int iter)
+   {
+   std::istringstream sin(make_code<GF> (n, spa_type, iter));
+   codec.serialize(sin);
+   }
+
+/*!
+ * \brief Encode a random frame and pass it through a noisy channel
+ *
+ * For binary codes, the channel is BPSK over AWGN, with 'noise' as the
+ * standard deviation; otherwise, each symbol is replaced by a different one
+ * with probability 'noise', as in a q-ary symmetric channel. The same seed
+ * is used every time, so that all codecs for the same code see the same
+ * frame.
+ */
+
+template <class GF>
+void transmit_frame(ldpc<GF, double>& codec, const double noise,
+      array1i_t& source, array1vd_t& ptable)
+   {
+   randgen r;
+   r.seed(1);
+   libcomm::codec<libbase::vector, double>& base = codec;
+   const int k = base.input_block_size();
+   const int n = base.output_block_size();
+   const int q = GF::elements();
+   source.init(k);
+   for (int i = 0; i < k; i++)
+      source(i) = r.ival(q);
+   array1i_t encoded;
+   base.encode(source, encoded);
+   ptable.init(n);
+   for (int i = 0; i < n; i++)
+      {
+      ptable(i).init(q);
+      if (q == 2)
+         {
+         const double y = (encoded(i) ? -1.0 : 1.0) + r.gval(noise);
+         for (int d = 0; d < q; d++)
+            {
+            const double e = y - (d ? -1.0 : 1.0);
+            ptable(i)(d) = exp(-e * e / (2 * noise * noise));
+            }
+         }
+      else
+         {
+         int rx = encoded(i);
+         if (r.fval_closed() < noise)
+            rx = (rx + 1 + r.ival(q - 1)) % q;
+         for (int d = 0; d < q; d++)
+            ptable(i)(d) = (d == rx) ? 1 - noise : noise / (q - 1);
+         }
+      }
+   }
+
+//! Decode a frame, using all iterations, and return the number of errors
+
+template <class GF>
+int decode_frame(ldpc<GF, double>& codec, const array1i_t& source,
+      const array1vd_t& ptable)
+   {
+   libcomm::codec<libbase::vector, double>& base = codec;
+   base.init_decoder(ptable);
+   array1i_t decoded;
+   for (int i = 0; i < base.num_iter(); i++)
+      base.decode(decoded);
+   assertalways(decoded.size() == source.size());
+   int errors = 0;
+   for (int i = 0; i < source.size(); i++)
+      if (decoded(i) != source(i))
+         errors++;
+   return errors;
+   }
+
+/*!
+ * \brief Check that a noisy codeword is decoded correctly
+ *
+ * The noise level is low enough for all SPA types to converge, so this
+ * checks the message passing itself rather than the code performance.
+ */
+
+template <class GF>
+void test_known_codeword(const int n, const string& spa_type,
+      const double noise)
+   {
+   ldpc<GF, double> codec;
+   create_codec(codec, n, spa_type, 50);
+   array1i_t source;
+   array1vd_t ptable;
+   transmit_frame(codec, noise, source, ptable);
+   const int errors = decode_frame(codec, source, ptable);
+   cout << codec.description() << ": " << errors << " symbol errors"
+         << std::endl;
+   assertalways(errors == 0);
+   }
+
+/*!
+ * \brief Check that the trad and gdl SPA types compute the same messages
+ *
+ * Both compute all the messages of a check together, from forward and
+ * backward partial results; the posteriors after each iteration must
+ * therefore agree to within rounding errors.
+ */
+
+template <class GF>
+void test_spa_agreement(const int n, const double noise, const int iter)
+   {
+   ldpc<GF, double> trad, gdl;
+   create_codec(trad, n, "trad", iter);
+   create_codec(gdl, n, "gdl", iter);
+   array1i_t source;
+   array1vd_t ptable;
+   transmit_frame(trad, noise, source, ptable);
+   libcomm::codec<libbase::vector, double>& trad_base = trad;
+   libcomm::codec<libbase::vector, double>& gdl_base = gdl;
+   trad_base.init_decoder(ptable);
+   gdl_base.init_decoder(ptable);
+   double max_diff = 0;
+   for (int i = 0; i < iter; i++)
+      {
+      array1vd_t ri_trad, ro_trad, ri_gdl, ro_gdl;
+      trad.softdecode(ri_trad, ro_trad);
+      gdl.softdecode(ri_gdl, ro_gdl);
+      assertalways(ro_trad.size() == ro_gdl.size());
+      for (int j = 0; j < ro_trad.size(); j++)
+         for (int d = 0; d < ro_trad(j).size(); d++)
+            max_diff = std::max(max_diff, fabs(ro_trad(j)(d) - ro_gdl(j)(d)));
+      }
+   cout << "trad vs gdl over GF(" << GF::elements() << "), " << iter
+         << " iterations: largest difference " << max_diff << std::endl;
+   assertalways(max_diff < 1e-9);
+   }
+
+//! Decode a frame on the given number of threads, keeping the final posteriors
+
+template <class GF>
+void decode_threads(const int n, const string& spa_type, const int iter,
+      const double noise, const int threads, array1vd_t& ro)
+   {
+#ifdef USE_OMP
+   omp_set_num_threads(threads);
+#endif
+   ldpc<GF, double> codec;
+   create_codec(codec, n, spa_type, iter);
+   array1i_t source;
+   array1vd_t ptable;
+   transmit_frame(codec, noise, source, ptable);
+   libcomm::codec<libbase::vector, double>& base = codec;
+   base.init_decoder(ptable);
+   array1vd_t ri;
+   for (int i = 0; i < iter; i++)
+      codec.softdecode(ri, ro);
+   }
+
+/*!
+ * \brief Check that decoding on several threads gives the same result
+ *
+ * With flooding, the checks and symbols of each pass are split across
+ * threads for long codes; each message depends only on the previous pass,
+ * so the posteriors must be identical to those from a single thread.
+ */
+
+template <class GF>
+void test_threads(const int n, const string& spa_type, const double noise)
+   {
+   const int iter = 10;
+   const int threads = 4;
+#ifdef USE_OMP
+   const int max_threads = omp_get_max_threads();
+#endif
+   array1vd_t ro_single, ro_multi;
+   decode_threads<GF> (n, spa_type, iter, noise, 1, ro_single);
+   decode_threads<GF> (n, spa_type, iter, noise, threads, ro_multi);
+#ifdef USE_OMP
+   omp_set_num_threads(max_threads);
+#endif
+   assertalways(ro_single.size() == ro_multi.size());
+   int mismatches = 0;
+   for (int j = 0; j < ro_single.size(); j++)
+      if (!ro_single(j).isequalto(ro_multi(j)))
+         mismatches++;
+   cout << spa_type << " over GF(" << GF::elements() << ") on " << threads
+         << " threads: " << mismatches << " mismatched symbols" << std::endl;
+   assertalways(mismatches == 0);
+   }
+
+/*!
+ * \brief Check that min-sum decodes like the sum-product algorithm at high SNR
+ *
+ * The min-sum approximation loses a little in performance, but at a noise
+ * level where sum-product decoding is reliable, both schedules of the
+ * fixed-point decoder must recover the same codeword.
+ */
+
+void test_minsum(const int n, const double noise)
+   {
+   typedef gf<1, 0x3> gf2;
+   const string types[] = { "trad", "minsum", "minsum-layered" };
+   for (int t = 0; t < 3; t++)
+      {
+      ldpc<gf2, double> codec;
+      create_codec(codec, n, types[t], 50);
+      array1i_t source;
+      array1vd_t ptable;
+      transmit_frame(codec, noise, source, ptable);
+      const int errors = decode_frame(codec, source, ptable);
+      cout << types[t] << " at sigma=" << noise << ": " << errors
+            << " symbol errors" << std::endl;
+      assertalways(errors == 0);
+      }
+   }
+
+//! Run all decoder checks
+
+void check_decoders()
+   {
+   typedef gf<1, 0x3> gf2;
+   typedef gf<2, 0x7> gf4;
+   // flooding schedule
+   test_known_codeword<gf2> (768, "trad", 0.6);
+   test_known_codeword<gf2> (768, "gdl", 0.6);
+   test_known_codeword<gf4> (384, "trad", 0.05);
+   test_known_codeword<gf4> (384, "gdl", 0.05);
+   // layered schedule
+   test_known_codeword<gf2> (768, "trad-layered", 0.6);
+   test_known_codeword<gf2> (768, "gdl-layered", 0.6);
+   test_known_codeword<gf4> (384, "trad-layered", 0.05);
+   test_known_codeword<gf4> (384, "gdl-layered", 0.05);
+   // message computation
+   test_spa_agreement<gf2> (768, 0.8, 5);
+   test_spa_agreement<gf4> (384, 0.1, 5);
+   // multi-threaded flooding
+   test_threads<gf2> (1536, "trad", 0.8);
+   test_threads<gf2> (1536, "gdl", 0.8);
+   test_threads<gf4> (1536, "trad", 0.1);
+   test_threads<gf4> (1536, "gdl", 0.1);
+   // fixed-point min-sum
+   test_minsum(768, 0.5);
+   test_minsum(1536, 0.5);
+   test_threads<gf2> (1536, "minsum", 0.8);
+   }
+
 template <class GF>
 void process(bool serialized)
    {
@@ -429,6 +734,8 @@ int main(int argc, char *argv[])
          "convert alist to serialized format");
    desc.add_options()("alist,a", po::bool_switch(),
          "convert alist to alist format");
+   desc.add_options()("check,c", po::bool_switch(),
+         "run decoder checks on generated codes");
    desc.add_options()("type,t", po::value<std::string>()->default_value("gf2"),
          "LDPC alphabet");
    po::variables_map vm;
@@ -438,14 +745,22 @@ int main(int argc, char *argv[])
    // read switch parameters
    const bool s = vm["serialized"].as<bool>();
    const bool a = vm["alist"].as<bool>();
+   const bool c = vm["check"].as<bool>();
 
    // Validate user parameters
-   if (vm.count("help") || (!s && !a) || (s && a))
+   if (vm.count("help") || (int(s) + int(a) + int(c) != 1))
       {
       cout << desc << std::endl;
       return 1;
       }
 
+   // Run decoder checks if requested
+   if (c)
+      {
+      check_decoders();
+      return 0;
+      }
+
    // Shorthand access for parameters
    const std::string type = vm["type"].as<std::string>();
 
@@ -21,18 +21,26 @@
 
 #include "modem/mpsk.h"
 #include "modem/qam.h"
+#include "modem/tvb.h"
+#include "channel/bpmr.h"
 #include "bitfield.h"
 #include "itfunc.h"
+#include "randgen.h"
 #include <iostream>
+#include <sstream>
 
 namespace testmodem {
 
 using libcomm::blockmodem;
 using libcomm::mpsk;
 using libcomm::qam;
+using libcomm::tvb;
+using libcomm::bpmr;
 
 using libbase::bitfield;
 using libbase::gray;
+using libbase::randgen;
+using libbase::vector;
 
 using std::cout;
 using std::cerr;
@@ -63,6 +71,160 @@ void TestQAM(int m)
    TestModem(mdm);
    }
 
+typedef tvb<bool, double, float> tvb_t;
+
+/*!
+ * \brief Set up a TVB modem for the given frame size
+ *
+ * The modem is created from its serialized form and seeded with a fixed
+ * value, as for each copy of the system in a simulation; separately created
+ * modems therefore go through the same sequence of encoding tables.
+ */
+
+void SetupTVB(tvb_t& mdm, const int storage, const int tau)
+   {
+   // version, thresholds, Pr, lazy flag, storage mode, lookahead, q,
+   // codebook type (random), n, marker type (zero)
+   std::ostringstream sout;
+   sout << "12\n0\n0\n1e-10\n0\n" << storage << "\n0\n4\n1\n5\n0\n";
+   std::istringstream sin(sout.str());
+   mdm.serialize(sin);
+   randgen r;
+   r.seed(0);
+   mdm.seedfrom(r);
+   mdm.set_blocksize(libbase::size_type<vector>(tau));
+   }
+
+/*!
+ * \brief Modulate and transmit a sequence of random frames
+ */
+
+void TransmitTVB(const int storage, const int tau, const int frames,
+      bpmr<float>& chan, vector<vector<bool> >& rx)
+   {
+   randgen r;
+   r.seed(1);
+   chan.set_parameter(0.05);
+   chan.seedfrom(r);
+   tvb_t mdm;
+   SetupTVB(mdm, storage, tau);
+   cout << std::endl << mdm.description() << std::endl;
+   blockmodem<bool>& base = mdm;
+   rx.init(frames);
+   for (int k = 0; k < frames; k++)
+      {
+      vector<int> source(tau);
+      for (int i = 0; i < tau; i++)
+         source(i) = r.ival(mdm.num_symbols());
+      vector<bool> tx;
+      base.modulate(mdm.num_symbols(), source, tx);
+      chan.transmit(tx, rx(k));
+      }
+   }
+
+//! Count the symbols with different likelihoods in two tables
+
+int CountMismatches(const vector<vector<double> >& a,
+      const vector<vector<double> >& b)
+   {
+   assertalways(a.size() == b.size());
+   int mismatches = 0;
+   for (int i = 0; i < a.size(); i++)
+      if (!a(i).isequalto(b(i)))
+         mismatches++;
+   return mismatches;
+   }
+
+/*!
+ * \brief Decode the same frame on several threads
+ *
+ * Each thread works on its own instance of the modem, as in a multi-threaded
+ * simulation, and decodes the frame a number of times; all results must be
+ * identical to those obtained on a single thread. The BPMR channel has a
+ * fixed state space, so this also covers the corresponding receiver.
+ */
+
+void TestTVBThreads(const int storage)
+   {
+   const int tau = 400;
+   const int threads = 4;
+   const int repeats = 20;
+   // modulate and transmit
+   bpmr<float> chan;
+   vector<vector<bool> > rx;
+   TransmitTVB(storage, tau, 1, chan, rx);
+   // decode on a single thread
+   vector<vector<double> > reference;
+      {
+      tvb_t mdm;
+      SetupTVB(mdm, storage, tau);
+      blockmodem<bool>& base = mdm;
+      base.demodulate(chan, rx(0), reference);
+      }
+   // decode on several threads
+   int mismatches = 0;
+#ifdef USE_OMP
+#pragma omp parallel for num_threads(threads) reduction(+:mismatches)
+#endif
+   for (int t = 0; t < threads; t++)
+      {
+      for (int k = 0; k < repeats; k++)
+         {
+         tvb_t mdm;
+         SetupTVB(mdm, storage, tau);
+         blockmodem<bool>& base = mdm;
+         vector<vector<double> > ptable;
+         base.demodulate(chan, rx(0), ptable);
+         mismatches += CountMismatches(ptable, reference);
+         }
+      }
+   cout << "Threads: " << mismatches << " mismatched symbols over "
+         << threads << " threads" << std::endl;
+   assertalways(mismatches == 0);
+   }
+
+/*!
+ * \brief Decode a sequence of frames in one batch
+ *
+ * The encoding table changes from frame to frame, so this also checks that
+ * the modem is advanced correctly between frames of the batch. Results must
+ * be identical to those obtained by demodulating each frame separately.
+ */
+
+void TestTVBBatch(const int storage)
+   {
+   const int tau = 50;
+   const int frames = 5;
+   // modulate and transmit
+   bpmr<float> chan;
+   vector<vector<bool> > rx;
+   TransmitTVB(storage, tau, frames, chan, rx);
+   // decode each frame separately
+   vector<vector<vector<double> > > reference(frames);
+      {
+      tvb_t mdm;
+      SetupTVB(mdm, storage, tau);
+      blockmodem<bool>& base = mdm;
+      for (int k = 0; k < frames; k++)
+         base.demodulate(chan, rx(k), reference(k));
+      }
+   // decode all frames together
+   vector<vector<vector<double> > > ptable;
+      {
+      tvb_t mdm;
+      SetupTVB(mdm, storage, tau);
+      blockmodem<bool>& base = mdm;
+      base.demodulate_batch(chan, rx, ptable);
+      }
+   assertalways(ptable.size() == frames);
+   int mismatches = 0;
+   for (int k = 0; k < frames; k++)
+      mismatches += CountMismatches(ptable(k), reference(k));
+   cout << "Batch: " << mismatches << " mismatched symbols over " << frames
+         << " frames" << std::endl;
+   assertalways(mismatches == 0);
+   }
+
 /*!
  * \brief   Test program for modem class
  * \author  Johann Briffa
@@ -75,6 +237,10 @@ int main(int argc, char *argv[])
    TestMPSK(8);
    TestQAM(4);
    TestQAM(16);
+   TestTVBThreads(0);
+   TestTVBThreads(1);
+   TestTVBBatch(0);
+   TestTVBBatch(1);
    return 0;
    }
 
@@ -461,6 +461,77 @@ void compute_timings(int tau, double p, bool ins, bool del, bool sub, double Pr)
    cout << std::endl;
    }
 
+/*!
+ * \brief Check trellis-lookup receiver against trellis computation
+ *
+ * Sets up a metric computer with the trellis-lookup receiver and the given
+ * memory limit, and compares its results with the trellis receiver for every
+ * transmitted sequence and every received sequence within the drift limits.
+ * With a limit too small for the table, this checks the fall-back path.
+ * A second computer with the same parameters must share the same table.
+ */
+
+template <class real>
+void test_lookup(int tau, double p, bool ins, bool del, bool sub, double Pr,
+      int limit)
+   {
+   typedef typename libcomm::qids<bool, real> channel_t;
+   typedef typename channel_t::metric_computer metric_computer;
+   using libcomm::qids_utils;
+   const double Pi = ins ? p : 0;
+   const double Pd = del ? p : 0;
+   const double Ps = sub ? p : 0;
+   // determine state-space parameters
+   int mtau_min, mtau_max;
+   qids_utils::compute_limits(tau, Pi, Pd, Pr, mtau_min, mtau_max);
+   int m1_min, m1_max;
+   qids_utils::compute_limits(1, Pi, Pd,
+         qids_utils::divide_error_probability(Pr, tau), m1_min, m1_max);
+   // set up metric computers
+   metric_computer computer;
+   computer.receiver_type = channel_t::receiver_trellis_lookup;
+   computer.lookup_limit = limit;
+   computer.init();
+   computer.precompute(Ps, Pd, Pi, tau, mtau_min, mtau_max, m1_min, m1_max);
+   metric_computer copy;
+   copy.receiver_type = channel_t::receiver_trellis_lookup;
+   copy.lookup_limit = limit;
+   copy.init();
+   copy.precompute(Ps, Pd, Pi, tau, mtau_min, mtau_max, m1_min, m1_max);
+   cout << "Lookup (N=" << tau << ", p=" << p << ", limit=" << limit
+         << " MiB): table " << (computer.lookup ? "used" : "not used");
+   assertalways(computer.lookup == copy.lookup);
+   // compare results for every tx sequence and every rx sequence
+   const int D = mtau_max - mtau_min + 1;
+   vector<bool> tx(tau);
+   vector<real> ptable_lookup(D);
+   vector<real> ptable_trellis(D);
+   int count = 0;
+   int mismatches = 0;
+   for (int i = 0; i < (1 << tau); i++)
+      {
+      for (int k = 0; k < tau; k++)
+         tx(k) = (i >> k) & 1;
+      for (int rho = tau + mtau_min; rho <= tau + mtau_max; rho++)
+         {
+         vector<bool> rx(rho);
+         for (int j = 0; j < (1 << rho); j++)
+            {
+            for (int k = 0; k < rho; k++)
+               rx(k) = (j >> k) & 1;
+            computer.receive(tx, rx, ptable_lookup);
+            computer.receive_trellis(tx, rx, ptable_trellis);
+            if (!ptable_lookup.isequalto(ptable_trellis))
+               mismatches++;
+            count++;
+            }
+         }
+      }
+   cout << ", " << mismatches << " mismatches in " << count << " sequences"
+         << std::endl;
+   assertalways(mismatches == 0);
+   }
+
 /*!
  * \brief   Test program for QIDS channel
  * \author  Johann Briffa
@@ -481,6 +552,9 @@ int main(int argc, char *argv[])
    desc.add_options()("precision",
          "determine equivalence for trellis and lattice corridor receivers "
                "in single and double precision");
+   desc.add_options()("lookup",
+         "determine equivalence for trellis-lookup and trellis receivers, "
+               "with and without lookup table");
    desc.add_options()("timings",
          "determine timings for lattice and trellis receiver");
    desc.add_options()("state-space", "determine state-space limits");
@@ -512,7 +586,7 @@ int main(int argc, char *argv[])
    if (vm.count("help")
          || (vm.count("default") + vm.count("visual") + vm.count("transmission")
                + vm.count("receiver") + vm.count("precision")
-               + vm.count("timings") + vm.count("state-space")
+               + vm.count("lookup") + vm.count("timings") + vm.count("state-space")
                + vm.count("drift-pdf") != 1))
       {
       cout << desc << std::endl;
@@ -535,6 +609,9 @@ int main(int argc, char *argv[])
       // test insertion-deletion channels
       test_transmission(1000, 0.01, true, true, false, 0, Pr);
       test_transmission(1000, 0.25, true, true, false, 0, Pr);
+      // test trellis-lookup receiver, with and without table
+      test_lookup<float>(5, 0.1, true, true, true, Pr, 1);
+      test_lookup<float>(5, 0.1, true, true, true, Pr, 0);
       }
    // visual test
    else if (vm.count("visual"))
@@ -596,6 +673,18 @@ int main(int argc, char *argv[])
       for (double p = pstart; p <= pstop; p *= pmul)
          test_precision<float, double>(N, p, ins, del, sub, Pr);
       }
+   // determine equivalence for trellis-lookup and trellis receivers
+   else if (vm.count("lookup"))
+      {
+      const int N = vm["blocksize"].as<int>();
+      const double p = vm["parameter"].as<double>();
+      const bool ins = vm["ins"].as<bool>();
+      const bool del = vm["del"].as<bool>();
+      const bool sub = vm["sub"].as<bool>();
+      const double Pr = vm["exclusion"].as<double>();
+      test_lookup<float>(N, p, ins, del, sub, Pr, 1);
+      test_lookup<float>(N, p, ins, del, sub, Pr, 0);
+      }
    // determine timings for lattice and trellis receiver
    else if (vm.count("timings"))
       {
@@ -0,0 +1,215 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "codec/reedsolomon.h"
+#include "codec/codec_softout.h"
+#include "gf.h"
+#include "vector.h"
+#include "randgen.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace testrs {
+
+using libcomm::reedsolomon;
+using libbase::gf;
+using libbase::vector;
+using libbase::randgen;
+
+using std::cout;
+using std::cerr;
+
+typedef vector<int> array1i_t;
+typedef vector<double> array1d_t;
+typedef vector<array1d_t> array1vd_t;
+
+/*!
+ * \brief Set up a Reed-Solomon codec from its serialized form
+ *
+ * When the BM decoder is used, symbols whose hard decision has a probability
+ * below one half are treated as erasures.
+ */
+
+template <class GF>
+void create_codec(reedsolomon<GF>& codec, const int k, const bool bm)
+   {
+   const int n = GF::elements() - 1;
+   std::ostringstream sout;
+   sout << "1" << std::endl;
+   sout << n << std::endl;
+   sout << k << std::endl;
+   if (bm)
+      sout << "1" << std::endl << "0.5" << std::endl;
+   else
+      sout << "0" << std::endl;
+   std::istringstream sin(sout.str());
+   codec.serialize(sin);
+   }
+
+/*!
+ * \brief Encode a random frame and corrupt it with errors and erasures
+ *
+ * Symbols in error are received with a confident hard decision on a wrong
+ * value; erased symbols are received with a hard decision on a wrong value,
+ * but with low confidence. All other symbols are received with a confident
+ * hard decision on the correct value.
+ */
+
+template <class GF>
+void transmit_frame(reedsolomon<GF>& codec, const int errors,
+      const int erasures, randgen& r, array1i_t& encoded, array1vd_t& ptable)
+   {
+   libcomm::codec<libbase::vector, double>& base = codec;
+   const int k = base.input_block_size();
+   const int n = base.output_block_size();
+   const int q = GF::elements();
+   // encode a random source sequence
+   array1i_t source(k);
+   for (int i = 0; i < k; i++)
+      source(i) = r.ival(q);
+   base.encode(source, encoded);
+   // choose distinct positions for errors and erasures
+   array1i_t state(n);
+   state = 0;
+   for (int e = 0; e < errors + erasures; e++)
+      {
+      int i;
+      do
+         i = r.ival(n);
+      while (state(i) != 0);
+      state(i) = (e < errors) ? 1 : 2;
+      }
+   // set up the received likelihoods
+   ptable.init(n);
+   for (int i = 0; i < n; i++)
+      {
+      ptable(i).init(q);
+      if (state(i) == 0)
+         {
+         ptable(i) = 0.1 / (q - 1);
+         ptable(i)(encoded(i)) = 0.9;
+         }
+      else
+         {
+         const int wrong = (encoded(i) + 1 + r.ival(q - 1)) % q;
+         if (state(i) == 1)
+            {
+            ptable(i) = 0.1 / (q - 1);
+            ptable(i)(wrong) = 0.9;
+            }
+         else
+            {
+            ptable(i) = 1.0 / (q + 1);
+            ptable(i)(wrong) = 2.0 / (q + 1);
+            }
+         }
+      }
+   }
+
+/*!
+ * \brief Decode a frame, returning true if the codeword was recovered
+ *
+ * The whole codeword is checked, as on a decoding failure the received
+ * likelihoods are returned, and the information symbols may still be
+ * correct if the errors all fall on parity symbols.
+ */
+
+template <class GF>
+bool decode_frame(reedsolomon<GF>& codec, const array1i_t& encoded,
+      const array1vd_t& ptable)
+   {
+   libcomm::codec_softout<libbase::vector, double>& base = codec;
+   base.init_decoder(ptable);
+   array1vd_t ri, ro;
+   base.softdecode(ri, ro);
+   for (int i = 0; i < ro.size(); i++)
+      if (ro(i).max() <= 0 || ro(i)(encoded(i)) != ro(i).max())
+         return false;
+   return true;
+   }
+
+/*!
+ * \brief Compare the PGZ and BM decoders over a range of error patterns
+ *
+ * For a code with n-k = 2t, PGZ treats erasures as errors, and must recover
+ * the frame if and only if e+f <= t; BM must recover the frame if and only if
+ * 2e+f <= 2t. Each combination of 'e' errors and 'f' erasures is tried up to
+ * one symbol beyond the correction capability of either decoder, with the
+ * same frames presented to both decoders.
+ */
+
+template <class GF>
+void test_decoders(const int k)
+   {
+   reedsolomon<GF> pgz, bm;
+   create_codec(pgz, k, false);
+   create_codec(bm, k, true);
+   const int n = GF::elements() - 1;
+   const int t = (n - k) / 2;
+   const int trials = 50;
+   cout << std::endl << bm.description() << std::endl;
+   cout << "e\tf\tPGZ\tBM" << std::endl;
+   randgen r;
+   r.seed(0);
+   int mismatches = 0;
+   for (int e = 0; e <= t + 1; e++)
+      for (int f = 0; 2 * e + f <= 2 * t + 2 && e + f <= n; f++)
+         {
+         const bool pgz_ok = (e + f <= t);
+         const bool bm_ok = (2 * e + f <= 2 * t);
+         int pgz_count = 0;
+         int bm_count = 0;
+         for (int i = 0; i < trials; i++)
+            {
+            array1i_t encoded;
+            array1vd_t ptable;
+            transmit_frame(bm, e, f, r, encoded, ptable);
+            if (decode_frame(pgz, encoded, ptable))
+               pgz_count++;
+            if (decode_frame(bm, encoded, ptable))
+               bm_count++;
+            }
+         cout << e << "\t" << f << "\t" << pgz_count << "\t" << bm_count
+               << std::endl;
+         if (pgz_count != (pgz_ok ? trials : 0))
+            mismatches++;
+         if (bm_count != (bm_ok ? trials : 0))
+            mismatches++;
+         }
+   cout << "Mismatches: " << mismatches << std::endl;
+   assertalways(mismatches == 0);
+   }
+
+int main(int argc, char *argv[])
+   {
+   test_decoders<gf<3, 0xB> > (3);
+   test_decoders<gf<4, 0x13> > (7);
+   test_decoders<gf<4, 0x13> > (11);
+   return 0;
+   }
+
+} // end namespace
+
+int main(int argc, char *argv[])
+   {
+   return testrs::main(argc, argv);
+   }
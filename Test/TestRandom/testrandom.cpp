@@ -0,0 +1,185 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "philox.h"
+#include "vector.h"
+#include <iostream>
+
+namespace testrandom {
+
+using libbase::philox;
+using libbase::vector;
+using libbase::int32u;
+using libbase::int64u;
+
+using std::cout;
+using std::cerr;
+
+/*!
+ * \brief Check a Philox-4x32-10 known-answer vector
+ *
+ * The key is set from the seed and stream number, and the counter from the
+ * substream number and block position. Since a block holds four values,
+ * the block position is reached with four skips of that many values; this
+ * covers the full 64-bit range.
+ * Vectors are from the Random123 distribution (kat_vectors).
+ */
+
+void TestKnownAnswer(const int32u ctr[4], const int32u key[2],
+      const int32u expected[4])
+   {
+   philox r;
+   r.seed(key[0]);
+   r.set_stream(key[1]);
+   r.set_substream(int64u(ctr[3]) << 32 | ctr[2]);
+   const int64u block = int64u(ctr[1]) << 32 | ctr[0];
+   for (int i = 0; i < 4; i++)
+      r.skip(block);
+   vector<int32u> x(4);
+   r.fill_ival(x);
+   cout << "Philox-4x32-10 KAT:" << std::hex;
+   for (int i = 0; i < 4; i++)
+      {
+      cout << " " << x(i);
+      assertalways(x(i) == expected[i]);
+      }
+   cout << std::dec << std::endl;
+   }
+
+void TestKnownAnswers()
+   {
+   const int32u ctr0[4] = {0, 0, 0, 0};
+   const int32u key0[2] = {0, 0};
+   const int32u out0[4] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+   TestKnownAnswer(ctr0, key0, out0);
+   const int32u ctr1[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+   const int32u key1[2] = {0xffffffff, 0xffffffff};
+   const int32u out1[4] = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+   TestKnownAnswer(ctr1, key1, out1);
+   const int32u ctr2[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+   const int32u key2[2] = {0xa4093822, 0x299f31d0};
+   const int32u out2[4] = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+   TestKnownAnswer(ctr2, key2, out2);
+   }
+
+/*!
+ * \brief Check that skipping gives the same values as discarding
+ *
+ * For each starting offset and skip length (covering partial and whole
+ * blocks), the values after the skip must be the same as those obtained by
+ * drawing and discarding the skipped values.
+ */
+
+void TestSkip()
+   {
+   int mismatches = 0;
+   for (int start = 0; start < 8; start++)
+      for (int n = 0; n < 40; n++)
+         {
+         philox a, b;
+         a.seed(1);
+         b.seed(1);
+         for (int i = 0; i < start; i++)
+            {
+            a.ival();
+            b.ival();
+            }
+         a.skip(n);
+         for (int i = 0; i < n; i++)
+            b.ival();
+         for (int i = 0; i < 8; i++)
+            if (a.ival() != b.ival())
+               mismatches++;
+         }
+   cout << "Skip: " << mismatches << " mismatches" << std::endl;
+   assertalways(mismatches == 0);
+   }
+
+/*!
+ * \brief Check that block fills give the same values as sequential draws
+ *
+ * Fills of various sizes are interleaved with single draws, so that fills
+ * start at every position within a block; the generator must also be left
+ * at the same position, which is checked by the values that follow.
+ */
+
+void TestFill()
+   {
+   const int sizes[] = {0, 1, 2, 3, 4, 5, 7, 8, 31, 32, 33, 100, 257, 1000};
+   const int count = sizeof(sizes) / sizeof(sizes[0]);
+   int mismatches = 0;
+   philox a, b;
+   a.seed(2);
+   b.seed(2);
+   for (int k = 0; k < count; k++)
+      for (int offset = 0; offset < 4; offset++)
+         {
+         const int n = sizes[k];
+         for (int i = 0; i < offset; i++)
+            if (a.ival() != b.ival())
+               mismatches++;
+         vector<int32u> xi(n);
+         a.fill_ival(xi);
+         for (int i = 0; i < n; i++)
+            if (xi(i) != b.ival())
+               mismatches++;
+         vector<double> xc(n);
+         a.fill_fval_closed(xc);
+         for (int i = 0; i < n; i++)
+            if (xc(i) != b.fval_closed())
+               mismatches++;
+         vector<double> xh(n);
+         a.fill_fval_halfopen(xh);
+         for (int i = 0; i < n; i++)
+            if (xh(i) != b.fval_halfopen())
+               mismatches++;
+         vector<double> xg(n);
+         a.fill_gval(xg, 1.5);
+         for (int i = 0; i < n; i++)
+            if (xg(i) != b.gval(1.5))
+               mismatches++;
+         }
+   // a long Gaussian fill, to go through the slow path many times
+   vector<double> xg(100000);
+   a.fill_gval(xg);
+   for (int i = 0; i < xg.size(); i++)
+      if (xg(i) != b.gval())
+         mismatches++;
+   if (a.ival() != b.ival())
+      mismatches++;
+   cout << "Fill: " << mismatches << " mismatches" << std::endl;
+   assertalways(mismatches == 0);
+   }
+
+int main(int argc, char *argv[])
+   {
+   TestKnownAnswers();
+   TestSkip();
+   TestFill();
+   return 0;
+   }
+
+} // end namespace
+
+int main(int argc, char *argv[])
+   {
+   return testrandom::main(argc, argv);
+   }
@@ -0,0 +1,192 @@
+/*!
+ * \file
+ *
+ * Copyright (c) 2010 Johann A. Briffa
+ *
+ * This file is part of SimCommSys.
+ *
+ * SimCommSys is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SimCommSys is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with SimCommSys.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resultsfile.h"
+#include "vector.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace testresultsfile {
+
+using libcomm::resultsfile;
+using libbase::vector;
+
+using std::cout;
+using std::cerr;
+using std::string;
+
+/*!
+ * \brief Results file for a simple accumulator
+ *
+ * The result is the number of samples, and the state is the sum of sample
+ * values; both are written in the same format as for montecarlo, with a
+ * bulky state to make the records large.
+ */
+
+class accumulator : public resultsfile {
+public:
+   int samples; //!< Number of samples accumulated
+   double sum; //!< Sum of sample values
+protected:
+   void writeheader(std::ostream& sout) const
+      {
+      sout << "#% Accumulator" << std::endl;
+      sout << "# Par\tSamples\tSum" << std::endl;
+      }
+   void writeresults(std::ostream& sout, vector<double>& result,
+         vector<double>& errormargin) const
+      {
+      sout << "0\t" << result(0) << '\t' << errormargin(0) << std::endl;
+      }
+   void writestate(std::ostream& sout) const
+      {
+      vector<double> state(100);
+      state = sum;
+      sout << "## Samples: " << samples << std::endl;
+      sout << "## State: " << state.size() << '\t';
+      state.serialize(sout, '\t');
+      }
+   void lookforstate(std::istream& sin)
+      {
+      sin.seekg(0);
+      while (!sin.eof())
+         {
+         string s;
+         getline(sin, s);
+         if (s.substr(0, 11) == "## Samples:")
+            std::istringstream(s.substr(11)) >> samples;
+         else if (s.substr(0, 9) == "## State:")
+            {
+            std::istringstream is(s.substr(9));
+            vector<double> state;
+            is >> state;
+            sum = state(0);
+            }
+         }
+      sin.clear();
+      }
+public:
+   accumulator() :
+      samples(0), sum(0)
+      {
+      set_interval(0);
+      }
+   //! Add a sample and write the interim (or final) result
+   void update(bool final = false)
+      {
+      samples++;
+      sum += samples;
+      vector<double> result(1), errormargin(1);
+      result = samples;
+      errormargin = sum;
+      if (final)
+         writefinalresults(result, errormargin, true);
+      else
+         writeinterimresults(result, errormargin);
+      }
+};
+
+//! Get the result lines (i.e. lines that are not comments) in the file
+
+std::vector<string> getresults(const string& fname)
+   {
+   std::ifstream file(fname.c_str());
+   std::vector<string> lines;
+   string s;
+   while (getline(file, s))
+      if (!s.empty() && s[0] != '#')
+         lines.push_back(s);
+   return lines;
+   }
+
+//! Make a result line as written by the accumulator
+
+string makeresult(const int samples)
+   {
+   std::ostringstream sout;
+   double sum = 0;
+   for (int i = 1; i <= samples; i++)
+      sum += i;
+   sout << "0\t" << samples << '\t' << sum;
+   return sout.str();
+   }
+
+/*!
+ * \brief Check that an interrupted run leaves one result and can be resumed
+ *
+ * A first run writes interim results (enough to compact the journal) and is
+ * then abandoned without a final write, as would happen on a crash; the file
+ * must have a single result line, for the last interim record. A second run
+ * must reload the last state, and continue from it to a final result.
+ */
+
+void TestInterruptResume(const bool incremental)
+   {
+   const string fname = "testresultsfile.tmp";
+   std::remove(fname.c_str());
+   cout << "Interrupt and resume (" << (incremental ? "incremental"
+         : "full check") << "): ";
+   // first run, interrupted after some interim writes
+   const int n = 25;
+   accumulator *first = new accumulator;
+   first->init(fname, incremental);
+   first->setupfile();
+   for (int i = 0; i < n; i++)
+      {
+      first->update();
+      std::vector<string> lines = getresults(fname);
+      assertalways(lines.size() == 1);
+      assertalways(lines[0] == makeresult(i + 1));
+      }
+   // the first handler is deliberately not destroyed, as on a crash
+   // second run, resuming from the saved state
+   accumulator second;
+   second.init(fname, incremental);
+   second.setupfile();
+   assertalways(second.samples == n);
+   second.update();
+   second.update(true);
+   std::vector<string> lines = getresults(fname);
+   assertalways(lines.size() == 2);
+   assertalways(lines[0] == makeresult(n));
+   assertalways(lines[1] == makeresult(n + 2));
+   cout << lines.size() << " result lines, resumed from " << n << " samples"
+         << std::endl;
+   std::remove(fname.c_str());
+   }
+
+int main(int argc, char *argv[])
+   {
+   TestInterruptResume(true);
+   TestInterruptResume(false);
+   return 0;
+   }
+
+} // end namespace
+
+int main(int argc, char *argv[])
+   {
+   return testresultsfile::main(argc, argv);
+   }